@@ -3,11 +3,20 @@
 
 : "${TEST_CORRECTNESS_SIZE:=256}"
 : "${TEST_CORRECTNESS_TOLERANCE:=1e-6}"
-: "${CORRECTNESS_KERNELS:=matmul_serial matmul_omp strassen_serial strassen_omp proposed_serial proposed_omp}"
+# Relative tolerance for the fp32 / mixed kernels (vs. fp64 on rounded operands)
+: "${TEST_F32_TOLERANCE:=1e-4}"
+: "${CORRECTNESS_KERNELS:=matmul_serial matmul_omp strassen_serial strassen_omp winograd_serial winograd_omp proposed_serial proposed_omp oblivious_serial oblivious_omp oblivious_cols proposed_serial_relu proposed_omp_clamp proposed_omp_tanh dgemm_naive_nn dgemm_proposed_tt dgemm_proposed_omp_nt dgemm_strassen_tn dgemm_winograd_omp_nt dgemm_rect_naive dgemm_rect_naive_omp dgemm_rect_proposed dgemm_rect_proposed_omp dgemm_rect_strassen dgemm_rect_strassen_omp dgemm_rect_winograd dgemm_rect_winograd_omp ctx_naive ctx_proposed ctx_strassen ctx_batch_slabs batch_ptr_cols batch_strided_rows batch_team_growth matmul_serial_f32 matmul_omp_f32 strassen_serial_f32 strassen_omp_f32 proposed_serial_f32 proposed_omp_f32 matmul_serial_mixed proposed_serial_mixed proposed_omp_mixed}"
 
 : "${TEST_PERFORMANCE_SIZES:=128,256,512,1024,2048}"
 : "${TEST_PERFORMANCE_RUNS:=5}"
-: "${PERFORMANCE_KERNELS:=matmul_serial matmul_omp strassen_serial strassen_omp proposed_serial proposed_omp}"
+: "${PERFORMANCE_KERNELS:=matmul_serial matmul_omp strassen_serial strassen_omp winograd_serial winograd_omp proposed_serial proposed_omp oblivious_serial oblivious_omp proposed_ctx proposed_serial_f32 proposed_omp_f32 proposed_serial_mixed proposed_omp_mixed}"
+
+# Batch mode of performance_test (PERFORMANCE_MODE=batch): TEST_BATCH_COUNT
+# independent multiplies of each size, reported in matrices per second; run
+# as the last pass of run_tests_openmp.sh
+: "${TEST_BATCH_SIZES:=8,16,32,64,128}"
+: "${TEST_BATCH_COUNT:=1000}"
+: "${BATCH_KERNELS:=proposed_loop proposed_batch proposed_batch_strided matmul_batch_strided}"
 
 : "${MPI_TEST_SIZE:=256}"
 : "${MPI_PERF_SIZES:=128,256,512,1024,2048}"
@@ -22,5 +31,8 @@ if [ "${ENABLE_STRESS_10K}" = "1" ]; then
 fi
 
 # MPI + Hybrid algorithm sweeps (space or comma separated)
-: "${MPI_ALGORITHMS:=naive strassen proposed}"
-: "${HYBRID_ALGORITHMS:=naive strassen proposed}"
+: "${MPI_ALGORITHMS:=naive strassen winograd proposed oblivious}"
+: "${HYBRID_ALGORITHMS:=naive strassen winograd proposed oblivious}"
+
+# MPI data distributions swept by the MPI + Hybrid suites (rows | summa | cannon | 2.5d | pipeline)
+: "${MPI_STRATEGIES:=rows summa cannon 2.5d pipeline}"
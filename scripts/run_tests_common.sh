@@ -14,10 +14,14 @@ fi
 
 export TEST_CORRECTNESS_SIZE
 export TEST_CORRECTNESS_TOLERANCE
+export TEST_F32_TOLERANCE
 export CORRECTNESS_KERNELS
 export TEST_PERFORMANCE_SIZES
 export TEST_PERFORMANCE_RUNS
 export PERFORMANCE_KERNELS
+export TEST_BATCH_SIZES
+export TEST_BATCH_COUNT
+export BATCH_KERNELS
 export MPI_TEST_SIZE
 export MPI_PERF_SIZES
 export MPI_PERF_RUNS
@@ -33,6 +37,7 @@ DEFAULT_OMP_FLAGS="-fopenmp"
 : "${MPI_ALGORITHM:=}"
 : "${HYBRID_ALGORITHM:=}"
 : "${MPI_ALGORITHMS:=}"
+: "${MPI_STRATEGIES:=}"
 : "${HYBRID_ALGORITHMS:=}"
 : "${USE_OPENBLAS:=0}"
 : "${OPENBLAS_DIR:=}"
@@ -96,6 +101,16 @@ build_serial_omp_binaries() {
         "$PROJECT_ROOT/src/blas_kernel.c" \
         "$PROJECT_ROOT/src/logging.c" \
         "$PROJECT_ROOT/src/omp_kernels.c" \
+        "$PROJECT_ROOT/src/packed_gemm.c" \
+        "$PROJECT_ROOT/src/simd_kernels.c" \
+        "$PROJECT_ROOT/src/tuning.c" \
+        "$PROJECT_ROOT/src/gemm.c" \
+        "$PROJECT_ROOT/src/packed_gemm_f32.c" \
+        "$PROJECT_ROOT/src/kernels_f32.c" \
+        "$PROJECT_ROOT/src/oblivious.c" \
+        "$PROJECT_ROOT/src/epilogue.c" \
+        "$PROJECT_ROOT/src/tile_sched.c" \
+        "$PROJECT_ROOT/src/context.c" \
         "$PROJECT_ROOT/src/utility.c" -I"$PROJECT_ROOT/src" -lm $CBLAS_LIBS
     "$CC" $CFLAGS ${OMP_FLAGS:-} $CBLAS_CFLAGS -o performance_test \
         "$PROJECT_ROOT/test/performance_test.c" \
@@ -103,6 +118,16 @@ build_serial_omp_binaries() {
         "$PROJECT_ROOT/src/blas_kernel.c" \
         "$PROJECT_ROOT/src/logging.c" \
         "$PROJECT_ROOT/src/omp_kernels.c" \
+        "$PROJECT_ROOT/src/packed_gemm.c" \
+        "$PROJECT_ROOT/src/simd_kernels.c" \
+        "$PROJECT_ROOT/src/tuning.c" \
+        "$PROJECT_ROOT/src/gemm.c" \
+        "$PROJECT_ROOT/src/packed_gemm_f32.c" \
+        "$PROJECT_ROOT/src/kernels_f32.c" \
+        "$PROJECT_ROOT/src/oblivious.c" \
+        "$PROJECT_ROOT/src/epilogue.c" \
+        "$PROJECT_ROOT/src/tile_sched.c" \
+        "$PROJECT_ROOT/src/context.c" \
         "$PROJECT_ROOT/src/utility.c" -I"$PROJECT_ROOT/src" -lm $CBLAS_LIBS
     popd >/dev/null
 }
@@ -123,16 +148,38 @@ build_mpi_binaries() {
         "$PROJECT_ROOT/src/blas_kernel.c" \
         "$PROJECT_ROOT/src/logging.c" \
         "$PROJECT_ROOT/src/omp_kernels.c" \
+        "$PROJECT_ROOT/src/packed_gemm.c" \
+        "$PROJECT_ROOT/src/simd_kernels.c" \
+        "$PROJECT_ROOT/src/tuning.c" \
+        "$PROJECT_ROOT/src/gemm.c" \
+        "$PROJECT_ROOT/src/packed_gemm_f32.c" \
+        "$PROJECT_ROOT/src/kernels_f32.c" \
+        "$PROJECT_ROOT/src/oblivious.c" \
+        "$PROJECT_ROOT/src/epilogue.c" \
+        "$PROJECT_ROOT/src/tile_sched.c" \
+        "$PROJECT_ROOT/src/context.c" \
         "$PROJECT_ROOT/src/utility.c" \
         "$PROJECT_ROOT/src/kernels.c" \
+        "$PROJECT_ROOT/src/mpi_grid.c" \
         "$PROJECT_ROOT/src/mpi_wrapper.c" -I"$PROJECT_ROOT/src" -lm $CBLAS_LIBS
     "$MPICC" -O2 ${OMP_FLAGS:-} $CBLAS_CFLAGS -o mpi_performance_test \
         "$PROJECT_ROOT/test/mpi_performance_test.c" \
         "$PROJECT_ROOT/src/blas_kernel.c" \
         "$PROJECT_ROOT/src/logging.c" \
         "$PROJECT_ROOT/src/omp_kernels.c" \
+        "$PROJECT_ROOT/src/packed_gemm.c" \
+        "$PROJECT_ROOT/src/simd_kernels.c" \
+        "$PROJECT_ROOT/src/tuning.c" \
+        "$PROJECT_ROOT/src/gemm.c" \
+        "$PROJECT_ROOT/src/packed_gemm_f32.c" \
+        "$PROJECT_ROOT/src/kernels_f32.c" \
+        "$PROJECT_ROOT/src/oblivious.c" \
+        "$PROJECT_ROOT/src/epilogue.c" \
+        "$PROJECT_ROOT/src/tile_sched.c" \
+        "$PROJECT_ROOT/src/context.c" \
         "$PROJECT_ROOT/src/utility.c" \
         "$PROJECT_ROOT/src/kernels.c" \
+        "$PROJECT_ROOT/src/mpi_grid.c" \
         "$PROJECT_ROOT/src/mpi_wrapper.c" -I"$PROJECT_ROOT/src" -lm $CBLAS_LIBS
     popd >/dev/null
 }
@@ -157,10 +204,17 @@ run_serial_omp_performance() {
     popd >/dev/null
 }
 
+run_serial_omp_batch_performance() {
+    pushd "$BUILD_DIR" >/dev/null
+    PERFORMANCE_MODE=batch ./performance_test
+    popd >/dev/null
+}
+
 run_mpi_correctness() {
     local algorithm=$1
     local mode=${2:-mpi}
     local procs=${3:-$MPI_PROCS}
+    local strategy=${4:-}
     pushd "$BUILD_DIR" >/dev/null
     local mpirun_cmd=("$MPIRUN")
     if [ -n "${MPIRUN_FLAGS:-}" ]; then
@@ -169,6 +223,9 @@ run_mpi_correctness() {
         mpirun_cmd+=("${mpirun_flags[@]}")
     fi
     mpirun_cmd+=(-np "$procs" ./mpi_correctness_test "$algorithm" "$mode")
+    if [ -n "$strategy" ]; then
+        mpirun_cmd+=("$strategy")
+    fi
     "${mpirun_cmd[@]}"
     popd >/dev/null
 }
@@ -177,6 +234,7 @@ run_mpi_performance() {
     local algorithm=$1
     local mode=$2
     local procs=${3:-$MPI_PROCS}
+    local strategy=${4:-}
     pushd "$BUILD_DIR" >/dev/null
     local mpirun_cmd=("$MPIRUN")
     if [ -n "${MPIRUN_FLAGS:-}" ]; then
@@ -185,6 +243,9 @@ run_mpi_performance() {
         mpirun_cmd+=("${mpirun_flags[@]}")
     fi
     mpirun_cmd+=(-np "$procs" ./mpi_performance_test "$algorithm" "$mode")
+    if [ -n "$strategy" ]; then
+        mpirun_cmd+=("$strategy")
+    fi
     "${mpirun_cmd[@]}"
     popd >/dev/null
 }
@@ -25,7 +25,8 @@ fi
 
 build_mpi_binaries
 
-hybrid_algorithms=$(get_algorithm_list "${HYBRID_ALGORITHMS}" "${HYBRID_ALGORITHM}" "naive strassen proposed")
+hybrid_algorithms=$(get_algorithm_list "${HYBRID_ALGORITHMS}" "${HYBRID_ALGORITHM}" "naive strassen winograd proposed oblivious")
+hybrid_strategies=$(get_algorithm_list "${MPI_STRATEGIES}" "" "rows")
 hybrid_grid_raw="${HYBRID_GRID:-}"
 if [ -z "$hybrid_grid_raw" ]; then
     default_threads="${OMP_NUM_THREADS:-1}"
@@ -44,9 +45,11 @@ for entry in $hybrid_grid; do
     fi
     echo "  + Grid ${procs} ranks × ${threads} threads"
     export OMP_NUM_THREADS="$threads"
-    for algorithm in $hybrid_algorithms; do
-        echo "    - ${algorithm}"
-        run_mpi_correctness "$algorithm" hybrid "$procs"
+    for strategy in $hybrid_strategies; do
+        for algorithm in $hybrid_algorithms; do
+            echo "    - ${algorithm} (${strategy})"
+            run_mpi_correctness "$algorithm" hybrid "$procs" "$strategy"
+        done
     done
 done
 echo "${GREEN}✓ Hybrid correctness passed (${hybrid_algorithms}) [grid: ${hybrid_grid_raw}]${NC}"
@@ -61,9 +64,11 @@ for entry in $hybrid_grid; do
     fi
     echo "  + Grid ${procs} ranks × ${threads} threads"
     export OMP_NUM_THREADS="$threads"
-    for algorithm in $hybrid_algorithms; do
-        echo "    - ${algorithm}"
-        run_mpi_performance "$algorithm" hybrid "$procs"
+    for strategy in $hybrid_strategies; do
+        for algorithm in $hybrid_algorithms; do
+            echo "    - ${algorithm} (${strategy})"
+            run_mpi_performance "$algorithm" hybrid "$procs" "$strategy"
+        done
     done
 done
 echo "${GREEN}✓ Hybrid benchmarks complete (${hybrid_algorithms}) [grid: ${hybrid_grid_raw}]${NC}"
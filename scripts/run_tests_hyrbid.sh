@@ -25,7 +25,7 @@ fi
 
 build_mpi_binaries
 
-hybrid_algorithms=$(get_algorithm_list "${HYBRID_ALGORITHMS}" "${HYBRID_ALGORITHM}" "naive strassen proposed")
+hybrid_algorithms=$(get_algorithm_list "${HYBRID_ALGORITHMS}" "${HYBRID_ALGORITHM}" "naive strassen winograd proposed oblivious")
 
 echo ""
 echo "${YELLOW}[1/2] Running hybrid correctness sweep...${NC}"
@@ -25,7 +25,8 @@ fi
 
 build_mpi_binaries
 
-mpi_algorithms=$(get_algorithm_list "${MPI_ALGORITHMS}" "${MPI_ALGORITHM}" "naive strassen proposed")
+mpi_algorithms=$(get_algorithm_list "${MPI_ALGORITHMS}" "${MPI_ALGORITHM}" "naive strassen winograd proposed oblivious")
+mpi_strategies=$(get_algorithm_list "${MPI_STRATEGIES}" "" "rows")
 mpi_proc_list=$(normalize_algorithm_list "${MPI_PROC_LIST:-}")
 if [ -z "$mpi_proc_list" ]; then
     mpi_proc_list="$MPI_PROCS"
@@ -35,23 +36,42 @@ echo ""
 echo "${YELLOW}[1/2] Running MPI correctness sweep...${NC}"
 for procs in $mpi_proc_list; do
     echo "  + MPI ranks = ${procs}"
-    for algorithm in $mpi_algorithms; do
-        echo "    - ${algorithm}"
-        run_mpi_correctness "$algorithm" mpi "$procs"
+    for strategy in $mpi_strategies; do
+        for algorithm in $mpi_algorithms; do
+            echo "    - ${algorithm} (${strategy})"
+            run_mpi_correctness "$algorithm" mpi "$procs" "$strategy"
+        done
     done
 done
-echo "${GREEN}✓ MPI correctness passed (${mpi_algorithms}) [ranks: ${mpi_proc_list}]${NC}"
+# Fused epilogue in the rows slab compute: the proposed kernels fuse it,
+# naive applies it in a separate pass over the slab
+for procs in $mpi_proc_list; do
+    echo "  + MPI ranks = ${procs}, relu epilogue"
+    for algorithm in proposed naive; do
+        echo "    - ${algorithm} (rows, MPI_TEST_EPILOGUE=relu)"
+        MPI_TEST_EPILOGUE=relu run_mpi_correctness "$algorithm" mpi "$procs" rows
+    done
+done
+# Chained multiply on distributed-resident handles: 2D grid, a round trip
+# through block rows, scatter and gather only at the ends
+for procs in $mpi_proc_list; do
+    echo "  + MPI ranks = ${procs}, distributed chain"
+    MPI_TEST_CHAIN=1 run_mpi_correctness proposed mpi "$procs"
+done
+echo "${GREEN}✓ MPI correctness passed (${mpi_algorithms}) [ranks: ${mpi_proc_list}] [strategies: ${mpi_strategies}]${NC}"
 
 echo ""
 echo "${YELLOW}[2/2] Running MPI performance sweep...${NC}"
 for procs in $mpi_proc_list; do
     echo "  + MPI ranks = ${procs}"
-    for algorithm in $mpi_algorithms; do
-        echo "    - ${algorithm}"
-        run_mpi_performance "$algorithm" mpi "$procs"
+    for strategy in $mpi_strategies; do
+        for algorithm in $mpi_algorithms; do
+            echo "    - ${algorithm} (${strategy})"
+            run_mpi_performance "$algorithm" mpi "$procs" "$strategy"
+        done
     done
 done
-echo "${GREEN}✓ MPI benchmarks complete (${mpi_algorithms}) [ranks: ${mpi_proc_list}]${NC}"
+echo "${GREEN}✓ MPI benchmarks complete (${mpi_algorithms}) [ranks: ${mpi_proc_list}] [strategies: ${mpi_strategies}]${NC}"
 
 echo ""
 echo "=============================================="
@@ -16,15 +16,20 @@ echo "=============================================="
 build_serial_omp_binaries
 
 echo ""
-echo "${YELLOW}[1/2] Running correctness tests...${NC}"
+echo "${YELLOW}[1/3] Running correctness tests...${NC}"
 run_serial_omp_correctness
 echo "${GREEN}✓ Serial/OpenMP correctness passed${NC}"
 
 echo ""
-echo "${YELLOW}[2/2] Running performance benchmarks...${NC}"
+echo "${YELLOW}[2/3] Running performance benchmarks...${NC}"
 run_serial_omp_performance
 echo "${GREEN}✓ Serial/OpenMP benchmarks complete${NC}"
 
+echo ""
+echo "${YELLOW}[3/3] Running batch throughput benchmarks...${NC}"
+run_serial_omp_batch_performance
+echo "${GREEN}✓ Batch benchmarks complete (sizes: ${TEST_BATCH_SIZES}, count: ${TEST_BATCH_COUNT})${NC}"
+
 echo ""
 echo "=============================================="
 echo "  ${GREEN}OpenMP suite finished successfully${NC}"
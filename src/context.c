@@ -0,0 +1,359 @@
+// context.c
+// Persistent execution context (see context.h): grow-only scratch plus one
+// parallel region per batch, driving the team-callable engine entry points
+// (packed_gemm_team, strassen_omp_team).
+
+#include "context.h"
+#include "kernels.h"
+#include "packed_gemm.h"
+#include "utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+struct mm_context {
+    int nthreads;            // fixed team size, or <= 0 to follow the runtime
+    double *team_ws;         // shared scratch for jobs split across the team
+    size_t team_cap;
+    double **thread_ws;      // private scratch per thread for small jobs
+    size_t *thread_cap;
+    int thread_slots;
+};
+
+mm_context *mm_context_create(int nthreads) {
+    mm_context *ctx = (mm_context *)calloc(1, sizeof(mm_context));
+    if (!ctx) {
+        fprintf(stderr, "mm_context_create: out of memory\n");
+        return NULL;
+    }
+    ctx->nthreads = nthreads;
+    return ctx;
+}
+
+void mm_context_destroy(mm_context *ctx) {
+    if (!ctx) return;
+    for (int t = 0; t < ctx->thread_slots; t++) {
+        mm_aligned_free(ctx->thread_ws[t]);
+    }
+    free(ctx->thread_ws);
+    free(ctx->thread_cap);
+    mm_aligned_free(ctx->team_ws);
+    free(ctx);
+}
+
+static int team_size(const mm_context *ctx) {
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = (ctx->nthreads > 0) ? ctx->nthreads : omp_get_max_threads();
+#endif
+    return nthreads > 0 ? nthreads : 1;
+}
+
+static int job_is_small(const mm_gemm_job *job, int count) {
+    double cube = (double)MM_CONTEXT_SMALL_DIM * MM_CONTEXT_SMALL_DIM * MM_CONTEXT_SMALL_DIM;
+    return count > 1 && (double)job->m * job->n * job->k <= cube;
+}
+
+static int job_is_valid(const mm_gemm_job *job) {
+    if (job->engine != MM_GEMM_NAIVE && job->engine != MM_GEMM_PROPOSED &&
+        job->engine != MM_GEMM_STRASSEN) {
+        return 0;
+    }
+    if (job->m < 0 || job->n < 0 || job->k < 0) return 0;
+    if (job->m == 0 || job->n == 0) return 1;
+    if (!job->C || job->ldc < job->n) return 0;
+    if (job->k == 0) return 1;
+    return job->A && job->B && job->lda >= job->k && job->ldb >= job->n;
+}
+
+// Strassen task levels for job on a team of nthreads (none for a team of one).
+static int job_task_depth(const mm_gemm_job *job, int nthreads) {
+    return strassen_omp_task_depth(job->m, job->n, job->k, nthreads);
+}
+
+// Scratch (elements) for job split across a team of nthreads.
+static size_t job_workspace(const mm_gemm_job *job, int nthreads) {
+    switch (job->engine) {
+        case MM_GEMM_PROPOSED: {
+            // The team that actually forms may be smaller than requested,
+            // so cover every size up to nthreads
+            size_t need = 0;
+            for (int t = 1; t <= nthreads; t++) {
+                size_t elems = packed_gemm_team_workspace(job->m, job->n, job->k, t);
+                if (elems > need) need = elems;
+            }
+            return need;
+        }
+        case MM_GEMM_STRASSEN:
+            return strassen_omp_team_workspace(job->m, job->n, job->k,
+                                               job_task_depth(job, nthreads), nthreads);
+        default:
+            return 0;
+    }
+}
+
+// Scratch (elements) for job run by one thread of a team (run_job_private).
+static size_t job_private_workspace(const mm_gemm_job *job) {
+    switch (job->engine) {
+        case MM_GEMM_PROPOSED:
+            return packed_gemm_small_workspace(job->m, job->n, job->k);
+        case MM_GEMM_STRASSEN:
+            return strassen_omp_team_workspace(job->m, job->n, job->k, 0, 1);
+        default:
+            return 0;
+    }
+}
+
+// Grow buf to at least need elements (contents are not preserved).
+static int reserve(double **buf, size_t *cap, size_t need) {
+    if (need <= *cap) return 0;
+    double *grown = (double *)mm_aligned_alloc(need * sizeof(double));
+    if (!grown) return -1;
+    mm_aligned_free(*buf);
+    *buf = grown;
+    *cap = need;
+    return 0;
+}
+
+static int reserve_slots(mm_context *ctx, int slots) {
+    if (slots <= ctx->thread_slots) return 0;
+    double **ws = (double **)realloc(ctx->thread_ws, (size_t)slots * sizeof(double *));
+    if (!ws) return -1;
+    ctx->thread_ws = ws;
+    size_t *cap = (size_t *)realloc(ctx->thread_cap, (size_t)slots * sizeof(size_t));
+    if (!cap) return -1;
+    ctx->thread_cap = cap;
+    for (int t = ctx->thread_slots; t < slots; t++) {
+        ctx->thread_ws[t] = NULL;
+        ctx->thread_cap[t] = 0;
+    }
+    ctx->thread_slots = slots;
+    return 0;
+}
+
+// Private scratch of at least need elements for each of nthreads threads.
+// Slots are grown even when need is 0, so private_ws never indexes past
+// them after the team grows.
+static int reserve_private(mm_context *ctx, int nthreads, size_t need) {
+    if (reserve_slots(ctx, nthreads) != 0) return -1;
+    if (need == 0) return 0;
+    for (int t = 0; t < nthreads; t++) {
+        if (reserve(&ctx->thread_ws[t], &ctx->thread_cap[t], need) != 0) return -1;
+    }
+    return 0;
+}
+
+static double *private_ws(const mm_context *ctx, int tid) {
+    return ctx->thread_ws ? ctx->thread_ws[tid] : NULL;
+}
+
+// Run job on the innermost team: every thread of it must call this.
+static void run_job_team(const mm_gemm_job *job, double *ws, int task_depth) {
+    if (job->m == 0 || job->n == 0) return;
+    switch (job->engine) {
+        case MM_GEMM_PROPOSED:
+            packed_gemm_team(job->m, job->n, job->k, job->A, job->lda, job->B, job->ldb,
+                             job->C, job->ldc, 0, ws);
+            break;
+        case MM_GEMM_STRASSEN:
+            strassen_omp_team(job->m, job->n, job->k, job->A, job->lda, job->B, job->ldb,
+                              job->C, job->ldc, task_depth, ws);
+            break;
+        default: {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < job->m; i++) {
+                matrix_mul_strided(1, job->n, job->k, job->A + (size_t)i * job->lda, job->lda,
+                                   job->B, job->ldb, job->C + (size_t)i * job->ldc, job->ldc, 0);
+            }
+            break;
+        }
+    }
+}
+
+// Run job on the calling thread alone, from inside a parallel region.
+static void run_job_private(const mm_gemm_job *job, double *ws) {
+    if (job->m == 0 || job->n == 0) return;
+    switch (job->engine) {
+        case MM_GEMM_PROPOSED:
+            packed_gemm_small(job->m, job->n, job->k, job->A, job->lda, job->B, job->ldb,
+                              job->C, job->ldc, 0, ws);
+            break;
+        case MM_GEMM_STRASSEN:
+            // strassen_omp_team shares its work with orphaned constructs,
+            // so give it a team of this thread only
+            #pragma omp parallel num_threads(1)
+            run_job_team(job, ws, 0);
+            break;
+        default:
+            matrix_mul_strided(job->m, job->n, job->k, job->A, job->lda,
+                               job->B, job->ldb, job->C, job->ldc, 0);
+            break;
+    }
+}
+
+int mm_context_run(mm_context *ctx, const mm_gemm_job *jobs, int count) {
+    if (!ctx || count < 0 || (count > 0 && !jobs)) {
+        fprintf(stderr, "mm_context_run: invalid arguments\n");
+        return -1;
+    }
+
+    int nthreads = team_size(ctx);
+    size_t team_need = 0;
+    size_t small_need = 0;
+    for (int j = 0; j < count; j++) {
+        if (!job_is_valid(&jobs[j])) {
+            fprintf(stderr, "mm_context_run: job %d is invalid\n", j);
+            return -1;
+        }
+        if (job_is_small(&jobs[j], count)) {
+            size_t need = job_private_workspace(&jobs[j]);
+            if (need > small_need) small_need = need;
+        } else {
+            size_t need = job_workspace(&jobs[j], nthreads);
+            if (need > team_need) team_need = need;
+        }
+    }
+
+    // Grow-only scratch: a batch no larger than an earlier one allocates nothing
+    if (reserve(&ctx->team_ws, &ctx->team_cap, team_need) != 0 ||
+        reserve_private(ctx, nthreads, small_need) != 0) {
+        fprintf(stderr, "mm_context_run: failed to allocate scratch\n");
+        return -1;
+    }
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        // Small jobs: one per thread, each on that thread's private scratch
+        #pragma omp for schedule(dynamic) nowait
+        for (int j = 0; j < count; j++) {
+            if (job_is_small(&jobs[j], count)) {
+                run_job_private(&jobs[j], private_ws(ctx, tid));
+            }
+        }
+
+        // Large jobs: the whole team, one after another
+        for (int j = 0; j < count; j++) {
+            if (!job_is_small(&jobs[j], count)) {
+                run_job_team(&jobs[j], ctx->team_ws, job_task_depth(&jobs[j], nthreads));
+            }
+        }
+    }
+    return 0;
+}
+
+int mm_context_gemm(mm_context *ctx, mm_gemm_engine engine,
+                    const double *A, const double *B, double *C, int n) {
+    mm_gemm_job job = {engine, n, n, n, A, n, B, n, C, n};
+    return mm_context_run(ctx, &job, 1);
+}
+
+// ========== Batched GEMM ==========
+
+// count multiplies of one shape; operand j comes from the pointer arrays, or
+// from the bases in shape plus j strides when the arrays are NULL.
+typedef struct {
+    mm_gemm_job shape;
+    const double *const *A_array;
+    const double *const *B_array;
+    double *const *C_array;
+    size_t stride_a, stride_b, stride_c;
+} gemm_batch;
+
+static void batch_job(const gemm_batch *batch, int j, mm_gemm_job *job) {
+    *job = batch->shape;
+    if (batch->C_array) {
+        job->A = batch->A_array[j];
+        job->B = batch->B_array[j];
+        job->C = batch->C_array[j];
+    } else {
+        // k == 0 leaves A/B NULL; never offset a null base
+        if (job->A) job->A += (size_t)j * batch->stride_a;
+        if (job->B) job->B += (size_t)j * batch->stride_b;
+        job->C += (size_t)j * batch->stride_c;
+    }
+}
+
+static int run_batch(mm_context *ctx, const gemm_batch *batch, int count, const char *who) {
+    mm_gemm_job job;
+    for (int j = 0; j < count; j++) {
+        batch_job(batch, j, &job);
+        if (!job_is_valid(&job)) {
+            fprintf(stderr, "%s: matrix %d is invalid\n", who, j);
+            return -1;
+        }
+    }
+    const mm_gemm_job *shape = &batch->shape;
+    if (count == 0 || shape->m == 0 || shape->n == 0) return 0;
+
+    // Large matrices gain nothing from batching: split each across the team
+    if (!job_is_small(shape, count)) {
+        for (int j = 0; j < count; j++) {
+            batch_job(batch, j, &job);
+            if (mm_context_run(ctx, &job, 1) != 0) return -1;
+        }
+        return 0;
+    }
+
+    int nthreads = team_size(ctx);
+    if (reserve_private(ctx, nthreads, job_private_workspace(shape)) != 0) {
+        fprintf(stderr, "%s: failed to allocate scratch\n", who);
+        return -1;
+    }
+
+    // A few chunks per thread: enough for dynamic balancing, few enough
+    // that the shared loop counter is not touched per matrix
+    int chunk = count / (8 * nthreads);
+    if (chunk < 1) chunk = 1;
+
+    #pragma omp parallel num_threads(nthreads)
+    {
+        int tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        double *ws = private_ws(ctx, tid);
+        #pragma omp for schedule(dynamic, chunk)
+        for (int j = 0; j < count; j++) {
+            mm_gemm_job item;
+            batch_job(batch, j, &item);
+            run_job_private(&item, ws);
+        }
+    }
+    return 0;
+}
+
+int mm_context_gemm_batch(mm_context *ctx, mm_gemm_engine engine, int m, int n, int k,
+                          const double *const *A, int lda,
+                          const double *const *B, int ldb,
+                          double *const *C, int ldc, int count) {
+    if (!ctx || count < 0 || (count > 0 && (!A || !B || !C))) {
+        fprintf(stderr, "mm_context_gemm_batch: invalid arguments\n");
+        return -1;
+    }
+    gemm_batch batch = {{engine, m, n, k, NULL, lda, NULL, ldb, NULL, ldc},
+                        A, B, C, 0, 0, 0};
+    return run_batch(ctx, &batch, count, "mm_context_gemm_batch");
+}
+
+int mm_context_gemm_batch_strided(mm_context *ctx, mm_gemm_engine engine, int m, int n, int k,
+                                  const double *A, int lda, size_t stride_a,
+                                  const double *B, int ldb, size_t stride_b,
+                                  double *C, int ldc, size_t stride_c, int count) {
+    // Outputs written concurrently must not overlap
+    int overlap = count > 1 && m > 0 && n > 0 &&
+                  stride_c < (size_t)(m - 1) * ldc + (size_t)n;
+    if (!ctx || count < 0 || overlap) {
+        fprintf(stderr, "mm_context_gemm_batch_strided: invalid arguments\n");
+        return -1;
+    }
+    gemm_batch batch = {{engine, m, n, k, A, lda, B, ldb, C, ldc},
+                        NULL, NULL, NULL, stride_a, stride_b, stride_c};
+    return run_batch(ctx, &batch, count, "mm_context_gemm_batch_strided");
+}
@@ -0,0 +1,96 @@
+// context.h
+// Persistent execution context for many back-to-back multiplies: scratch
+// buffers survive across calls and a whole batch of jobs runs inside one
+// OpenMP parallel region, so neither fork/join nor the allocator is paid
+// per multiply.
+
+#ifndef CONTEXT_H
+#define CONTEXT_H
+
+#include "gemm.h"
+#include <stddef.h>
+
+// Jobs whose m * n * k is at most this cube run one per thread when a batch
+// has several jobs; larger ones are split across the whole team.
+#define MM_CONTEXT_SMALL_DIM 512
+
+typedef struct mm_context mm_context;
+
+// One C = A * B multiply: C is m x n, A is m x k, B is k x n (row-major
+// views with leading dimensions). engine is MM_GEMM_NAIVE, MM_GEMM_PROPOSED
+// or MM_GEMM_STRASSEN.
+typedef struct {
+    mm_gemm_engine engine;
+    int m, n, k;
+    const double *A;
+    int lda;
+    const double *B;
+    int ldb;
+    double *C;
+    int ldc;
+} mm_gemm_job;
+
+// mm_context_create
+// Input: nthreads (> 0 fixes the team size; <= 0 follows
+//   omp_get_max_threads() at every call).
+// Output: a context with no scratch yet, or NULL on allocation failure.
+mm_context *mm_context_create(int nthreads);
+
+// mm_context_destroy
+// Behavior: frees the context and its scratch (NULL is ignored).
+void mm_context_destroy(mm_context *ctx);
+
+// mm_context_run
+// Input: count jobs. They must not write to each other's inputs or outputs.
+// Behavior:
+//   Grows the scratch if this batch needs more than any earlier one, then
+//   opens a single parallel region for the whole batch. When the batch has
+//   several jobs, jobs up to MM_CONTEXT_SMALL_DIM^3 are handed out one per
+//   thread (each with private scratch; the packed engine runs as
+//   packed_gemm_small). Larger jobs, and a lone job, are split across the
+//   whole team in order. After the first batch of a given shape nothing is
+//   allocated.
+// Returns 0 on success, -1 for an invalid job or scratch allocation failure
+//   (reported on stderr; no job of the batch has run).
+// Not thread-safe: one batch per context at a time.
+int mm_context_run(mm_context *ctx, const mm_gemm_job *jobs, int count);
+
+// mm_context_gemm
+// Behavior: mm_context_run on a single n x n job (square contiguous
+//   operands), the drop-in form of matmul_omp / strassen_omp / proposed_omp.
+int mm_context_gemm(mm_context *ctx, mm_gemm_engine engine,
+                    const double *A, const double *B, double *C, int n);
+
+// mm_context_gemm_batch
+// Input:
+//   engine, m, n, k, lda, ldb, ldc: shape shared by every multiply, as in
+//     mm_gemm_job.
+//   A, B, C: count pointers each; multiply j computes C[j] = A[j] * B[j].
+//     Inputs may be shared between multiplies, outputs may not overlap.
+// Behavior:
+//   Batched GEMM for many small independent multiplies. When the shape is
+//   at most MM_CONTEXT_SMALL_DIM^3 and count > 1, one parallel region runs
+//   the whole batch, each multiply on a single thread with its private
+//   scratch: the packed engine without packing threads or scheduler
+//   (packed_gemm_small), the naive loop, or serial Strassen. Threads take
+//   chunks of the batch dynamically. Larger shapes run one after another,
+//   each split across the team as in mm_context_run.
+// Returns 0 on success, -1 for an invalid argument or scratch allocation
+//   failure (reported on stderr; no multiply has run).
+int mm_context_gemm_batch(mm_context *ctx, mm_gemm_engine engine, int m, int n, int k,
+                          const double *const *A, int lda,
+                          const double *const *B, int ldb,
+                          double *const *C, int ldc, int count);
+
+// mm_context_gemm_batch_strided
+// Input: as mm_context_gemm_batch, but operand j starts stride_a / stride_b /
+//   stride_c elements after operand j - 1 of one array. A stride of 0
+//   shares that input across the batch (e.g. one weight matrix B); C
+//   strides must keep the outputs disjoint.
+// Behavior / returns: as mm_context_gemm_batch.
+int mm_context_gemm_batch_strided(mm_context *ctx, mm_gemm_engine engine, int m, int n, int k,
+                                  const double *A, int lda, size_t stride_a,
+                                  const double *B, int ldb, size_t stride_b,
+                                  double *C, int ldc, size_t stride_c, int count);
+
+#endif // CONTEXT_H
@@ -0,0 +1,104 @@
+// epilogue.c
+// GEMM epilogues (see epilogue.h).
+
+#include "epilogue.h"
+#include <math.h>
+#include <stddef.h>
+#include <string.h>
+
+static const char *const op_names[] = {"none", "relu", "clamp", "sigmoid", "tanh"};
+
+int mm_epilogue_has_post(const mm_epilogue *ep) {
+    return ep && (ep->row_bias || ep->col_bias || ep->op != MM_EPILOGUE_NONE);
+}
+
+// x = op(x + row_bias + col_bias[j]) over one row; the op is chosen once
+// per row so each inner loop stays a simple vectorizable sweep.
+static void post_row(const mm_epilogue *ep, int cols, double row_bias,
+                     const double *col_bias, double *x) {
+    if (col_bias) {
+        for (int j = 0; j < cols; j++) {
+            x[j] += row_bias + col_bias[j];
+        }
+    } else if (row_bias != 0.0) {
+        for (int j = 0; j < cols; j++) {
+            x[j] += row_bias;
+        }
+    }
+
+    switch (ep->op) {
+        case MM_EPILOGUE_RELU:
+            for (int j = 0; j < cols; j++) {
+                x[j] = (x[j] > 0.0) ? x[j] : 0.0;
+            }
+            break;
+        case MM_EPILOGUE_CLAMP:
+            for (int j = 0; j < cols; j++) {
+                double v = (x[j] < ep->lo) ? ep->lo : x[j];
+                x[j] = (v > ep->hi) ? ep->hi : v;
+            }
+            break;
+        case MM_EPILOGUE_SIGMOID:
+            for (int j = 0; j < cols; j++) {
+                x[j] = 1.0 / (1.0 + exp(-x[j]));
+            }
+            break;
+        case MM_EPILOGUE_TANH:
+            for (int j = 0; j < cols; j++) {
+                x[j] = tanh(x[j]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void mm_epilogue_post(const mm_epilogue *ep, int rows, int cols, int row0, int col0,
+                      double *C, int ldc) {
+    if (!mm_epilogue_has_post(ep)) return;
+    const double *col_bias = ep->col_bias ? ep->col_bias + col0 : NULL;
+    for (int i = 0; i < rows; i++) {
+        double row_bias = ep->row_bias ? ep->row_bias[row0 + i] : 0.0;
+        post_row(ep, cols, row_bias, col_bias, &C[(size_t)i * ldc]);
+    }
+}
+
+void mm_epilogue_apply(const mm_epilogue *ep, int rows, int cols, int row0, int col0,
+                       const double *P, int ldp, double *C, int ldc) {
+    double alpha = ep ? ep->alpha : 1.0;
+    double beta = ep ? ep->beta : 0.0;
+    for (int i = 0; i < rows; i++) {
+        const double *p_row = &P[(size_t)i * ldp];
+        double *c_row = &C[(size_t)i * ldc];
+        if (beta == 0.0) {
+            if (p_row != c_row || alpha != 1.0) {
+                for (int j = 0; j < cols; j++) {
+                    c_row[j] = alpha * p_row[j];
+                }
+            }
+        } else {
+            for (int j = 0; j < cols; j++) {
+                c_row[j] = alpha * p_row[j] + beta * c_row[j];
+            }
+        }
+        if (mm_epilogue_has_post(ep)) {
+            double row_bias = ep->row_bias ? ep->row_bias[row0 + i] : 0.0;
+            post_row(ep, cols, row_bias, ep->col_bias ? ep->col_bias + col0 : NULL, c_row);
+        }
+    }
+}
+
+int mm_epilogue_op_parse(const char *name) {
+    if (!name) return -1;
+    for (int op = 0; op < (int)(sizeof(op_names) / sizeof(op_names[0])); op++) {
+        if (strcmp(name, op_names[op]) == 0) return op;
+    }
+    return -1;
+}
+
+const char *mm_epilogue_op_name(mm_epilogue_op op) {
+    if ((int)op < 0 || (int)op >= (int)(sizeof(op_names) / sizeof(op_names[0]))) {
+        return "unknown";
+    }
+    return op_names[op];
+}
@@ -0,0 +1,61 @@
+// epilogue.h
+// GEMM epilogues: scaling, bias and an elementwise op applied to C by the
+// multiply itself instead of in a separate pass over memory.
+
+#ifndef EPILOGUE_H
+#define EPILOGUE_H
+
+typedef enum {
+    MM_EPILOGUE_NONE = 0,
+    MM_EPILOGUE_RELU,     // max(x, 0)
+    MM_EPILOGUE_CLAMP,    // min(max(x, lo), hi)
+    MM_EPILOGUE_SIGMOID,  // 1 / (1 + exp(-x))
+    MM_EPILOGUE_TANH
+} mm_epilogue_op;
+
+// C = op(alpha * A * B + beta * C + row_bias[i] + col_bias[j]).
+// beta == 0 overwrites C without reading it. Bias vectors are indexed by
+// the row / column of the whole C, so a caller working on a sub-block (an
+// MPI row slab) passes the offset of that block.
+typedef struct {
+    double alpha;
+    double beta;
+    const double *row_bias;  // m entries, or NULL
+    const double *col_bias;  // n entries, or NULL
+    mm_epilogue_op op;
+    double lo, hi;           // MM_EPILOGUE_CLAMP bounds
+} mm_epilogue;
+
+// Plain product: alpha = 1, beta = 0, no bias, no op.
+#define MM_EPILOGUE_INIT {1.0, 0.0, NULL, NULL, MM_EPILOGUE_NONE, 0.0, 0.0}
+
+// mm_epilogue_has_post
+// Output: non-zero when ep (may be NULL) adds a bias or applies an op, i.e.
+//   when something remains to do after alpha / beta.
+int mm_epilogue_has_post(const mm_epilogue *ep);
+
+// mm_epilogue_post
+// Input: a rows x cols block of C (leading dimension ldc) whose top-left
+//   element is (row0, col0) of the whole C.
+// Behavior: C = op(C + row_bias + col_bias) on the block, i.e. the part of
+//   the epilogue after alpha / beta. Called by the packed engine on each
+//   register tile right after its last k block, while it is still in L1.
+void mm_epilogue_post(const mm_epilogue *ep, int rows, int cols, int row0, int col0,
+                      double *C, int ldc);
+
+// mm_epilogue_apply
+// Input: P, a rows x cols product A * B (leading dimension ldp), and the
+//   matching block of C at (row0, col0). P may be C itself when beta == 0.
+// Behavior: the whole epilogue in one pass over the block, C = op(alpha * P
+//   + beta * C + bias), for engines that cannot fuse it (ep may be NULL:
+//   C = P).
+void mm_epilogue_apply(const mm_epilogue *ep, int rows, int cols, int row0, int col0,
+                       const double *P, int ldp, double *C, int ldc);
+
+// mm_epilogue_op_parse / mm_epilogue_op_name
+// Behavior: map "none", "relu", "clamp", "sigmoid", "tanh" to the op and
+//   back. parse returns -1 for an unknown name.
+int mm_epilogue_op_parse(const char *name);
+const char *mm_epilogue_op_name(mm_epilogue_op op);
+
+#endif // EPILOGUE_H
@@ -0,0 +1,182 @@
+// gemm.c
+// BLAS-style dgemm entry point dispatching to the naive, packed-panel
+// (proposed) and Strassen-type engines.
+
+#include "gemm.h"
+#include "kernels.h"
+#include "packed_gemm.h"
+#include "utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef void (*rect_kernel_t)(int m, int n, int k,
+                              const double *A, int lda, const double *B, int ldb,
+                              double *C, int ldc);
+
+static int parse_trans(char t) {
+    switch (t) {
+        case 'N': case 'n':
+            return 0;
+        case 'T': case 't':
+        case 'C': case 'c':
+            return 1;
+        default:
+            return -1;
+    }
+}
+
+// C = beta * C (beta == 0 clears C without reading it).
+static void scale_c(int m, int n, double beta, double *C, int ldc, int use_omp) {
+    #pragma omp parallel for schedule(static) if(use_omp)
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            C[(size_t)i * ldc + j] = (beta == 0.0) ? 0.0 : beta * C[(size_t)i * ldc + j];
+        }
+    }
+}
+
+static void gemm_naive(int trans_a, int trans_b, int m, int n, int k,
+                       double alpha, const double *A, int lda,
+                       const double *B, int ldb,
+                       double beta, double *C, int ldc, int use_omp) {
+    #pragma omp parallel for schedule(static) if(use_omp)
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (int p = 0; p < k; p++) {
+                double a = trans_a ? A[(size_t)p * lda + i] : A[(size_t)i * lda + p];
+                double b = trans_b ? B[(size_t)j * ldb + p] : B[(size_t)p * ldb + j];
+                sum += a * b;
+            }
+            double c = (beta == 0.0) ? 0.0 : beta * C[(size_t)i * ldc + j];
+            C[(size_t)i * ldc + j] = alpha * sum + c;
+        }
+    }
+}
+
+#define TRANSPOSE_TILE 32
+
+// rows x cols transpose of src (leading dimension lds) into a contiguous dst,
+// in TRANSPOSE_TILE square tiles so both sides stay in cache; the tile rows
+// of dst are split across threads when use_omp is set.
+static void transpose_copy(int rows, int cols, const double *src, int lds, double *dst,
+                           int use_omp) {
+    #pragma omp parallel for schedule(static) if(use_omp)
+    for (int jj = 0; jj < cols; jj += TRANSPOSE_TILE) {
+        int j_end = (jj + TRANSPOSE_TILE < cols) ? jj + TRANSPOSE_TILE : cols;
+        for (int ii = 0; ii < rows; ii += TRANSPOSE_TILE) {
+            int i_end = (ii + TRANSPOSE_TILE < rows) ? ii + TRANSPOSE_TILE : rows;
+            for (int j = jj; j < j_end; j++) {
+                for (int i = ii; i < i_end; i++) {
+                    dst[(size_t)j * rows + i] = src[(size_t)i * lds + j];
+                }
+            }
+        }
+    }
+}
+
+// Strassen-type engines work on non-transposed strided views with overwrite
+// semantics; transposed operands and general alpha/beta need scratch.
+static int gemm_recursive(rect_kernel_t kernel, int trans_a, int trans_b,
+                          int m, int n, int k, double alpha,
+                          const double *A, int lda, const double *B, int ldb,
+                          double beta, double *C, int ldc, int use_omp) {
+    int direct = (alpha == 1.0 && beta == 0.0);
+    double *At = trans_a ? (double *)mm_aligned_alloc((size_t)m * k * sizeof(double)) : NULL;
+    double *Bt = trans_b ? (double *)mm_aligned_alloc((size_t)k * n * sizeof(double)) : NULL;
+    double *T = direct ? NULL : (double *)mm_aligned_alloc((size_t)m * n * sizeof(double));
+    if ((trans_a && !At) || (trans_b && !Bt) || (!direct && !T)) {
+        mm_aligned_free(At);
+        mm_aligned_free(Bt);
+        mm_aligned_free(T);
+        return -1;
+    }
+
+    if (trans_a) {
+        transpose_copy(k, m, A, lda, At, use_omp);
+        A = At;
+        lda = k;
+    }
+    if (trans_b) {
+        transpose_copy(n, k, B, ldb, Bt, use_omp);
+        B = Bt;
+        ldb = n;
+    }
+
+    if (direct) {
+        kernel(m, n, k, A, lda, B, ldb, C, ldc);
+    } else {
+        kernel(m, n, k, A, lda, B, ldb, T, n);
+        #pragma omp parallel for schedule(static) if(use_omp)
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < n; j++) {
+                double c = (beta == 0.0) ? 0.0 : beta * C[(size_t)i * ldc + j];
+                C[(size_t)i * ldc + j] = alpha * T[(size_t)i * n + j] + c;
+            }
+        }
+    }
+
+    mm_aligned_free(At);
+    mm_aligned_free(Bt);
+    mm_aligned_free(T);
+    return 0;
+}
+
+int mm_dgemm(mm_gemm_engine engine, int use_omp,
+             char transa, char transb, int m, int n, int k,
+             double alpha, const double *A, int lda,
+             const double *B, int ldb,
+             double beta, double *C, int ldc) {
+    int trans_a = parse_trans(transa);
+    int trans_b = parse_trans(transb);
+
+    // Argument checks in BLAS order; report the first offending parameter
+    int bad = 0;
+    if (trans_a < 0) bad = 3;
+    else if (trans_b < 0) bad = 4;
+    else if (m < 0) bad = 5;
+    else if (n < 0) bad = 6;
+    else if (k < 0) bad = 7;
+    else if (lda < ((trans_a ? m : k) > 1 ? (trans_a ? m : k) : 1)) bad = 10;
+    else if (ldb < ((trans_b ? k : n) > 1 ? (trans_b ? k : n) : 1)) bad = 12;
+    else if (ldc < (n > 1 ? n : 1)) bad = 15;
+    if (bad) {
+        fprintf(stderr, "mm_dgemm: parameter %d had an illegal value\n", bad);
+        return -1;
+    }
+
+    // Quick returns
+    if (m == 0 || n == 0) return 0;
+    if (k == 0 || alpha == 0.0) {
+        if (beta != 1.0) scale_c(m, n, beta, C, ldc, use_omp);
+        return 0;
+    }
+
+    rect_kernel_t rect = NULL;
+    switch (engine) {
+        case MM_GEMM_PROPOSED:
+            packed_gemm_ex(trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb,
+                           beta, C, ldc, use_omp);
+            return 0;
+        case MM_GEMM_STRASSEN:
+            rect = use_omp ? strassen_omp_rect : strassen_serial_rect;
+            break;
+        case MM_GEMM_WINOGRAD:
+            rect = use_omp ? winograd_omp_rect : winograd_serial_rect;
+            break;
+        case MM_GEMM_NAIVE:
+        default:
+            break;
+    }
+
+    if (rect && gemm_recursive(rect, trans_a, trans_b, m, n, k, alpha,
+                               A, lda, B, ldb, beta, C, ldc, use_omp) == 0) {
+        return 0;
+    }
+    if (rect) {
+        fprintf(stderr, "mm_dgemm: failed to allocate scratch, using naive multiply\n");
+    }
+
+    gemm_naive(trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc, use_omp);
+    return 0;
+}
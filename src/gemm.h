@@ -0,0 +1,38 @@
+// gemm.h
+// BLAS-style general matrix multiply on top of the project's engines:
+// C = alpha * op(A) * op(B) + beta * C for rectangular, row-major
+// sub-blocks addressed through leading dimensions.
+
+#ifndef GEMM_H
+#define GEMM_H
+
+typedef enum {
+    MM_GEMM_NAIVE = 0,   // triple loop (reference)
+    MM_GEMM_PROPOSED,    // packed-panel engine (packed_gemm.h)
+    MM_GEMM_STRASSEN,    // Strassen with dynamic peeling
+    MM_GEMM_WINOGRAD     // Strassen-Winograd with dynamic peeling
+} mm_gemm_engine;
+
+// mm_dgemm
+// Input:
+//   engine:        which implementation performs the multiply.
+//   use_omp:       non-zero selects the OpenMP variant of the engine.
+//   transa/transb: 'N' for op(X) = X, 'T' (or 'C') for op(X) = X^T.
+//   m, n, k:       op(A) is m x k, op(B) is k x n, C is m x n.
+//   A, lda:        row-major A; lda >= k ('N') or lda >= m ('T').
+//   B, ldb:        row-major B; ldb >= n ('N') or ldb >= k ('T').
+//   C, ldc:        row-major C; ldc >= n.
+// Behavior:
+//   Computes C = alpha * op(A) * op(B) + beta * C in place on the sub-block.
+//   beta == 0 overwrites C without reading it (BLAS semantics). The proposed
+//   engine absorbs transposes and alpha/beta into its packing; Strassen and
+//   Winograd recurse on strided views and only materialize a transposed
+//   operand, or an m x n product when alpha != 1 or beta != 0.
+// Returns 0 on success, -1 for an illegal argument (reported on stderr).
+int mm_dgemm(mm_gemm_engine engine, int use_omp,
+             char transa, char transb, int m, int n, int k,
+             double alpha, const double *A, int lda,
+             const double *B, int ldb,
+             double beta, double *C, int ldc);
+
+#endif // GEMM_H
@@ -3,8 +3,13 @@
 // Member 2 responsible
 
 #include "kernels.h"
+#include "oblivious.h"
+#include "packed_gemm.h"
+#include "tuning.h"
 #include "utility.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // ========== NAIVE MATRIX MULTIPLICATION (SERIAL) ==========
 void matmul_serial(double *A, double *B, double *C, int n) {
@@ -22,219 +27,246 @@ void matmul_serial(double *A, double *B, double *C, int n) {
 }
 
 // ========== STRASSEN ALGORITHM (SERIAL) ==========
-// Threshold for falling back to naive multiplication
-#define STRASSEN_THRESHOLD 64
-
-// Helper: Recursively pad n to next power of 2
-static int next_power_of_2(int n) {
-    int p = 1;
-    while (p < n) p *= 2;
-    return p;
+// Below this size (tuning profile key strassen_threshold) the recursion
+// bottoms out in the packed SIMD engine, run serially on the strided
+// quadrant views (packed_gemm_small). Winograd shares the cutoff.
+static int is_strassen_base(int m, int n, int k) {
+    int cutoff = mm_tuning()->strassen_threshold;
+    return m <= cutoff || n <= cutoff || k <= cutoff;
 }
 
-// Helper: Copy submatrix from src to dst
-static void copy_submatrix(double *src, double *dst, int n, 
-                           int rowSrc, int colSrc, int strideSrc,
-                           int rowDst, int colDst, int strideDst) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            dst[(rowDst + i) * strideDst + (colDst + j)] = 
-                src[(rowSrc + i) * strideSrc + (colSrc + j)];
-        }
+// Odd dimensions are handled by dynamic peeling rather than padding: each
+// level recurses on the even (m & ~1) x (n & ~1) x (k & ~1) part and
+// matrix_peel_fixup folds in the odd row, column and inner term. No padded
+// copies are made, and a 1025 problem costs about what a 1024 one does.
+
+// Workspace (in elements) that strassen_recursive needs for an m x n x k
+// problem. Each level carves three temporaries (an A-side operand sum, a
+// B-side operand sum and one product) from its slice and passes the remainder
+// to its children; the seven children run one after another, so they all
+// reuse that remainder. The base case packs into what is left at the bottom.
+static size_t strassen_workspace_elems(int m, int n, int k) {
+    size_t total = 0;
+    while (!is_strassen_base(m, n, k)) {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        total += (size_t)m * k + (size_t)k * n + (size_t)m * n;
     }
+    return total + packed_gemm_small_workspace(m, n, k);
 }
 
-// Recursive Strassen - simplified version with copying
-static void strassen_recursive(double *A, double *B, double *C, int n, int stride) {
-    // Base case: use naive multiplication
-    if (n <= STRASSEN_THRESHOLD) {
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                double sum = 0.0;
-                for (int k = 0; k < n; k++) {
-                    sum += A[i * stride + k] * B[k * stride + j];
-                }
-                C[i * stride + j] += sum;
-            }
-        }
+// Recursive Strassen on strided views: C += A * B where C is m x n, A is
+// m x k and B is k x n, each addressed through its leading dimension.
+// Quadrants are addressed in place; only operand sums and products that feed
+// two C quadrants are materialized in ws (see strassen_workspace_elems), so
+// the recursion performs no copies and no heap allocation.
+static void strassen_recursive(int m, int n, int k,
+                               const double *A, int lda, const double *B, int ldb,
+                               double *C, int ldc, double *ws) {
+    // Base case: packed engine on the strided views
+    if (is_strassen_base(m, n, k)) {
+        packed_gemm_small(m, n, k, A, lda, B, ldb, C, ldc, 1, ws);
         return;
     }
     
-    int half = n / 2;
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    size_t m_elems = (size_t)hm * hn;
     
-    // Allocate temporary matrices (all are half × half)
-    double *A11 = matrix_allocate(half);
-    double *A12 = matrix_allocate(half);
-    double *A21 = matrix_allocate(half);
-    double *A22 = matrix_allocate(half);
+    // Quadrant views of the even part
+    const double *A11 = A, *A12 = A + hk, *A21 = A + hm * lda, *A22 = A + hm * lda + hk;
+    const double *B11 = B, *B12 = B + hn, *B21 = B + hk * ldb, *B22 = B + hk * ldb + hn;
+    double *C11 = C, *C12 = C + hn, *C21 = C + hm * ldc, *C22 = C + hm * ldc + hn;
     
-    double *B11 = matrix_allocate(half);
-    double *B12 = matrix_allocate(half);
-    double *B21 = matrix_allocate(half);
-    double *B22 = matrix_allocate(half);
+    // Temporaries (contiguous) carved from this level's slice
+    double *TA = ws;                        // hm x hk
+    double *TB = TA + (size_t)hm * hk;      // hk x hn
+    double *M = TB + (size_t)hk * hn;       // hm x hn
     
-    double *M1 = matrix_allocate(half);
-    double *M2 = matrix_allocate(half);
-    double *M3 = matrix_allocate(half);
-    double *M4 = matrix_allocate(half);
-    double *M5 = matrix_allocate(half);
-    double *M6 = matrix_allocate(half);
-    double *M7 = matrix_allocate(half);
+    // Children share the rest of the slice
+    double *child_ws = M + m_elems;
     
-    double *temp1 = matrix_allocate(half);
-    double *temp2 = matrix_allocate(half);
+    // M1 = (A11 + A22) * (B11 + B22) -> C11 += M1, C22 += M1
+    matrix_add_strided(hm, hk, A11, lda, A22, lda, TA, hk);
+    matrix_add_strided(hk, hn, B11, ldb, B22, ldb, TB, hn);
+    memset(M, 0, m_elems * sizeof(double));
+    strassen_recursive(hm, hn, hk, TA, hk, TB, hn, M, hn, child_ws);
+    matrix_add_strided(hm, hn, C11, ldc, M, hn, C11, ldc);
+    matrix_add_strided(hm, hn, C22, ldc, M, hn, C22, ldc);
     
-    // Copy submatrices from A and B
-    copy_submatrix(A, A11, half, 0, 0, stride, 0, 0, half);
-    copy_submatrix(A, A12, half, 0, half, stride, 0, 0, half);
-    copy_submatrix(A, A21, half, half, 0, stride, 0, 0, half);
-    copy_submatrix(A, A22, half, half, half, stride, 0, 0, half);
+    // M2 = (A21 + A22) * B11 -> C21 += M2, C22 -= M2
+    matrix_add_strided(hm, hk, A21, lda, A22, lda, TA, hk);
+    memset(M, 0, m_elems * sizeof(double));
+    strassen_recursive(hm, hn, hk, TA, hk, B11, ldb, M, hn, child_ws);
+    matrix_add_strided(hm, hn, C21, ldc, M, hn, C21, ldc);
+    matrix_sub_strided(hm, hn, C22, ldc, M, hn, C22, ldc);
     
-    copy_submatrix(B, B11, half, 0, 0, stride, 0, 0, half);
-    copy_submatrix(B, B12, half, 0, half, stride, 0, 0, half);
-    copy_submatrix(B, B21, half, half, 0, stride, 0, 0, half);
-    copy_submatrix(B, B22, half, half, half, stride, 0, 0, half);
+    // M3 = A11 * (B12 - B22) -> C12 += M3, C22 += M3
+    matrix_sub_strided(hk, hn, B12, ldb, B22, ldb, TB, hn);
+    memset(M, 0, m_elems * sizeof(double));
+    strassen_recursive(hm, hn, hk, A11, lda, TB, hn, M, hn, child_ws);
+    matrix_add_strided(hm, hn, C12, ldc, M, hn, C12, ldc);
+    matrix_add_strided(hm, hn, C22, ldc, M, hn, C22, ldc);
     
-    // M1 = (A11 + A22) * (B11 + B22)
-    matrix_add(A11, A22, temp1, half);
-    matrix_add(B11, B22, temp2, half);
-    matrix_zero_init(M1, half);
-    strassen_recursive(temp1, temp2, M1, half, half);
+    // M4 = A22 * (B21 - B11) -> C11 += M4, C21 += M4
+    matrix_sub_strided(hk, hn, B21, ldb, B11, ldb, TB, hn);
+    memset(M, 0, m_elems * sizeof(double));
+    strassen_recursive(hm, hn, hk, A22, lda, TB, hn, M, hn, child_ws);
+    matrix_add_strided(hm, hn, C11, ldc, M, hn, C11, ldc);
+    matrix_add_strided(hm, hn, C21, ldc, M, hn, C21, ldc);
     
-    // M2 = (A21 + A22) * B11
-    matrix_add(A21, A22, temp1, half);
-    matrix_zero_init(M2, half);
-    strassen_recursive(temp1, B11, M2, half, half);
+    // M5 = (A11 + A12) * B22 -> C11 -= M5, C12 += M5
+    matrix_add_strided(hm, hk, A11, lda, A12, lda, TA, hk);
+    memset(M, 0, m_elems * sizeof(double));
+    strassen_recursive(hm, hn, hk, TA, hk, B22, ldb, M, hn, child_ws);
+    matrix_sub_strided(hm, hn, C11, ldc, M, hn, C11, ldc);
+    matrix_add_strided(hm, hn, C12, ldc, M, hn, C12, ldc);
     
-    // M3 = A11 * (B12 - B22)
-    matrix_sub(B12, B22, temp2, half);
-    matrix_zero_init(M3, half);
-    strassen_recursive(A11, temp2, M3, half, half);
+    // M6 = (A21 - A11) * (B11 + B12) only feeds C22: accumulate in place
+    matrix_sub_strided(hm, hk, A21, lda, A11, lda, TA, hk);
+    matrix_add_strided(hk, hn, B11, ldb, B12, ldb, TB, hn);
+    strassen_recursive(hm, hn, hk, TA, hk, TB, hn, C22, ldc, child_ws);
     
-    // M4 = A22 * (B21 - B11)
-    matrix_sub(B21, B11, temp2, half);
-    matrix_zero_init(M4, half);
-    strassen_recursive(A22, temp2, M4, half, half);
+    // M7 = (A12 - A22) * (B21 + B22) only feeds C11: accumulate in place
+    matrix_sub_strided(hm, hk, A12, lda, A22, lda, TA, hk);
+    matrix_add_strided(hk, hn, B21, ldb, B22, ldb, TB, hn);
+    strassen_recursive(hm, hn, hk, TA, hk, TB, hn, C11, ldc, child_ws);
     
-    // M5 = (A11 + A12) * B22
-    matrix_add(A11, A12, temp1, half);
-    matrix_zero_init(M5, half);
-    strassen_recursive(temp1, B22, M5, half, half);
-    
-    // M6 = (A21 - A11) * (B11 + B12)
-    matrix_sub(A21, A11, temp1, half);
-    matrix_add(B11, B12, temp2, half);
-    matrix_zero_init(M6, half);
-    strassen_recursive(temp1, temp2, M6, half, half);
-    
-    // M7 = (A12 - A22) * (B21 + B22)
-    matrix_sub(A12, A22, temp1, half);
-    matrix_add(B21, B22, temp2, half);
-    matrix_zero_init(M7, half);
-    strassen_recursive(temp1, temp2, M7, half, half);
-    
-    // Combine results into C
-    // C11 = M1 + M4 - M5 + M7
-    // C12 = M3 + M5
-    // C21 = M2 + M4
-    // C22 = M1 - M2 + M3 + M6
-    for (int i = 0; i < half; i++) {
-        for (int j = 0; j < half; j++) {
-            C[i * stride + j] += M1[i * half + j] + M4[i * half + j] - M5[i * half + j] + M7[i * half + j];
-            C[i * stride + (j + half)] += M3[i * half + j] + M5[i * half + j];
-            C[(i + half) * stride + j] += M2[i * half + j] + M4[i * half + j];
-            C[(i + half) * stride + (j + half)] += M1[i * half + j] - M2[i * half + j] + M3[i * half + j] + M6[i * half + j];
+    // Peel: odd row, column and inner term of this level
+    matrix_peel_fixup(m, n, k, A, lda, B, ldb, C, ldc, 1);
+}
+
+void strassen_serial_rect(int m, int n, int k,
+                          const double *A, int lda, const double *B, int ldb,
+                          double *C, int ldc) {
+    // One allocation covers every recursion level
+    double *workspace = NULL;
+    size_t ws_elems = strassen_workspace_elems(m, n, k);
+    if (ws_elems > 0) {
+        workspace = (double *)mm_aligned_alloc(ws_elems * sizeof(double));
+        if (!workspace) {
+            fprintf(stderr, "strassen_serial: failed to allocate workspace, using naive multiply\n");
+            matrix_mul_strided(m, n, k, A, lda, B, ldb, C, ldc, 0);
+            return;
         }
     }
     
-    // Free all temporary matrices
-    matrix_free(A11); matrix_free(A12); matrix_free(A21); matrix_free(A22);
-    matrix_free(B11); matrix_free(B12); matrix_free(B21); matrix_free(B22);
-    matrix_free(M1); matrix_free(M2); matrix_free(M3); matrix_free(M4);
-    matrix_free(M5); matrix_free(M6); matrix_free(M7);
-    matrix_free(temp1); matrix_free(temp2);
+    for (int i = 0; i < m; i++) {
+        memset(&C[(size_t)i * ldc], 0, (size_t)n * sizeof(double));
+    }
+    strassen_recursive(m, n, k, A, lda, B, ldb, C, ldc, workspace);
+    
+    mm_aligned_free(workspace);
 }
 
 void strassen_serial(double *A, double *B, double *C, int n) {
-    // Pad to next power of 2 if needed
-    int padded_n = next_power_of_2(n);
-    
-    if (padded_n != n) {
-        // Need padding
-        double *A_padded = matrix_allocate(padded_n);
-        double *B_padded = matrix_allocate(padded_n);
-        double *C_padded = matrix_allocate(padded_n);
-        
-        matrix_zero_init(A_padded, padded_n);
-        matrix_zero_init(B_padded, padded_n);
-        matrix_zero_init(C_padded, padded_n);
-        
-        // Copy original matrices
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                A_padded[i * padded_n + j] = A[i * n + j];
-                B_padded[i * padded_n + j] = B[i * n + j];
-            }
-        }
-        
-        strassen_recursive(A_padded, B_padded, C_padded, padded_n, padded_n);
-        
-        // Copy result back
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                C[i * n + j] = C_padded[i * padded_n + j];
-            }
-        }
-        
-        matrix_free(A_padded);
-        matrix_free(B_padded);
-        matrix_free(C_padded);
-    } else {
-        // Already power of 2
-        matrix_zero_init(C, n);
-        strassen_recursive(A, B, C, n, n);
+    strassen_serial_rect(n, n, n, A, n, B, n, C, n);
+}
+
+// ========== STRASSEN-WINOGRAD (SERIAL) ==========
+// Winograd's variant: 7 multiplies and 15 additions per level. Operands are
+// read in place through their leading dimensions and the schedule below
+// (Boyer, Dumas, Pernet, Zhou) writes C directly, so each level needs only
+// two temporaries: X for A-side sums (later P1) and Y for B-side sums.
+// Odd dimensions are peeled and the base case is chosen exactly as in
+// strassen_recursive.
+
+// Workspace (in elements) for an m x n x k problem: X holds an hm x hk sum
+// and later the hm x hn product P1, Y an hk x hn sum.
+static size_t winograd_workspace_elems(int m, int n, int k) {
+    size_t total = 0;
+    while (!is_strassen_base(m, n, k)) {
+        m /= 2;
+        n /= 2;
+        k /= 2;
+        total += (size_t)m * (k > n ? k : n) + (size_t)k * n;
     }
+    return total + packed_gemm_small_workspace(m, n, k);
 }
 
-// ========== PROPOSED ALGORITHM (SERIAL) ==========
-// Block size for cache optimization (tune this based on cache size)
-// Typical L1 cache: 32KB, so BS=64 means 64*64*8 = 32KB per block
-#define BLOCK_SIZE 64
+// C = A * B (overwrite) where C is m x n, A is m x k and B is k x n, each a
+// strided view with leading dimension lda/ldb/ldc.
+static void winograd_recursive(int m, int n, int k,
+                               const double *A, int lda, const double *B, int ldb,
+                               double *C, int ldc, double *ws) {
+    if (is_strassen_base(m, n, k)) {
+        packed_gemm_small(m, n, k, A, lda, B, ldb, C, ldc, 0, ws);
+        return;
+    }
 
-void proposed_serial(double *A, double *B, double *C, int n) {
-    // Step 1: Transpose B for better cache locality
-    double *B_T = matrix_allocate(n);
-    matrix_transpose(B, B_T, n);
-    
-    // Step 2: Zero-initialize C
-    matrix_zero_init(C, n);
-    
-    // Step 3: Cache-blocked multiplication with transposed B
-    // Now we compute C[i][j] = sum_k A[i][k] * B_T[j][k]
-    // Both A[i][*] and B_T[j][*] are row-contiguous = happy cache
-    for (int ii = 0; ii < n; ii += BLOCK_SIZE) {
-        for (int jj = 0; jj < n; jj += BLOCK_SIZE) {
-            for (int kk = 0; kk < n; kk += BLOCK_SIZE) {
-                // Compute block boundaries
-                int i_end = (ii + BLOCK_SIZE < n) ? ii + BLOCK_SIZE : n;
-                int j_end = (jj + BLOCK_SIZE < n) ? jj + BLOCK_SIZE : n;
-                int k_end = (kk + BLOCK_SIZE < n) ? kk + BLOCK_SIZE : n;
-                
-                // Inner block computation
-                for (int i = ii; i < i_end; i++) {
-                    for (int j = jj; j < j_end; j++) {
-                        double sum = 0.0;
-                        // Dot product of A[i][k] and B_T[j][k] over k
-                        for (int k = kk; k < k_end; k++) {
-                            sum += A[i * n + k] * B_T[j * n + k];
-                        }
-                        C[i * n + j] += sum;
-                    }
-                }
-            }
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+
+    const double *A11 = A, *A12 = A + hk, *A21 = A + hm * lda, *A22 = A + hm * lda + hk;
+    const double *B11 = B, *B12 = B + hn, *B21 = B + hk * ldb, *B22 = B + hk * ldb + hn;
+    double *C11 = C, *C12 = C + hn, *C21 = C + hm * ldc, *C22 = C + hm * ldc + hn;
+
+    double *X = ws;
+    double *Y = ws + (size_t)hm * (hk > hn ? hk : hn);
+    double *child_ws = Y + (size_t)hk * hn;
+
+    matrix_sub_strided(hm, hk, A11, lda, A21, lda, X, hk);                    // S3 = A11 - A21
+    matrix_sub_strided(hk, hn, B22, ldb, B12, ldb, Y, hn);                    // T3 = B22 - B12
+    winograd_recursive(hm, hn, hk, X, hk, Y, hn, C21, ldc, child_ws);         // P7 = S3 T3
+    matrix_add_strided(hm, hk, A21, lda, A22, lda, X, hk);                    // S1 = A21 + A22
+    matrix_sub_strided(hk, hn, B12, ldb, B11, ldb, Y, hn);                    // T1 = B12 - B11
+    winograd_recursive(hm, hn, hk, X, hk, Y, hn, C22, ldc, child_ws);         // P5 = S1 T1
+    matrix_sub_strided(hm, hk, X, hk, A11, lda, X, hk);                       // S2 = S1 - A11
+    matrix_sub_strided(hk, hn, B22, ldb, Y, hn, Y, hn);                       // T2 = B22 - T1
+    winograd_recursive(hm, hn, hk, X, hk, Y, hn, C12, ldc, child_ws);         // P6 = S2 T2
+    matrix_sub_strided(hm, hk, A12, lda, X, hk, X, hk);                       // S4 = A12 - S2
+    winograd_recursive(hm, hn, hk, X, hk, B22, ldb, C11, ldc, child_ws);      // P3 = S4 B22
+    winograd_recursive(hm, hn, hk, A11, lda, B11, ldb, X, hn, child_ws);      // P1 = A11 B11
+    matrix_add_strided(hm, hn, X, hn, C12, ldc, C12, ldc);                    // U2 = P1 + P6
+    matrix_add_strided(hm, hn, C12, ldc, C21, ldc, C21, ldc);                 // U3 = U2 + P7
+    matrix_add_strided(hm, hn, C12, ldc, C22, ldc, C12, ldc);                 // U4 = U2 + P5
+    matrix_add_strided(hm, hn, C21, ldc, C22, ldc, C22, ldc);                 // U7 = U3 + P5 -> C22
+    matrix_add_strided(hm, hn, C12, ldc, C11, ldc, C12, ldc);                 // U5 = U4 + P3 -> C12
+    matrix_sub_strided(hk, hn, Y, hn, B21, ldb, Y, hn);                       // T4 = T2 - B21
+    winograd_recursive(hm, hn, hk, A22, lda, Y, hn, C11, ldc, child_ws);      // P4 = A22 T4
+    matrix_sub_strided(hm, hn, C21, ldc, C11, ldc, C21, ldc);                 // U6 = U3 - P4 -> C21
+    winograd_recursive(hm, hn, hk, A12, lda, B21, ldb, C11, ldc, child_ws);   // P2 = A12 B21
+    matrix_add_strided(hm, hn, X, hn, C11, ldc, C11, ldc);                    // U1 = P1 + P2 -> C11
+
+    // Peel: odd row, column and inner term of this level
+    matrix_peel_fixup(m, n, k, A, lda, B, ldb, C, ldc, 0);
+}
+
+void winograd_serial_rect(int m, int n, int k,
+                          const double *A, int lda, const double *B, int ldb,
+                          double *C, int ldc) {
+    double *workspace = NULL;
+    size_t ws_elems = winograd_workspace_elems(m, n, k);
+    if (ws_elems > 0) {
+        workspace = (double *)mm_aligned_alloc(ws_elems * sizeof(double));
+        if (!workspace) {
+            fprintf(stderr, "winograd_serial: failed to allocate workspace, using naive multiply\n");
+            matrix_mul_strided(m, n, k, A, lda, B, ldb, C, ldc, 0);
+            return;
         }
     }
-    
-    // Step 4: Clean up
-    matrix_free(B_T);
+
+    winograd_recursive(m, n, k, A, lda, B, ldb, C, ldc, workspace);
+
+    mm_aligned_free(workspace);
+}
+
+void winograd_serial(double *A, double *B, double *C, int n) {
+    winograd_serial_rect(n, n, n, A, n, B, n, C, n);
+}
+
+// ========== PROPOSED ALGORITHM (SERIAL) ==========
+// Packed-panel GEMM: A and B are repacked into cache-sized micro-panels and an
+// MR x NR register-blocked micro-kernel sweeps C (see packed_gemm.c).
+void proposed_serial(double *A, double *B, double *C, int n) {
+    packed_gemm(n, n, n, A, n, B, n, C, n, 0, 0);
+}
+
+void proposed_serial_epilogue(double *A, double *B, double *C, int n, const mm_epilogue *ep) {
+    packed_gemm_epilogue(n, n, n, A, n, B, n, C, n, ep, 0);
+}
+
+// ========== CACHE-OBLIVIOUS ALGORITHM (SERIAL) ==========
+// Recursive halving over Z-order tiles (see oblivious.c).
+void oblivious_serial(double *A, double *B, double *C, int n) {
+    oblivious_gemm(n, n, n, A, n, B, n, C, n, 0);
 }
@@ -4,6 +4,9 @@
 #ifndef KERNELS_H
 #define KERNELS_H
 
+#include "epilogue.h"
+#include <stddef.h>
+
 // ========== Naive Matrix Multiplication ==========
 
 // matmul_serial
@@ -30,35 +33,145 @@ void matmul_omp(double *A, double *B, double *C, int n);
 // strassen_serial
 // Input:
 //   A, B, C: n x n matrices (row-major).
-//   n:      matrix dimension; non powers of two are padded internally.
+//   n:      matrix dimension; any n >= 1.
 // Behavior:
-//   Computes C = A * B using Strassen recursion with a naive base case (n<=64).
-// Constraints:
-//   Matrices must be square; padding is handled internally.
+//   Computes C = A * B using Strassen recursion down to a serial packed-panel
+//   base case (packed_gemm_small) at strassen_threshold (default 128).
+//   Each level works on quadrant views (pointer + leading dimension) of its
+//   parent; only operand sums are materialized and C is updated in place.
+//   Odd dimensions are handled by dynamic peeling: the even part recurses and
+//   the odd row/column/inner term are fixed up with GEMV and rank-1 updates,
+//   so nothing is padded to a power of two.
 // Complexity:
-//   Time O(n^log2(7)), space O(n^2) for temporaries.
+//   Time O(n^log2(7)), space O(n^2) for temporaries. The exact workspace for
+//   every recursion level is computed up front and allocated once per call;
+//   the recursion itself does not touch the allocator.
 void strassen_serial(double *A, double *B, double *C, int n);
 
 // strassen_omp
 // Parallel Strassen implementation that uses OpenMP tasks on large subproblems.
-// Follows the same semantics and constraints as strassen_serial.
+// Follows the same semantics and constraints as strassen_serial; each task
+// receives a private slice of the single up-front workspace allocation.
 void strassen_omp(double *A, double *B, double *C, int n);
 
+// strassen_serial_rect / strassen_omp_rect
+// Input:
+//   m, n, k:    C is m x n, A is m x k, B is k x n (row-major views).
+//   lda/ldb/ldc: leading dimensions of A, B and C.
+// Behavior:
+//   Rectangular form of strassen_serial / strassen_omp (C = A * B, C
+//   overwritten). Used directly by the MPI slab compute.
+void strassen_serial_rect(int m, int n, int k,
+                          const double *A, int lda, const double *B, int ldb,
+                          double *C, int ldc);
+void strassen_omp_rect(int m, int n, int k,
+                       const double *A, int lda, const double *B, int ldb,
+                       double *C, int ldc);
+
+// strassen_omp_task_depth
+// Output: number of recursion levels that spawn OpenMP tasks for an
+//   m x n x k product on a team of nthreads: 0 for a single thread, else
+//   the strassen_task_depth tuning key when set, otherwise the smallest
+//   depth with 7^depth >= 2 * nthreads (at most MM_STRASSEN_MAX_TASK_DEPTH).
+//   Levels are then dropped until strassen_omp_team_workspace fits in
+//   MM_STRASSEN_OMP_WS_BUDGET * (m*k + k*n) elements. Levels below
+//   strassen_parallel_cutoff never spawn tasks.
+int strassen_omp_task_depth(int m, int n, int k, int nthreads);
+
+// strassen_omp_team_workspace / strassen_omp_team
+// Input: as strassen_omp_rect, plus task_depth (levels that spawn tasks,
+//   0 = none; see strassen_omp_task_depth) and ws
+//   (strassen_omp_team_workspace(m, n, k, task_depth, nthreads) elements,
+//   nthreads at least the size of the calling team).
+// Behavior:
+//   strassen_omp_rect for callers that already run a team: every thread of
+//   the enclosing parallel region calls it, one of them runs the recursion
+//   and the others execute its tasks. On task levels the operand sums,
+//   products, combine and peel steps are all tasks ordered by depend
+//   clauses. The serial subtrees below the task levels share one scratch
+//   slot per thread (or per subtree, when there are fewer subtrees than
+//   threads). Uses only ws; nothing is allocated.
+size_t strassen_omp_team_workspace(int m, int n, int k, int task_depth, int nthreads);
+void strassen_omp_team(int m, int n, int k,
+                       const double *A, int lda, const double *B, int ldb,
+                       double *C, int ldc, int task_depth, double *ws);
+
+// ========== Strassen-Winograd Algorithm ==========
+
+// winograd_serial
+// Input:
+//   A, B, C: n x n matrices (row-major).
+//   n:      matrix dimension; any n >= 1 (odd sizes are peeled as in Strassen).
+// Behavior:
+//   Computes C = A * B with Winograd's variant of Strassen (7 multiplies and
+//   15 additions per level). Quadrants are read in place through leading
+//   dimensions and products are written straight into C, so each level needs
+//   only two half x half temporaries (packed base case as in Strassen).
+// Complexity:
+//   Time O(n^log2(7)), extra space ~2n^2/3 allocated once per call.
+void winograd_serial(double *A, double *B, double *C, int n);
+
+// winograd_omp
+// OpenMP variant: at large levels the operand sums run as two tasks and the
+// seven products as seven tasks (11 temporaries on those levels); smaller
+// levels use the two-temporary schedule of winograd_serial.
+void winograd_omp(double *A, double *B, double *C, int n);
+
+// winograd_serial_rect / winograd_omp_rect
+// Rectangular forms of winograd_serial / winograd_omp; same arguments as
+// strassen_serial_rect.
+void winograd_serial_rect(int m, int n, int k,
+                          const double *A, int lda, const double *B, int ldb,
+                          double *C, int ldc);
+void winograd_omp_rect(int m, int n, int k,
+                       const double *A, int lda, const double *B, int ldb,
+                       double *C, int ldc);
+
 // ========== Proposed Algorithm ==========
 
 // proposed_serial
 // Input/Behavior:
-//   Performs cache-blocked GEMM with a transposed copy of B to improve locality.
+//   Performs packed-panel GEMM (see packed_gemm.h): A and B are packed into
+//   L2/L3-sized micro-panels and a register-blocked MR x NR micro-kernel
+//   keeps each tile of C in registers across the k loop.
 // Constraints:
 //   Matrices are n x n in row-major layout; n > 0.
 // Complexity:
-//   Time O(n^3) with improved constants; extra space O(n^2) for B^T.
+//   Time O(n^3) with improved constants; extra space O(KC*(MC+NC)) for packing.
 void proposed_serial(double *A, double *B, double *C, int n);
 
 // proposed_omp
-// OpenMP variant of proposed_serial that parallelizes across output tiles.
+// OpenMP variant of proposed_serial: B panels are packed cooperatively and
+// row blocks of C are distributed across threads.
 void proposed_omp(double *A, double *B, double *C, int n);
 
+// proposed_serial_epilogue / proposed_omp_epilogue
+// Input: as proposed_serial / proposed_omp, plus ep (epilogue.h; NULL is
+//   the plain product).
+// Behavior: C = op(alpha * A * B + beta * C + bias) in the multiply itself
+//   (packed_gemm_epilogue): bias and op are applied to each register tile
+//   right after its last k block instead of in a pass over C afterwards.
+void proposed_serial_epilogue(double *A, double *B, double *C, int n, const mm_epilogue *ep);
+void proposed_omp_epilogue(double *A, double *B, double *C, int n, const mm_epilogue *ep);
+
+// ========== Cache-Oblivious Algorithm ==========
+
+// oblivious_serial
+// Input/Behavior:
+//   Recursive GEMM on a Z-order tiled copy of the operands (see oblivious.h):
+//   the largest dimension is halved until one 32 x 32 tile of each operand
+//   remains, with no cache-size parameter to tune.
+// Constraints:
+//   Matrices are n x n in row-major layout; n > 0.
+// Complexity:
+//   Time O(n^3); extra space 3 * n^2 doubles rounded up to whole tiles.
+void oblivious_serial(double *A, double *B, double *C, int n);
+
+// oblivious_omp
+// OpenMP variant of oblivious_serial: the layout conversions are split
+// across the team and independent halves of m and n run as tasks.
+void oblivious_omp(double *A, double *B, double *C, int n);
+
 // BLAS baseline (optional; requires USE_CBLAS to link against CBLAS).
 void matmul_blas(double *A, double *B, double *C, int n);
 int matmul_blas_available(void);
@@ -0,0 +1,373 @@
+// kernels_f32.c
+// fp32 and mixed-precision kernel families (see kernels_f32.h). The Strassen
+// recursion follows omp_kernels.c; the serial entry point simply runs it
+// without tasks and with the serial base-case size.
+
+#include "kernels_f32.h"
+#include "packed_gemm_f32.h"
+#include "tuning.h"
+#include "utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ========== NAIVE (fp32) ==========
+void matmul_serial_f32(float *A, float *B, float *C, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < n; k++) {
+                sum += A[i*n + k] * B[k*n + j];
+            }
+            C[i*n + j] = sum;
+        }
+    }
+}
+
+void matmul_omp_f32(float *A, float *B, float *C, int n) {
+    #pragma omp parallel for
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            float sum = 0.0f;
+            for (int k = 0; k < n; k++) {
+                sum += A[i*n + k] * B[k*n + j];
+            }
+            C[i*n + j] = sum;
+        }
+    }
+}
+
+// ========== STRASSEN (fp32) ==========
+
+// fp32 counterparts of the strided helpers in utility.c.
+static void add_strided_f32(int rows, int cols, const float *A, int lda,
+                            const float *B, int ldb, float *C, int ldc) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            C[(size_t)i * ldc + j] = A[(size_t)i * lda + j] + B[(size_t)i * ldb + j];
+        }
+    }
+}
+
+static void sub_strided_f32(int rows, int cols, const float *A, int lda,
+                            const float *B, int ldb, float *C, int ldc) {
+    for (int i = 0; i < rows; i++) {
+        for (int j = 0; j < cols; j++) {
+            C[(size_t)i * ldc + j] = A[(size_t)i * lda + j] - B[(size_t)i * ldb + j];
+        }
+    }
+}
+
+static void mul_strided_f32(int m, int n, int k, const float *A, int lda,
+                            const float *B, int ldb, float *C, int ldc, int accumulate) {
+    for (int i = 0; i < m; i++) {
+        float *restrict c_row = C + (size_t)i * ldc;
+        const float *a_row = A + (size_t)i * lda;
+        if (!accumulate) {
+            for (int j = 0; j < n; j++) c_row[j] = 0.0f;
+        }
+        for (int p = 0; p < k; p++) {
+            float a = a_row[p];
+            const float *restrict b_row = B + (size_t)p * ldb;
+            for (int j = 0; j < n; j++) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+}
+
+// See matrix_peel_fixup in utility.c.
+static void peel_fixup_f32(int m, int n, int k, const float *A, int lda,
+                           const float *B, int ldb, float *C, int ldc) {
+    int m2 = m & ~1;
+    int n2 = n & ~1;
+    int k2 = k & ~1;
+
+    if (k2 != k) {
+        const float *b_row = B + (size_t)k2 * ldb;
+        for (int i = 0; i < m2; i++) {
+            float a = A[(size_t)i * lda + k2];
+            float *c_row = C + (size_t)i * ldc;
+            for (int j = 0; j < n2; j++) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+    if (n2 != n) {
+        mul_strided_f32(m, 1, k, A, lda, B + n2, ldb, C + n2, ldc, 1);
+    }
+    if (m2 != m) {
+        mul_strided_f32(1, n2, k, A + (size_t)m2 * lda, lda, B, ldb,
+                        C + (size_t)m2 * ldc, ldc, 1);
+    }
+}
+
+static int is_strassen_base(int m, int n, int k, int cutoff) {
+    return m <= cutoff || n <= cutoff || k <= cutoff;
+}
+
+static int is_task_level(int m, int n, int k, int use_tasks) {
+    int cutoff = mm_tuning()->strassen_parallel_cutoff;
+    return use_tasks && m >= cutoff && n >= cutoff && k >= cutoff;
+}
+
+// Workspace (in elements) for strassen_recursive_f32. At most the top level
+// spawns tasks, each with a private slice for its operand sums and serial
+// subtree, so this stays near 6.5 n^2 with no depth to cap.
+static size_t strassen_f32_workspace_elems(int m, int n, int k, int cutoff, int use_tasks) {
+    if (is_strassen_base(m, n, k, cutoff)) return packed_sgemm_small_workspace(m, n, k);
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    size_t a_elems = (size_t)hm * hk;
+    size_t b_elems = (size_t)hk * hn;
+    size_t c_elems = (size_t)hm * hn;
+    size_t child = strassen_f32_workspace_elems(hm, hn, hk, cutoff, 0);
+    if (is_task_level(m, n, k, use_tasks)) {
+        return 5 * c_elems + 7 * (a_elems + b_elems + child);
+    }
+    return a_elems + b_elems + c_elems + child;
+}
+
+// C += A * B on strided views; see strassen_recursive_omp.
+static void strassen_recursive_f32(int m, int n, int k,
+                                   const float *A, int lda, const float *B, int ldb,
+                                   float *C, int ldc, int cutoff, int use_tasks, float *ws) {
+    if (is_strassen_base(m, n, k, cutoff)) {
+        packed_sgemm_small(m, n, k, A, lda, B, ldb, C, ldc, 1, ws);
+        return;
+    }
+
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    size_t a_elems = (size_t)hm * hk;
+    size_t b_elems = (size_t)hk * hn;
+    size_t c_elems = (size_t)hm * hn;
+
+    const float *A11 = A, *A12 = A + hk, *A21 = A + hm * lda, *A22 = A + hm * lda + hk;
+    const float *B11 = B, *B12 = B + hn, *B21 = B + hk * ldb, *B22 = B + hk * ldb + hn;
+    float *C11 = C, *C12 = C + hn, *C21 = C + hm * ldc, *C22 = C + hm * ldc + hn;
+
+    if (is_task_level(m, n, k, use_tasks)) {
+        float *M1 = ws + 0 * c_elems;
+        float *M2 = ws + 1 * c_elems;
+        float *M3 = ws + 2 * c_elems;
+        float *M4 = ws + 3 * c_elems;
+        float *M5 = ws + 4 * c_elems;
+        float *rest = ws + 5 * c_elems;
+
+        size_t task_slice = a_elems + b_elems +
+                            strassen_f32_workspace_elems(hm, hn, hk, cutoff, 0);
+        float *ws1 = rest + 0 * task_slice;
+        float *ws2 = rest + 1 * task_slice;
+        float *ws3 = rest + 2 * task_slice;
+        float *ws4 = rest + 3 * task_slice;
+        float *ws5 = rest + 4 * task_slice;
+        float *ws6 = rest + 5 * task_slice;
+        float *ws7 = rest + 6 * task_slice;
+
+        #pragma omp task
+        {
+            float *t1 = ws1;
+            float *t2 = ws1 + a_elems;
+            add_strided_f32(hm, hk, A11, lda, A22, lda, t1, hk);
+            add_strided_f32(hk, hn, B11, ldb, B22, ldb, t2, hn);
+            memset(M1, 0, c_elems * sizeof(float));
+            strassen_recursive_f32(hm, hn, hk, t1, hk, t2, hn, M1, hn, cutoff, 0, t2 + b_elems);
+        }
+
+        #pragma omp task
+        {
+            float *t1 = ws2;
+            add_strided_f32(hm, hk, A21, lda, A22, lda, t1, hk);
+            memset(M2, 0, c_elems * sizeof(float));
+            strassen_recursive_f32(hm, hn, hk, t1, hk, B11, ldb, M2, hn, cutoff, 0,
+                                   ws2 + a_elems + b_elems);
+        }
+
+        #pragma omp task
+        {
+            float *t2 = ws3 + a_elems;
+            sub_strided_f32(hk, hn, B12, ldb, B22, ldb, t2, hn);
+            memset(M3, 0, c_elems * sizeof(float));
+            strassen_recursive_f32(hm, hn, hk, A11, lda, t2, hn, M3, hn, cutoff, 0, t2 + b_elems);
+        }
+
+        #pragma omp task
+        {
+            float *t2 = ws4 + a_elems;
+            sub_strided_f32(hk, hn, B21, ldb, B11, ldb, t2, hn);
+            memset(M4, 0, c_elems * sizeof(float));
+            strassen_recursive_f32(hm, hn, hk, A22, lda, t2, hn, M4, hn, cutoff, 0, t2 + b_elems);
+        }
+
+        #pragma omp task
+        {
+            float *t1 = ws5;
+            add_strided_f32(hm, hk, A11, lda, A12, lda, t1, hk);
+            memset(M5, 0, c_elems * sizeof(float));
+            strassen_recursive_f32(hm, hn, hk, t1, hk, B22, ldb, M5, hn, cutoff, 0,
+                                   ws5 + a_elems + b_elems);
+        }
+
+        #pragma omp task
+        {
+            float *t1 = ws6;
+            float *t2 = ws6 + a_elems;
+            sub_strided_f32(hm, hk, A21, lda, A11, lda, t1, hk);
+            add_strided_f32(hk, hn, B11, ldb, B12, ldb, t2, hn);
+            strassen_recursive_f32(hm, hn, hk, t1, hk, t2, hn, C22, ldc, cutoff, 0, t2 + b_elems);
+        }
+
+        #pragma omp task
+        {
+            float *t1 = ws7;
+            float *t2 = ws7 + a_elems;
+            sub_strided_f32(hm, hk, A12, lda, A22, lda, t1, hk);
+            add_strided_f32(hk, hn, B21, ldb, B22, ldb, t2, hn);
+            strassen_recursive_f32(hm, hn, hk, t1, hk, t2, hn, C11, ldc, cutoff, 0, t2 + b_elems);
+        }
+
+        #pragma omp taskwait
+
+        for (int i = 0; i < hm; i++) {
+            for (int j = 0; j < hn; j++) {
+                size_t e = (size_t)i * hn + j;
+                C11[i * ldc + j] += M1[e] + M4[e] - M5[e];
+                C12[i * ldc + j] += M3[e] + M5[e];
+                C21[i * ldc + j] += M2[e] + M4[e];
+                C22[i * ldc + j] += M1[e] - M2[e] + M3[e];
+            }
+        }
+    } else {
+        float *TA = ws;
+        float *TB = TA + a_elems;
+        float *M = TB + b_elems;
+        float *child_ws = M + c_elems;
+
+        add_strided_f32(hm, hk, A11, lda, A22, lda, TA, hk);
+        add_strided_f32(hk, hn, B11, ldb, B22, ldb, TB, hn);
+        memset(M, 0, c_elems * sizeof(float));
+        strassen_recursive_f32(hm, hn, hk, TA, hk, TB, hn, M, hn, cutoff, 0, child_ws);
+        add_strided_f32(hm, hn, C11, ldc, M, hn, C11, ldc);
+        add_strided_f32(hm, hn, C22, ldc, M, hn, C22, ldc);
+
+        add_strided_f32(hm, hk, A21, lda, A22, lda, TA, hk);
+        memset(M, 0, c_elems * sizeof(float));
+        strassen_recursive_f32(hm, hn, hk, TA, hk, B11, ldb, M, hn, cutoff, 0, child_ws);
+        add_strided_f32(hm, hn, C21, ldc, M, hn, C21, ldc);
+        sub_strided_f32(hm, hn, C22, ldc, M, hn, C22, ldc);
+
+        sub_strided_f32(hk, hn, B12, ldb, B22, ldb, TB, hn);
+        memset(M, 0, c_elems * sizeof(float));
+        strassen_recursive_f32(hm, hn, hk, A11, lda, TB, hn, M, hn, cutoff, 0, child_ws);
+        add_strided_f32(hm, hn, C12, ldc, M, hn, C12, ldc);
+        add_strided_f32(hm, hn, C22, ldc, M, hn, C22, ldc);
+
+        sub_strided_f32(hk, hn, B21, ldb, B11, ldb, TB, hn);
+        memset(M, 0, c_elems * sizeof(float));
+        strassen_recursive_f32(hm, hn, hk, A22, lda, TB, hn, M, hn, cutoff, 0, child_ws);
+        add_strided_f32(hm, hn, C11, ldc, M, hn, C11, ldc);
+        add_strided_f32(hm, hn, C21, ldc, M, hn, C21, ldc);
+
+        add_strided_f32(hm, hk, A11, lda, A12, lda, TA, hk);
+        memset(M, 0, c_elems * sizeof(float));
+        strassen_recursive_f32(hm, hn, hk, TA, hk, B22, ldb, M, hn, cutoff, 0, child_ws);
+        sub_strided_f32(hm, hn, C11, ldc, M, hn, C11, ldc);
+        add_strided_f32(hm, hn, C12, ldc, M, hn, C12, ldc);
+
+        sub_strided_f32(hm, hk, A21, lda, A11, lda, TA, hk);
+        add_strided_f32(hk, hn, B11, ldb, B12, ldb, TB, hn);
+        strassen_recursive_f32(hm, hn, hk, TA, hk, TB, hn, C22, ldc, cutoff, 0, child_ws);
+
+        sub_strided_f32(hm, hk, A12, lda, A22, lda, TA, hk);
+        add_strided_f32(hk, hn, B21, ldb, B22, ldb, TB, hn);
+        strassen_recursive_f32(hm, hn, hk, TA, hk, TB, hn, C11, ldc, cutoff, 0, child_ws);
+    }
+
+    peel_fixup_f32(m, n, k, A, lda, B, ldb, C, ldc);
+}
+
+static void strassen_f32(float *A, float *B, float *C, int n, int use_omp) {
+    const mm_tuning_params *tune = mm_tuning();
+    int cutoff = use_omp ? tune->strassen_threshold_omp : tune->strassen_threshold;
+
+    float *workspace = NULL;
+    size_t ws_elems = strassen_f32_workspace_elems(n, n, n, cutoff, use_omp);
+    if (ws_elems > 0) {
+        workspace = (float *)mm_aligned_alloc(ws_elems * sizeof(float));
+        if (!workspace) {
+            fprintf(stderr, "strassen_f32: failed to allocate workspace, using naive multiply\n");
+            mul_strided_f32(n, n, n, A, n, B, n, C, n, 0);
+            return;
+        }
+    }
+
+    if (use_omp) {
+        #pragma omp parallel
+        {
+            // Clear C across the team before the recursion accumulates into it
+            #pragma omp for schedule(static)
+            for (int i = 0; i < n; i++) {
+                memset(&C[(size_t)i * n], 0, (size_t)n * sizeof(float));
+            }
+            #pragma omp single
+            {
+                strassen_recursive_f32(n, n, n, A, n, B, n, C, n, cutoff, 1, workspace);
+            }
+        }
+    } else {
+        memset(C, 0, (size_t)n * n * sizeof(float));
+        strassen_recursive_f32(n, n, n, A, n, B, n, C, n, cutoff, 0, workspace);
+    }
+
+    mm_aligned_free(workspace);
+}
+
+void strassen_serial_f32(float *A, float *B, float *C, int n) {
+    strassen_f32(A, B, C, n, 0);
+}
+
+void strassen_omp_f32(float *A, float *B, float *C, int n) {
+    strassen_f32(A, B, C, n, 1);
+}
+
+// ========== PROPOSED (fp32) ==========
+void proposed_serial_f32(float *A, float *B, float *C, int n) {
+    packed_sgemm(n, n, n, A, n, B, n, C, n, 0, 0);
+}
+
+void proposed_omp_f32(float *A, float *B, float *C, int n) {
+    packed_sgemm(n, n, n, A, n, B, n, C, n, 0, 1);
+}
+
+// ========== MIXED (fp32 storage, fp64 accumulation) ==========
+void matmul_serial_mixed(float *A, float *B, float *C, int n) {
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < n; k++) {
+                sum += (double)A[i*n + k] * (double)B[k*n + j];
+            }
+            C[i*n + j] = (float)sum;
+        }
+    }
+}
+
+void matmul_omp_mixed(float *A, float *B, float *C, int n) {
+    #pragma omp parallel for
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (int k = 0; k < n; k++) {
+                sum += (double)A[i*n + k] * (double)B[k*n + j];
+            }
+            C[i*n + j] = (float)sum;
+        }
+    }
+}
+
+void proposed_serial_mixed(float *A, float *B, float *C, int n) {
+    packed_gemm_mixed(n, n, n, A, n, B, n, C, n, 0, 0);
+}
+
+void proposed_omp_mixed(float *A, float *B, float *C, int n) {
+    packed_gemm_mixed(n, n, n, A, n, B, n, C, n, 0, 1);
+}
@@ -0,0 +1,50 @@
+// kernels_f32.h
+// Single-precision (fp32) and mixed-precision (fp32 storage, fp64
+// accumulation) kernel families. Same n x n row-major contract as kernels.h;
+// only the element type changes.
+
+#ifndef KERNELS_F32_H
+#define KERNELS_F32_H
+
+// Signature shared by every kernel in this header.
+typedef void (*kernel_f32_func_t)(float *A, float *B, float *C, int n);
+
+// ========== fp32 ==========
+
+// matmul_serial_f32 / matmul_omp_f32
+// Behavior: C = A * B with the classic triple loop, summing in fp32.
+// Complexity: Time O(n^3), space O(1) extra.
+void matmul_serial_f32(float *A, float *B, float *C, int n);
+void matmul_omp_f32(float *A, float *B, float *C, int n);
+
+// strassen_serial_f32 / strassen_omp_f32
+// Behavior: fp32 Strassen with the structure of strassen_serial /
+//   strassen_omp (quadrant views, dynamic peeling, one workspace allocation
+//   per call, tasks above strassen_parallel_cutoff). Rounding error grows
+//   with the recursion depth faster than for the triple loop.
+void strassen_serial_f32(float *A, float *B, float *C, int n);
+void strassen_omp_f32(float *A, float *B, float *C, int n);
+
+// proposed_serial_f32 / proposed_omp_f32
+// Behavior: packed-panel engine with the fp32 micro-kernel (packed_sgemm in
+//   packed_gemm_f32.h): twice the SIMD lanes and half the memory traffic of
+//   the fp64 engine.
+void proposed_serial_f32(float *A, float *B, float *C, int n);
+void proposed_omp_f32(float *A, float *B, float *C, int n);
+
+// ========== Mixed (fp32 storage, fp64 accumulation) ==========
+
+// matmul_serial_mixed / matmul_omp_mixed
+// Behavior: triple loop over fp32 operands with an fp64 running sum; each
+//   entry of C is rounded to fp32 once.
+void matmul_serial_mixed(float *A, float *B, float *C, int n);
+void matmul_omp_mixed(float *A, float *B, float *C, int n);
+
+// proposed_serial_mixed / proposed_omp_mixed
+// Behavior: packed-panel engine that widens fp32 operands to fp64 while
+//   packing and accumulates in fp64 (packed_gemm_mixed): fp32 memory
+//   footprint with fp64 arithmetic.
+void proposed_serial_mixed(float *A, float *B, float *C, int n);
+void proposed_omp_mixed(float *A, float *B, float *C, int n);
+
+#endif // KERNELS_F32_H
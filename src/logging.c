@@ -26,14 +26,41 @@ static log_format_t detect_format(const char *fmt) {
     return LOG_FORMAT_CSV;
 }
 
+#define CSV_HEADER \
+    "timestamp,machine_id,algo,approach,n,nprocs,nthreads,repetitions," \
+    "time_sec,time_min,time_max,time_mean,gflops_gemm_eq,passed," \
+    "speedup_vs_naive,isa,dtype,placement,alloc,page_faults,strategy,note"
+
 static void write_csv_header(FILE *fp) {
-    fprintf(fp,
-            "timestamp,machine_id,algo,approach,n,nprocs,nthreads,repetitions,"
-            "time_sec,time_min,time_max,time_mean,gflops_gemm_eq,passed,"
-            "speedup_vs_naive,note\n");
+    fprintf(fp, CSV_HEADER "\n");
     fflush(fp);
 }
 
+// 1 when path is missing, empty or starts with CSV_HEADER; appending to a
+// file with another column layout would misalign every new row.
+static int csv_header_matches(const char *path) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return 1;
+    char line[512];
+    int match = 1;
+    if (fgets(line, sizeof(line), fp)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        match = strcmp(line, CSV_HEADER) == 0;
+    }
+    fclose(fp);
+    return match;
+}
+
+// Short tag for the current column layout, used to name the file that takes
+// the rows when the default one has an older header.
+static unsigned long csv_layout_tag(void) {
+    unsigned long h = 5381;
+    for (const char *c = CSV_HEADER; *c; c++) {
+        h = (h * 33 + (unsigned char)*c) & 0xffffffffUL;
+    }
+    return h;
+}
+
 static int ensure_dir(const char *path) {
     if (!path || !*path) {
         return -1;
@@ -92,18 +119,32 @@ int experiment_logger_init(experiment_logger *logger, const char *category) {
              basename,
              (logger->format == LOG_FORMAT_JSON) ? "json" : "csv");
 
+    if (logger->format == LOG_FORMAT_CSV && !csv_header_matches(path)) {
+        char layout_path[512];
+        snprintf(layout_path, sizeof(layout_path), "%s/%s_results.%08lx.csv",
+                 results_dir, basename, csv_layout_tag());
+        if (!csv_header_matches(layout_path)) {
+            fprintf(stderr,
+                    "[logging] Error: %s and %s have a different column layout; "
+                    "not logging\n", path, layout_path);
+            logger->format = LOG_FORMAT_NONE;
+            return -1;
+        }
+        fprintf(stderr,
+                "[logging] Warning: %s has a different column layout; "
+                "writing to %s\n", path, layout_path);
+        snprintf(path, sizeof(path), "%s", layout_path);
+    }
+
     logger->fp = fopen(path, "a");
     if (!logger->fp) {
         logger->format = LOG_FORMAT_NONE;
         return -1;
     }
 
-    if (logger->format == LOG_FORMAT_CSV) {
-        long pos = ftell(logger->fp);
-        if (pos == 0) {
-            write_csv_header(logger->fp);
-            logger->wrote_header = 1;
-        }
+    if (logger->format == LOG_FORMAT_CSV && ftell(logger->fp) == 0) {
+        write_csv_header(logger->fp);
+        logger->wrote_header = 1;
     }
 
     return 0;
@@ -114,9 +155,14 @@ void experiment_logger_write(experiment_logger *logger, const experiment_record
         return;
     }
 
+    const char *dtype = record->dtype[0] ? record->dtype : "fp64";
+    const char *placement = record->placement[0] ? record->placement : "default";
+    const char *alloc = record->alloc[0] ? record->alloc : "default";
+    const char *strategy = record->strategy[0] ? record->strategy : "none";
+
     if (logger->format == LOG_FORMAT_CSV) {
         fprintf(logger->fp,
-                "%s,%s,%s,%s,%d,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,%.4f,%s,%.4f,%s\n",
+                "%s,%s,%s,%s,%d,%d,%d,%d,%.6f,%.6f,%.6f,%.6f,%.4f,%s,%.4f,%s,%s,%s,%s,%ld,%s,%s\n",
                 record->timestamp,
                 record->machine_id,
                 record->algo,
@@ -132,6 +178,12 @@ void experiment_logger_write(experiment_logger *logger, const experiment_record
                 record->gflops_gemm_eq,
                 record->passed ? "true" : "false",
                 record->speedup_vs_naive,
+                record->isa,
+                dtype,
+                placement,
+                alloc,
+                record->page_faults,
+                strategy,
                 record->note);
     } else if (logger->format == LOG_FORMAT_JSON) {
         fprintf(logger->fp,
@@ -139,6 +191,8 @@ void experiment_logger_write(experiment_logger *logger, const experiment_record
                 "\"n\":%d,\"nprocs\":%d,\"nthreads\":%d,\"repetitions\":%d,"
                 "\"time_sec\":%.6f,\"time_min\":%.6f,\"time_max\":%.6f,\"time_mean\":%.6f,"
                 "\"gflops_gemm_eq\":%.4f,\"passed\":%s,\"speedup_vs_naive\":%.4f,"
+                "\"isa\":\"%s\",\"dtype\":\"%s\",\"placement\":\"%s\",\"alloc\":\"%s\",\"page_faults\":%ld,"
+                "\"strategy\":\"%s\","
                 "\"note\":\"%s\"}\n",
                 record->timestamp,
                 record->machine_id,
@@ -155,6 +209,12 @@ void experiment_logger_write(experiment_logger *logger, const experiment_record
                 record->gflops_gemm_eq,
                 record->passed ? "true" : "false",
                 record->speedup_vs_naive,
+                record->isa,
+                dtype,
+                placement,
+                alloc,
+                record->page_faults,
+                strategy,
                 record->note);
     }
     fflush(logger->fp);
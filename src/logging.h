@@ -28,7 +28,13 @@ typedef struct {
     double gflops_gemm_eq;
     double speedup_vs_naive;
     int passed;  // 1 = pass, 0 = fail
-    char note[128];
+    char isa[16];        // SIMD kernel variant selected at startup (e.g. "avx2")
+    char dtype[8];       // "fp64", "fp32" or "mixed" ("" is logged as fp64)
+    char placement[32];  // "<numa>:<affinity>" from matrix_placement_name ("" is logged as default)
+    char alloc[24];      // MM_HUGEPAGES mode from mm_alloc_mode_name ("" is logged as default)
+    long page_faults;    // page faults per timed run (mm_page_faults difference)
+    char strategy[16];   // MPI distribution from mpi_strategy_name ("" is logged as none)
+    char note[256];
 } experiment_record;
 
 typedef struct {
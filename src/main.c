@@ -2,7 +2,7 @@
  * main.c
  * Entry point for matrix multiplication parallel computing project
  * Supports: Serial, OpenMP, MPI, Hybrid (MPI+OpenMP)
- * Algorithms: Naive, Strassen, Proposed
+ * Algorithms: Naive, Strassen, Winograd, Proposed
  */
 
 #include <stdio.h>
@@ -10,20 +10,97 @@
 #include <string.h>
 #include <mpi.h>
 #include "kernels.h"
+#include "kernels_f32.h"
+#include "logging.h"
+#include "mpi_grid.h"
 #include "mpi_wrapper.h"
+#include "simd_kernels.h"
+#include "tuning.h"
 #include "utility.h"
 
 void print_usage(const char *prog_name) {
-    printf("Usage: %s <size> <approach> <algorithm>\n", prog_name);
+    printf("Usage: %s <size> <approach> <algorithm> [dtype | strategy]\n", prog_name);
+    printf("       %s tune [size]\n", prog_name);
     printf("\nArguments:\n");
     printf("  size       : Matrix size (N x N)\n");
     printf("  approach   : serial | openmp | mpi | hybrid\n");
-    printf("  algorithm  : naive | strassen | proposed | blas\n");
+    printf("  algorithm  : naive | strassen | winograd | proposed | oblivious | blas\n");
+    printf("  dtype      : fp64 (default) | fp32 | mixed (fp32 storage, fp64\n");
+    printf("               accumulation); fp32: naive, strassen, proposed;\n");
+    printf("               mixed: naive, proposed; serial and openmp only\n");
+    printf("  strategy   : rows (default) | summa | cannon | 2.5d | pipeline; MPI data\n");
+    printf("               distribution for mpi and hybrid (default from MM_MPI_STRATEGY;\n");
+    printf("               2.5d replication from MM_MPI_REPLICATION)\n");
+    printf("  tune       : search block sizes, Strassen cutoffs and micro-kernel for\n");
+    printf("               this host (default size 512) and write the profile for\n");
+    printf("               MACHINE_ID that every run loads at startup\n");
     printf("\nExamples:\n");
     printf("  %s 100 serial naive\n", prog_name);
     printf("  %s 500 openmp strassen\n", prog_name);
+    printf("  %s 2048 openmp proposed fp32\n", prog_name);
     printf("  mpirun -np 4 %s 1000 mpi naive\n", prog_name);
     printf("  mpirun -np 4 %s 1000 hybrid naive\n", prog_name);
+    printf("  mpirun -np 4 %s 4096 mpi proposed summa\n", prog_name);
+    printf("  MACHINE_ID=node-a %s tune 1024\n", prog_name);
+}
+
+// fp32 / mixed kernel for approach+algorithm, or NULL when there is none.
+static kernel_f32_func_t select_kernel_f32(const char *dtype, const char *approach,
+                                           const char *algorithm) {
+    int omp = strcmp(approach, "openmp") == 0;
+    if (!omp && strcmp(approach, "serial") != 0) {
+        return NULL;
+    }
+    if (strcmp(dtype, "fp32") == 0) {
+        if (strcmp(algorithm, "naive") == 0) return omp ? matmul_omp_f32 : matmul_serial_f32;
+        if (strcmp(algorithm, "strassen") == 0) return omp ? strassen_omp_f32 : strassen_serial_f32;
+        if (strcmp(algorithm, "proposed") == 0) return omp ? proposed_omp_f32 : proposed_serial_f32;
+    } else if (strcmp(dtype, "mixed") == 0) {
+        if (strcmp(algorithm, "naive") == 0) return omp ? matmul_omp_mixed : matmul_serial_mixed;
+        if (strcmp(algorithm, "proposed") == 0) return omp ? proposed_omp_mixed : proposed_serial_mixed;
+    }
+    return NULL;
+}
+
+// Autotune on rank 0 and write the profile; other ranks only wait.
+static int run_tune(int argc, char **argv, int rank) {
+    int n = (argc >= 3) ? atoi(argv[2]) : 512;
+    if (n <= 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Error: Matrix size must be positive\n");
+        }
+        return 1;
+    }
+
+    int status = 0;
+    if (rank == 0) {
+        char path[512];
+        mm_tuning_profile_path(path, sizeof(path));
+
+        printf("=================================================\n");
+        printf("Autotuning on %d x %d (MACHINE_ID=%s)\n", n, n, mm_get_machine_id());
+        printf("Starting from  : %s\n", mm_tuning_source());
+        printf("=================================================\n");
+
+        mm_tuning_params best;
+        mm_tuning_search(n, 1, &best);
+
+        printf("=================================================\n");
+        printf("isa=%s mc=%d kc=%d nc=%d\n", best.isa, best.mc, best.kc, best.nc);
+        printf("strassen_threshold=%d strassen_threshold_omp=%d strassen_parallel_cutoff=%d\n",
+               best.strassen_threshold, best.strassen_threshold_omp,
+               best.strassen_parallel_cutoff);
+        if (mm_tuning_save(path, &best) == 0) {
+            printf("Profile written: %s\n", path);
+        } else {
+            fprintf(stderr, "Error: could not write tuning profile '%s'\n", path);
+            status = 1;
+        }
+        printf("=================================================\n");
+    }
+
+    MPI_Bcast(&status, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    return status;
 }
 
 int main(int argc, char **argv) {
@@ -35,8 +112,14 @@ int main(int argc, char **argv) {
     rank = mpi_get_rank();
     size = mpi_get_size();
     
+    if (argc >= 2 && strcmp(argv[1], "tune") == 0) {
+        int status = run_tune(argc, argv, rank);
+        mpi_finalize();
+        return status;
+    }
+    
     // Parse arguments
-    if (argc != 4) {
+    if (argc != 4 && argc != 5) {
         if (rank == 0) {
             print_usage(argv[0]);
         }
@@ -46,7 +129,23 @@ int main(int argc, char **argv) {
      
     int n = atoi(argv[1]); // size of matrix
     char *approach = argv[2]; // name of approach (serial, openmp, mpi, hybrid)
-    char *algorithm = argv[3]; // name of algorithm (naive, strassen, proposed)
+    char *algorithm = argv[3]; // name of algorithm (naive, strassen, winograd, proposed, oblivious)
+    const char *dtype = "fp64"; // storage/compute precision
+    mm_mpi_strategy strategy = mpi_strategy_default(); // MPI data distribution
+    if (argc == 5) {
+        int parsed = mpi_strategy_parse(argv[4]);
+        if (parsed < 0) {
+            dtype = argv[4];
+        } else if (strcmp(approach, "mpi") == 0 || strcmp(approach, "hybrid") == 0) {
+            strategy = (mm_mpi_strategy)parsed;
+        } else {
+            if (rank == 0) {
+                fprintf(stderr, "Error: strategy '%s' applies to mpi and hybrid only\n", argv[4]);
+            }
+            mpi_finalize();
+            return 1;
+        }
+    }
     
     // Validate input
     if (n <= 0) {
@@ -57,6 +156,27 @@ int main(int argc, char **argv) {
         return 1;
     }
     
+    int use_f32 = strcmp(dtype, "fp64") != 0;
+    kernel_f32_func_t kernel_f32 = NULL;
+    if (use_f32) {
+        if (strcmp(dtype, "fp32") != 0 && strcmp(dtype, "mixed") != 0) {
+            if (rank == 0) {
+                fprintf(stderr, "Error: Unknown dtype '%s'\n", dtype);
+            }
+            mpi_finalize();
+            return 1;
+        }
+        kernel_f32 = select_kernel_f32(dtype, approach, algorithm);
+        if (!kernel_f32) {
+            if (rank == 0) {
+                fprintf(stderr, "Error: %s %s is not available in %s\n",
+                        approach, algorithm, dtype);
+            }
+            mpi_finalize();
+            return 1;
+        }
+    }
+    
     // Print configuration (rank 0 only)
     if (rank == 0) {
         printf("=================================================\n");
@@ -65,7 +185,37 @@ int main(int argc, char **argv) {
         printf("Matrix size    : %d x %d\n", n, n);
         printf("Approach       : %s\n", approach);
         printf("Algorithm      : %s\n", algorithm);
+        printf("Precision      : %s\n", dtype);
         printf("MPI processes  : %d\n", size);
+        if (strcmp(approach, "mpi") == 0 || strcmp(approach, "hybrid") == 0) {
+            int q = mm_proc_grid_square(size);
+            if (strategy == MM_MPI_SUMMA || (strategy == MM_MPI_CANNON && q == 0)) {
+                int pr, pc;
+                mm_proc_grid_dims(size, &pr, &pc);
+                printf("MPI strategy   : summa (%d x %d grid)\n", pr, pc);
+            } else if (strategy == MM_MPI_CANNON) {
+                printf("MPI strategy   : cannon (%d x %d grid)\n", q, q);
+            } else if (strategy == MM_MPI_25D) {
+                int c = mm_25d_replication(size);
+                int q25 = c ? mm_proc_grid_square(size / c) : 0;
+                if (c) {
+                    printf("MPI strategy   : 2.5d (%d x %d x %d grid, c=%d)\n", q25, q25, c, c);
+                } else {
+                    printf("MPI strategy   : 2.5d (no q*q*c shape, runs summa)\n");
+                }
+            } else {
+                printf("MPI strategy   : %s\n", mpi_strategy_name(strategy));
+            }
+        }
+        printf("SIMD kernels   : %s\n", simd_isa_name());
+        printf("Tuning profile : %s\n", mm_tuning_source());
+        const mm_cache_sizes *caches = mm_caches();
+        const mm_tuning_params *tune = mm_tuning();
+        printf("Cache sizes    : L1d=%ldK L2=%ldK L3=%ldK (%s)\n",
+               caches->l1d / 1024, caches->l2 / 1024, caches->l3 / 1024, caches->origin);
+        printf("Blocking       : mc=%d kc=%d nc=%d\n", tune->mc, tune->kc, tune->nc);
+        printf("Placement      : %s\n", matrix_placement_name());
+        printf("Huge pages     : %s\n", mm_alloc_mode_name());
         printf("=================================================\n\n");
     }
     
@@ -109,8 +259,12 @@ int main(int argc, char **argv) {
             kernel = matmul_serial;
         } else if (strcmp(algorithm, "strassen") == 0) {
             kernel = strassen_serial;
+        } else if (strcmp(algorithm, "winograd") == 0) {
+            kernel = winograd_serial;
         } else if (strcmp(algorithm, "proposed") == 0) {
             kernel = proposed_serial;
+        } else if (strcmp(algorithm, "oblivious") == 0) {
+            kernel = oblivious_serial;
         } else if (strcmp(algorithm, "blas") == 0 && strcmp(approach, "serial") == 0) {
             if (!matmul_blas_available()) {
                 if (rank == 0) {
@@ -133,8 +287,12 @@ int main(int argc, char **argv) {
             kernel = matmul_omp;
         } else if (strcmp(algorithm, "strassen") == 0) {
             kernel = strassen_omp;
+        } else if (strcmp(algorithm, "winograd") == 0) {
+            kernel = winograd_omp;
         } else if (strcmp(algorithm, "proposed") == 0) {
             kernel = proposed_omp;
+        } else if (strcmp(algorithm, "oblivious") == 0) {
+            kernel = oblivious_omp;
         } else if (strcmp(algorithm, "blas") == 0) {
             if (rank == 0) {
                 fprintf(stderr, "Error: BLAS baseline is available only in serial mode\n");
@@ -156,12 +314,35 @@ int main(int argc, char **argv) {
         return 1;
     }
     
+    // fp32 storage: round the operands once; A and B keep the rounded values
+    // so the fp64 reference below checks the kernel, not the rounding.
+    float *A32 = NULL, *B32 = NULL, *C32 = NULL;
+    if (use_f32 && rank == 0) {
+        A32 = matrix_allocate_f32(n);
+        B32 = matrix_allocate_f32(n);
+        C32 = matrix_allocate_f32(n);
+        if (!A32 || !B32 || !C32) {
+            fprintf(stderr, "Error: Failed to allocate fp32 matrices\n");
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        matrix_to_f32(A, A32, n);
+        matrix_to_f32(B, B32, n);
+        matrix_from_f32(A32, A, n);
+        matrix_from_f32(B32, B, n);
+    }
+    
     // Synchronize before timing
     MPI_Barrier(MPI_COMM_WORLD);
+    long faults_before = mm_page_faults();
     start_time = MPI_Wtime();
     
     // Execute based on approach
-    if (strcmp(approach, "serial") == 0) {
+    if (use_f32) {
+        // fp32 / mixed kernels (serial or OpenMP, rank 0 only)
+        if (rank == 0) {
+            kernel_f32(A32, B32, C32, n);
+        }
+    } else if (strcmp(approach, "serial") == 0) {
         // Serial execution (only rank 0)
         if (rank == 0) {
             kernel(A, B, C, n);
@@ -173,19 +354,23 @@ int main(int argc, char **argv) {
         }
     } else if (strcmp(approach, "mpi") == 0) {
         // MPI distributed execution
-        mpi_matmul_master_worker(A, B, C, n, kernel);
+        mpi_matmul(strategy, A, B, C, n, kernel);
     } else if (strcmp(approach, "hybrid") == 0) {
         // Hybrid MPI + OpenMP
-        mpi_matmul_master_worker(A, B, C, n, kernel);
+        mpi_matmul(strategy, A, B, C, n, kernel);
     }
     
     // Synchronize after computation
     MPI_Barrier(MPI_COMM_WORLD);
     end_time = MPI_Wtime();
+    long page_faults = mm_page_faults() - faults_before;
     
     // Print results (rank 0 only)
     if (rank == 0) {
         double elapsed = end_time - start_time;
+        if (use_f32) {
+            matrix_from_f32(C32, C, n);
+        }
         
         printf("\n=================================================\n");
         printf("Computation completed!\n");
@@ -193,6 +378,7 @@ int main(int argc, char **argv) {
         printf("Elapsed time   : %.6f seconds\n", elapsed);
         printf("Performance    : %.2f GFLOPS\n", 
                (2.0 * n * n * n) / (elapsed * 1e9));
+        printf("Page faults    : %ld (rank 0; allocation %s)\n", page_faults, mm_alloc_mode_name());
         printf("=================================================\n\n");
         
         // Print result matrix if small
@@ -203,7 +389,7 @@ int main(int argc, char **argv) {
         }
         
         // Verify correctness by comparing with serial naive
-        if (strcmp(approach, "serial") == 0 && strcmp(algorithm, "naive") == 0) {
+        if (strcmp(approach, "serial") == 0 && strcmp(algorithm, "naive") == 0 && !use_f32) {
             printf("Baseline (serial naive) - no verification needed.\n");
         } else {
             printf("Computing reference result for verification...\n");
@@ -217,7 +403,9 @@ int main(int argc, char **argv) {
             printf("Reference computed in %.6f seconds\n", ref_end - ref_start);
             
             // Compare results
-            if (matrix_compare(C, C_ref, n, 1e-6)) {
+            int ok = use_f32 ? matrix_compare_f32(C32, C_ref, n, 1e-4)
+                             : matrix_compare(C, C_ref, n, 1e-6);
+            if (ok) {
                 printf("✓ CORRECTNESS CHECK PASSED\n");
             } else {
                 printf("✗ CORRECTNESS CHECK FAILED\n");
@@ -236,6 +424,9 @@ int main(int argc, char **argv) {
     }
     
     // Cleanup
+    matrix_free_f32(A32);
+    matrix_free_f32(B32);
+    matrix_free_f32(C32);
     if (rank == 0) {
         if (A) matrix_free(A);
         if (C) matrix_free(C);
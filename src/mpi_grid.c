@@ -0,0 +1,713 @@
+// mpi_grid.c
+// 2D process grids and grid-distributed GEMM (see mpi_grid.h).
+
+#include "mpi_grid.h"
+#include "utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MM_SUMMA_PANEL_DEFAULT 256
+
+// Per-phase wall time of this rank, accumulated across calls
+static mm_grid_phase_stats phase_stats;
+
+void mm_grid_phase_stats_reset(void) {
+    memset(&phase_stats, 0, sizeof(phase_stats));
+}
+
+void mm_grid_phase_stats_get(mm_grid_phase_stats *stats) {
+    *stats = phase_stats;
+}
+
+void mm_proc_grid_dims(int nprocs, int *pr, int *pc) {
+    const char *spec = getenv("MM_MPI_GRID");
+    int r = 0;
+    int c = 0;
+    if (spec && *spec) {
+        if (sscanf(spec, "%dx%d", &r, &c) == 2 && r > 0 && c > 0 && r * c == nprocs) {
+            *pr = r;
+            *pc = c;
+            return;
+        }
+        if (mpi_get_rank() == 0) {
+            fprintf(stderr, "Warning: MM_MPI_GRID '%s' does not match %d ranks, "
+                            "using a square-ish grid\n", spec, nprocs);
+        }
+    }
+
+    int dims[2] = {0, 0};
+    MPI_Dims_create(nprocs, 2, dims);
+    *pr = dims[0];
+    *pc = dims[1];
+}
+
+int mm_proc_grid_create(MPI_Comm comm, int pr, int pc, mm_proc_grid *grid) {
+    int size = 0;
+    MPI_Comm_size(comm, &size);
+    if (pr <= 0 || pc <= 0 || pr * pc != size) {
+        return -1;
+    }
+
+    int dims[2] = {pr, pc};
+    int periods[2] = {1, 1};
+    MPI_Cart_create(comm, 2, dims, periods, 0, &grid->comm);
+
+    int rank = 0;
+    int coords[2] = {0, 0};
+    MPI_Comm_rank(grid->comm, &rank);
+    MPI_Cart_coords(grid->comm, rank, 2, coords);
+    grid->pr = pr;
+    grid->pc = pc;
+    grid->row = coords[0];
+    grid->col = coords[1];
+
+    int keep_cols[2] = {0, 1};
+    int keep_rows[2] = {1, 0};
+    MPI_Cart_sub(grid->comm, keep_cols, &grid->row_comm);
+    MPI_Cart_sub(grid->comm, keep_rows, &grid->col_comm);
+    return 0;
+}
+
+void mm_proc_grid_free(mm_proc_grid *grid) {
+    MPI_Comm_free(&grid->row_comm);
+    MPI_Comm_free(&grid->col_comm);
+    MPI_Comm_free(&grid->comm);
+}
+
+void mm_block_range(int n, int parts, int idx, int *start, int *len) {
+    int base = n / parts;
+    int remainder = n % parts;
+    *start = idx * base + (idx < remainder ? idx : remainder);
+    *len = base + (idx < remainder ? 1 : 0);
+}
+
+// Block that holds index i of a dimension of n split into parts blocks.
+static int block_owner(int n, int parts, int i) {
+    int base = n / parts;
+    int remainder = n % parts;
+    int split = remainder * (base + 1);
+    if (i < split) return i / (base + 1);
+    return remainder + (i - split) / base;
+}
+
+// Block of grid rank r (rank = row * pc + col).
+static void grid_block(const mm_proc_grid *grid, int n, int r,
+                       int *row0, int *rows, int *col0, int *cols) {
+    mm_block_range(n, grid->pr, r / grid->pc, row0, rows);
+    mm_block_range(n, grid->pc, r % grid->pc, col0, cols);
+}
+
+// Per-rank element counts and offsets of the packed staging buffer, in
+// grid rank order.
+static void grid_counts(const mm_proc_grid *grid, int n, int *counts, int *displs) {
+    int offset = 0;
+    for (int r = 0; r < grid->pr * grid->pc; r++) {
+        int row0, rows, col0, cols;
+        grid_block(grid, n, r, &row0, &rows, &col0, &cols);
+        counts[r] = rows * cols;
+        displs[r] = offset;
+        offset += counts[r];
+    }
+}
+
+// Copy every rank's block between the row-major matrix and the staging
+// buffer (to_blocks: M -> staging).
+static void grid_pack(const mm_proc_grid *grid, int n, double *M, double *staging,
+                      const int *displs, int to_blocks) {
+    for (int r = 0; r < grid->pr * grid->pc; r++) {
+        int row0, rows, col0, cols;
+        grid_block(grid, n, r, &row0, &rows, &col0, &cols);
+        for (int i = 0; i < rows; i++) {
+            double *m_row = &M[(size_t)(row0 + i) * n + col0];
+            double *s_row = &staging[displs[r] + (size_t)i * cols];
+            if (to_blocks) {
+                memcpy(s_row, m_row, (size_t)cols * sizeof(double));
+            } else {
+                memcpy(m_row, s_row, (size_t)cols * sizeof(double));
+            }
+        }
+    }
+}
+
+static void grid_local_shape(const mm_proc_grid *grid, int n, int *rows, int *cols) {
+    int start;
+    mm_block_range(n, grid->pr, grid->row, &start, rows);
+    mm_block_range(n, grid->pc, grid->col, &start, cols);
+}
+
+// Root-side metadata and staging for scatter / gather; aborts on failure.
+static double *grid_staging(const mm_proc_grid *grid, int n, int **counts, int **displs) {
+    int nprocs = grid->pr * grid->pc;
+    *counts = (int *)malloc((size_t)nprocs * sizeof(int));
+    *displs = (int *)malloc((size_t)nprocs * sizeof(int));
+    double *staging = (double *)mm_aligned_alloc((size_t)n * n * sizeof(double));
+    if (!*counts || !*displs || !staging) {
+        fprintf(stderr, "Root: failed to allocate grid staging buffer\n");
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    grid_counts(grid, n, *counts, *displs);
+    return staging;
+}
+
+void mm_grid_scatter(const mm_proc_grid *grid, int n, const double *M, double *local) {
+    int rank = 0;
+    MPI_Comm_rank(grid->comm, &rank);
+    int rows, cols;
+    grid_local_shape(grid, n, &rows, &cols);
+
+    int *counts = NULL;
+    int *displs = NULL;
+    double *staging = NULL;
+    if (rank == 0) {
+        staging = grid_staging(grid, n, &counts, &displs);
+        grid_pack(grid, n, (double *)M, staging, displs, 1);
+    }
+    MPI_Scatterv(staging, counts, displs, MPI_DOUBLE,
+                 local, rows * cols, MPI_DOUBLE, 0, grid->comm);
+    if (rank == 0) {
+        mm_aligned_free(staging);
+        free(counts);
+        free(displs);
+    }
+}
+
+void mm_grid_gather(const mm_proc_grid *grid, int n, const double *local, double *M) {
+    int rank = 0;
+    MPI_Comm_rank(grid->comm, &rank);
+    int rows, cols;
+    grid_local_shape(grid, n, &rows, &cols);
+
+    int *counts = NULL;
+    int *displs = NULL;
+    double *staging = NULL;
+    if (rank == 0) {
+        staging = grid_staging(grid, n, &counts, &displs);
+    }
+    MPI_Gatherv(local, rows * cols, MPI_DOUBLE,
+                staging, counts, displs, MPI_DOUBLE, 0, grid->comm);
+    if (rank == 0) {
+        grid_pack(grid, n, M, staging, displs, 0);
+        mm_aligned_free(staging);
+        free(counts);
+        free(displs);
+    }
+}
+
+static int summa_panel_width(void) {
+    const char *value = getenv("MM_SUMMA_PANEL");
+    if (value && *value) {
+        int width = atoi(value);
+        if (width > 0) return width;
+    }
+    return MM_SUMMA_PANEL_DEFAULT;
+}
+
+// One k panel in flight: its range and the buffers its broadcasts use (the
+// owner of the B slice sends straight from its block).
+typedef struct {
+    int k0;
+    int width;
+    double *a;
+    double *b;
+    MPI_Request req[2];
+} summa_panel;
+
+static void summa_post(const mm_proc_grid *grid, int n, int k0, int max_width,
+                       const double *local_A, const double *local_B,
+                       int rows, int cols, double *a_buf, double *b_buf, summa_panel *p) {
+    int a_owner = block_owner(n, grid->pc, k0);
+    int b_owner = block_owner(n, grid->pr, k0);
+    int a_start, a_len, b_start, b_len;
+    mm_block_range(n, grid->pc, a_owner, &a_start, &a_len);
+    mm_block_range(n, grid->pr, b_owner, &b_start, &b_len);
+
+    int width = max_width;
+    if (a_start + a_len - k0 < width) width = a_start + a_len - k0;
+    if (b_start + b_len - k0 < width) width = b_start + b_len - k0;
+    p->k0 = k0;
+    p->width = width;
+
+    // A's panel columns are strided in the owner's block: pack them
+    p->a = a_buf;
+    if (grid->col == a_owner) {
+        for (int i = 0; i < rows; i++) {
+            memcpy(&a_buf[(size_t)i * width], &local_A[(size_t)i * cols + (k0 - a_start)],
+                   (size_t)width * sizeof(double));
+        }
+    }
+    // B's panel rows are contiguous in the owner's block
+    p->b = (grid->row == b_owner) ? (double *)&local_B[(size_t)(k0 - b_start) * cols] : b_buf;
+
+    MPI_Ibcast(p->a, rows * width, MPI_DOUBLE, a_owner, grid->row_comm, &p->req[0]);
+    MPI_Ibcast(p->b, width * cols, MPI_DOUBLE, b_owner, grid->col_comm, &p->req[1]);
+}
+
+void mm_summa(const mm_proc_grid *grid, int n, kernel_func_t kernel,
+              const double *local_A, const double *local_B, double *local_C) {
+    int rows, cols;
+    grid_local_shape(grid, n, &rows, &cols);
+    int max_width = summa_panel_width();
+    if (max_width > n) max_width = n;
+
+    // Two panel buffers each for A and B; an empty block still takes part
+    // in the broadcasts with zero-length messages
+    size_t a_elems = (size_t)rows * max_width;
+    size_t b_elems = (size_t)max_width * cols;
+    double *buffers = (double *)mm_aligned_alloc((2 * (a_elems + b_elems) + 1) * sizeof(double));
+    if (!buffers) {
+        fprintf(stderr, "Rank %d: failed to allocate SUMMA panels\n", mpi_get_rank());
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    double *a_buf[2] = {buffers, buffers + a_elems};
+    double *b_buf[2] = {buffers + 2 * a_elems, buffers + 2 * a_elems + b_elems};
+
+    summa_panel panels[2];
+    int cur = 0;
+    summa_post(grid, n, 0, max_width, local_A, local_B, rows, cols,
+               a_buf[0], b_buf[0], &panels[0]);
+    for (;;) {
+        summa_panel *p = &panels[cur];
+        double t0 = MPI_Wtime();
+        MPI_Waitall(2, p->req, MPI_STATUSES_IGNORE);
+        phase_stats.shift += MPI_Wtime() - t0;
+
+        int next_k0 = p->k0 + p->width;
+        if (next_k0 < n) {
+            summa_post(grid, n, next_k0, max_width, local_A, local_B, rows, cols,
+                       a_buf[1 - cur], b_buf[1 - cur], &panels[1 - cur]);
+        }
+        t0 = MPI_Wtime();
+        mpi_local_gemm(kernel, rows, cols, p->width, p->a, p->width, p->b, cols,
+                       local_C, cols, p->k0 > 0);
+        phase_stats.compute += MPI_Wtime() - t0;
+        if (next_k0 >= n) break;
+        cur = 1 - cur;
+    }
+
+    mm_aligned_free(buffers);
+}
+
+// Cannon's algorithm on a q x q grid: after the skew, rank (i, j) holds A
+// block (i, k) and B block (k, j) with k = (i + j + step) mod q; each step
+// multiplies them and passes A one rank left and B one rank up. Runs steps
+// [first, first + steps) of the q, so a 2.5D layer can take its share.
+static void cannon_steps(const mm_proc_grid *grid, int n, kernel_func_t kernel,
+                         const double *local_A, const double *local_B, double *local_C,
+                         int first, int steps) {
+    int q = grid->pr;
+    int rows, cols;
+    grid_local_shape(grid, n, &rows, &cols);
+    if (q != grid->pc) {
+        fprintf(stderr, "Rank %d: Cannon needs a square grid (%dx%d)\n",
+                mpi_get_rank(), grid->pr, grid->pc);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    if (q == 1) {
+        double t0 = MPI_Wtime();
+        mpi_local_gemm(kernel, rows, cols, n, local_A, cols, local_B, cols, local_C, cols, 0);
+        phase_stats.compute += MPI_Wtime() - t0;
+        return;
+    }
+
+    // Blocks along k differ by at most one row / column; size the two
+    // buffers of each operand for the largest
+    int max_len = n / q + (n % q ? 1 : 0);
+    size_t a_elems = (size_t)rows * max_len;
+    size_t b_elems = (size_t)max_len * cols;
+    double *buffers = (double *)mm_aligned_alloc((2 * (a_elems + b_elems) + 1) * sizeof(double));
+    if (!buffers) {
+        fprintf(stderr, "Rank %d: failed to allocate Cannon blocks\n", mpi_get_rank());
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    double *a_buf[2] = {buffers, buffers + a_elems};
+    double *b_buf[2] = {buffers + 2 * a_elems, buffers + 2 * a_elems + b_elems};
+
+    // Initial skew: A row i moves i + first ranks left, B column j moves
+    // j + first ranks up
+    double t0 = MPI_Wtime();
+    int k_idx = (grid->row + grid->col + first) % q;
+    int k0, k_len;
+    mm_block_range(n, q, k_idx, &k0, &k_len);
+    int src, dst;
+    MPI_Cart_shift(grid->comm, 1, -((grid->row + first) % q), &src, &dst);
+    MPI_Sendrecv(local_A, rows * cols, MPI_DOUBLE, dst, 1,
+                 a_buf[0], rows * k_len, MPI_DOUBLE, src, 1, grid->comm, MPI_STATUS_IGNORE);
+    MPI_Cart_shift(grid->comm, 0, -((grid->col + first) % q), &src, &dst);
+    MPI_Sendrecv(local_B, rows * cols, MPI_DOUBLE, dst, 2,
+                 b_buf[0], k_len * cols, MPI_DOUBLE, src, 2, grid->comm, MPI_STATUS_IGNORE);
+    phase_stats.skew += MPI_Wtime() - t0;
+
+    int left, right, up, down;
+    MPI_Cart_shift(grid->comm, 1, -1, &right, &left);
+    MPI_Cart_shift(grid->comm, 0, -1, &down, &up);
+
+    // The next blocks travel while the current product runs
+    int cur = 0;
+    for (int step = 0; step < steps; step++) {
+        MPI_Request req[4];
+        int pending = 0;
+        if (step + 1 < steps) {
+            int next_start, next_len;
+            mm_block_range(n, q, (k_idx + 1) % q, &next_start, &next_len);
+            MPI_Irecv(a_buf[1 - cur], rows * next_len, MPI_DOUBLE, right, 1, grid->comm, &req[0]);
+            MPI_Irecv(b_buf[1 - cur], next_len * cols, MPI_DOUBLE, down, 2, grid->comm, &req[1]);
+            MPI_Isend(a_buf[cur], rows * k_len, MPI_DOUBLE, left, 1, grid->comm, &req[2]);
+            MPI_Isend(b_buf[cur], k_len * cols, MPI_DOUBLE, up, 2, grid->comm, &req[3]);
+            pending = 4;
+        }
+
+        t0 = MPI_Wtime();
+        mpi_local_gemm(kernel, rows, cols, k_len, a_buf[cur], k_len, b_buf[cur], cols,
+                       local_C, cols, step > 0);
+        double t1 = MPI_Wtime();
+        phase_stats.compute += t1 - t0;
+
+        if (pending) {
+            MPI_Waitall(pending, req, MPI_STATUSES_IGNORE);
+            phase_stats.shift += MPI_Wtime() - t1;
+            k_idx = (k_idx + 1) % q;
+            mm_block_range(n, q, k_idx, &k0, &k_len);
+            cur = 1 - cur;
+        }
+    }
+
+    mm_aligned_free(buffers);
+}
+
+void mm_cannon(const mm_proc_grid *grid, int n, kernel_func_t kernel,
+               const double *local_A, const double *local_B, double *local_C) {
+    cannon_steps(grid, n, kernel, local_A, local_B, local_C, 0, grid->pr);
+}
+
+int mm_proc_grid_square(int nprocs) {
+    int q = 1;
+    while ((q + 1) * (q + 1) <= nprocs) q++;
+    return (q * q == nprocs) ? q : 0;
+}
+
+typedef void (*grid_algorithm_t)(const mm_proc_grid *grid, int n, kernel_func_t kernel,
+                                 const double *local_A, const double *local_B,
+                                 double *local_C);
+
+// Shared driver of the grid strategies: scatter A and B as blocks from
+// rank 0, run the algorithm on a pr x pc grid, gather C.
+static void grid_matmul(grid_algorithm_t algorithm, int pr, int pc,
+                        double *A, double *B, double *C, int n, kernel_func_t kernel) {
+    mm_proc_grid grid;
+    if (mm_proc_grid_create(MPI_COMM_WORLD, pr, pc, &grid) != 0) {
+        fprintf(stderr, "Rank %d: cannot build a %dx%d grid, using row slabs\n",
+                mpi_get_rank(), pr, pc);
+        mpi_matmul_master_worker(A, B, C, n, kernel);
+        return;
+    }
+
+    int rows, cols;
+    grid_local_shape(&grid, n, &rows, &cols);
+    size_t local_elems = (size_t)rows * cols;
+    double *local = NULL;
+    if (local_elems > 0) {
+        local = (double *)mm_aligned_alloc(3 * local_elems * sizeof(double));
+        if (!local) {
+            fprintf(stderr, "Rank %d: failed to allocate local blocks\n", mpi_get_rank());
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        // Place the blocks on the nodes of the threads that compute them
+        // (hybrid mode) before MPI writes into them
+        matrix_first_touch(local, 3 * (size_t)rows, (size_t)cols);
+    }
+    double *local_A = local;
+    double *local_B = local ? local + local_elems : NULL;
+    double *local_C = local ? local + 2 * local_elems : NULL;
+
+    double t0 = MPI_Wtime();
+    mm_grid_scatter(&grid, n, A, local_A);
+    mm_grid_scatter(&grid, n, B, local_B);
+    phase_stats.scatter += MPI_Wtime() - t0;
+    algorithm(&grid, n, kernel, local_A, local_B, local_C);
+    t0 = MPI_Wtime();
+    mm_grid_gather(&grid, n, local_C, C);
+    phase_stats.gather += MPI_Wtime() - t0;
+    phase_stats.replication = 1;
+    phase_stats.calls++;
+
+    mm_aligned_free(local);
+    mm_proc_grid_free(&grid);
+}
+
+void mpi_matmul_summa(double *A, double *B, double *C, int n, kernel_func_t kernel) {
+    int pr, pc;
+    mm_proc_grid_dims(mpi_get_size(), &pr, &pc);
+    grid_matmul(mm_summa, pr, pc, A, B, C, n, kernel);
+}
+
+void mpi_matmul_cannon(double *A, double *B, double *C, int n, kernel_func_t kernel) {
+    int q = mm_proc_grid_square(mpi_get_size());
+    if (q == 0) {
+        if (mpi_get_rank() == 0) {
+            fprintf(stderr, "Warning: Cannon needs a square number of ranks (%d), using SUMMA\n",
+                    mpi_get_size());
+        }
+        mpi_matmul_summa(A, B, C, n, kernel);
+        return;
+    }
+    grid_matmul(mm_cannon, q, q, A, B, C, n, kernel);
+}
+
+int mm_25d_replication(int nprocs) {
+    const char *value = getenv("MM_MPI_REPLICATION");
+    if (value && *value) {
+        int c = atoi(value);
+        int q = (c > 0 && nprocs % c == 0) ? mm_proc_grid_square(nprocs / c) : 0;
+        if (q > 0 && c <= q) return c;
+        if (mpi_get_rank() == 0) {
+            fprintf(stderr, "Warning: MM_MPI_REPLICATION '%s' does not fit %d ranks "
+                            "(needs P = q*q*c with c <= q), choosing c\n", value, nprocs);
+        }
+    }
+    // Largest c <= cbrt(P) with P / c a perfect square
+    for (int c = nprocs; c >= 1; c--) {
+        if (nprocs % c != 0) continue;
+        int q = mm_proc_grid_square(nprocs / c);
+        if (q > 0 && c <= q) return c;
+    }
+    return 0;
+}
+
+void mpi_matmul_25d(double *A, double *B, double *C, int n, kernel_func_t kernel) {
+    int size = mpi_get_size();
+    int rank = mpi_get_rank();
+    int c = mm_25d_replication(size);
+    if (c == 0) {
+        if (rank == 0) {
+            fprintf(stderr, "Warning: 2.5D needs P = q*q*c ranks (%d), using SUMMA\n", size);
+        }
+        mpi_matmul_summa(A, B, C, n, kernel);
+        return;
+    }
+    int q = mm_proc_grid_square(size / c);
+
+    // World rank = (i * q + j) * c + layer: the c copies of a block sit on
+    // consecutive ranks, so replication and reduction stay on-node when
+    // the launcher fills nodes in rank order
+    int layer = rank % c;
+    int pos = rank / c;
+    MPI_Comm layer_comm, fiber_comm;
+    MPI_Comm_split(MPI_COMM_WORLD, layer, pos, &layer_comm);
+    MPI_Comm_split(MPI_COMM_WORLD, pos, layer, &fiber_comm);
+    mm_proc_grid grid;
+    mm_proc_grid_create(layer_comm, q, q, &grid);
+
+    int rows, cols;
+    grid_local_shape(&grid, n, &rows, &cols);
+    size_t local_elems = (size_t)rows * cols;
+    double *local = NULL;
+    if (local_elems > 0) {
+        local = (double *)mm_aligned_alloc(3 * local_elems * sizeof(double));
+        if (!local) {
+            fprintf(stderr, "Rank %d: failed to allocate local blocks\n", rank);
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        matrix_first_touch(local, 3 * (size_t)rows, (size_t)cols);
+    }
+    double *local_A = local;
+    double *local_B = local ? local + local_elems : NULL;
+    double *local_C = local ? local + 2 * local_elems : NULL;
+
+    // Layer 0 receives the blocks from rank 0 and replicates them to the
+    // other layers
+    double t0 = MPI_Wtime();
+    if (layer == 0) {
+        mm_grid_scatter(&grid, n, A, local_A);
+        mm_grid_scatter(&grid, n, B, local_B);
+    }
+    double t1 = MPI_Wtime();
+    phase_stats.scatter += t1 - t0;
+    if (c > 1) {
+        MPI_Bcast(local_A, (int)local_elems, MPI_DOUBLE, 0, fiber_comm);
+        MPI_Bcast(local_B, (int)local_elems, MPI_DOUBLE, 0, fiber_comm);
+    }
+    phase_stats.replicate += MPI_Wtime() - t1;
+
+    // Layer l runs Cannon steps [l * q / c, (l + 1) * q / c)
+    int first = layer * q / c;
+    int steps = (layer + 1) * q / c - first;
+    cannon_steps(&grid, n, kernel, local_A, local_B, local_C, first, steps);
+
+    // Sum the layers' partial C blocks on layer 0, which returns C to rank 0
+    t0 = MPI_Wtime();
+    if (c > 1) {
+        MPI_Reduce(layer == 0 ? MPI_IN_PLACE : local_C, local_C, (int)local_elems,
+                   MPI_DOUBLE, MPI_SUM, 0, fiber_comm);
+    }
+    t1 = MPI_Wtime();
+    phase_stats.reduce += t1 - t0;
+    if (layer == 0) {
+        mm_grid_gather(&grid, n, local_C, C);
+    }
+    phase_stats.gather += MPI_Wtime() - t1;
+    phase_stats.replication = c;
+    phase_stats.calls++;
+
+    mm_aligned_free(local);
+    mm_proc_grid_free(&grid);
+    MPI_Comm_free(&layer_comm);
+    MPI_Comm_free(&fiber_comm);
+}
+
+// ========== Distributed-resident matrices ==========
+
+void mm_dist_create(const mm_proc_grid *grid, int n, mm_dist_matrix *M) {
+    int rank = 0;
+    MPI_Comm_rank(grid->comm, &rank);
+    M->grid = grid;
+    M->n = n;
+    grid_block(grid, n, rank, &M->row0, &M->rows, &M->col0, &M->cols);
+    M->local = NULL;
+
+    size_t elems = (size_t)M->rows * M->cols;
+    if (elems == 0) return;
+    M->local = (double *)mm_aligned_alloc(elems * sizeof(double));
+    if (!M->local) {
+        fprintf(stderr, "Rank %d: failed to allocate a %dx%d distributed block\n",
+                mpi_get_rank(), M->rows, M->cols);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    matrix_first_touch(M->local, (size_t)M->rows, (size_t)M->cols);
+    memset(M->local, 0, elems * sizeof(double));
+}
+
+void mm_dist_free(mm_dist_matrix *M) {
+    mm_aligned_free(M->local);
+    M->local = NULL;
+}
+
+void mm_dist_scatter(mm_dist_matrix *M, const double *full) {
+    double t0 = MPI_Wtime();
+    mm_grid_scatter(M->grid, M->n, full, M->local);
+    phase_stats.scatter += MPI_Wtime() - t0;
+}
+
+void mm_dist_gather(const mm_dist_matrix *M, double *full) {
+    double t0 = MPI_Wtime();
+    mm_grid_gather(M->grid, M->n, M->local, full);
+    phase_stats.gather += MPI_Wtime() - t0;
+}
+
+static int dist_same_shape(const mm_dist_matrix *X, const mm_dist_matrix *Y) {
+    return X->n == Y->n && X->grid->pr == Y->grid->pr && X->grid->pc == Y->grid->pc;
+}
+
+int mm_dist_multiply(kernel_func_t kernel, const mm_dist_matrix *A,
+                     const mm_dist_matrix *B, mm_dist_matrix *C) {
+    if (!dist_same_shape(A, B) || !dist_same_shape(A, C)) {
+        if (mpi_get_rank() == 0) {
+            fprintf(stderr, "mm_dist_multiply: operands differ in size or grid shape\n");
+        }
+        return -1;
+    }
+    mm_summa(C->grid, C->n, kernel, A->local, B->local, C->local);
+    phase_stats.replication = 1;
+    phase_stats.calls++;
+    return 0;
+}
+
+// Overlap of [a0, a0 + alen) and [b0, b0 + blen); len is 0 when disjoint.
+static void range_overlap(int a0, int alen, int b0, int blen, int *start, int *len) {
+    int lo = a0 > b0 ? a0 : b0;
+    int hi = (a0 + alen < b0 + blen) ? a0 + alen : b0 + blen;
+    *start = lo;
+    *len = hi > lo ? hi - lo : 0;
+}
+
+// Copy the overlap of M's block with the block (row0, rows, col0, cols)
+// between M->local and a packed buffer (to_buf: local -> buf). Returns the
+// number of elements copied.
+static int dist_copy_overlap(const mm_dist_matrix *M, int row0, int rows, int col0, int cols,
+                             double *buf, int to_buf) {
+    int r0, nr, c0, nc;
+    range_overlap(M->row0, M->rows, row0, rows, &r0, &nr);
+    range_overlap(M->col0, M->cols, col0, cols, &c0, &nc);
+    if (nr == 0 || nc == 0) return 0;
+    for (int i = 0; i < nr; i++) {
+        double *l_row = &M->local[(size_t)(r0 - M->row0 + i) * M->cols + (c0 - M->col0)];
+        if (to_buf) {
+            memcpy(&buf[(size_t)i * nc], l_row, (size_t)nc * sizeof(double));
+        } else {
+            memcpy(l_row, &buf[(size_t)i * nc], (size_t)nc * sizeof(double));
+        }
+    }
+    return nr * nc;
+}
+
+int mm_dist_redistribute(const mm_dist_matrix *src, mm_dist_matrix *dst) {
+    int nprocs = src->grid->pr * src->grid->pc;
+    if (src->n != dst->n || dst->grid->pr * dst->grid->pc != nprocs) {
+        if (mpi_get_rank() == 0) {
+            fprintf(stderr, "mm_dist_redistribute: matrices differ in size or rank count\n");
+        }
+        return -1;
+    }
+    if (dist_same_shape(src, dst)) {
+        if (src->local != dst->local && dst->local) {
+            memcpy(dst->local, src->local, (size_t)dst->rows * dst->cols * sizeof(double));
+        }
+        return 0;
+    }
+
+    // Both grids keep the rank order of their communicator, so grid rank r
+    // is the same process in src and dst
+    int n = src->n;
+    int *meta = (int *)malloc(4 * (size_t)nprocs * sizeof(int));
+    if (!meta) {
+        fprintf(stderr, "Rank %d: failed to allocate redistribution counts\n", mpi_get_rank());
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    int *send_counts = meta;
+    int *send_displs = meta + nprocs;
+    int *recv_counts = meta + 2 * nprocs;
+    int *recv_displs = meta + 3 * nprocs;
+    int send_total = 0;
+    int recv_total = 0;
+    for (int r = 0; r < nprocs; r++) {
+        int row0, rows, col0, cols, start, nr, nc;
+        grid_block(dst->grid, n, r, &row0, &rows, &col0, &cols);
+        range_overlap(src->row0, src->rows, row0, rows, &start, &nr);
+        range_overlap(src->col0, src->cols, col0, cols, &start, &nc);
+        send_counts[r] = nr * nc;
+        send_displs[r] = send_total;
+        send_total += send_counts[r];
+
+        grid_block(src->grid, n, r, &row0, &rows, &col0, &cols);
+        range_overlap(dst->row0, dst->rows, row0, rows, &start, &nr);
+        range_overlap(dst->col0, dst->cols, col0, cols, &start, &nc);
+        recv_counts[r] = nr * nc;
+        recv_displs[r] = recv_total;
+        recv_total += recv_counts[r];
+    }
+
+    double *buffers = (double *)mm_aligned_alloc(((size_t)send_total + recv_total + 1) *
+                                                 sizeof(double));
+    if (!buffers) {
+        fprintf(stderr, "Rank %d: failed to allocate redistribution buffers\n", mpi_get_rank());
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    double *send_buf = buffers;
+    double *recv_buf = buffers + send_total;
+    for (int r = 0; r < nprocs; r++) {
+        int row0, rows, col0, cols;
+        grid_block(dst->grid, n, r, &row0, &rows, &col0, &cols);
+        dist_copy_overlap(src, row0, rows, col0, cols, &send_buf[send_displs[r]], 1);
+    }
+    MPI_Alltoallv(send_buf, send_counts, send_displs, MPI_DOUBLE,
+                  recv_buf, recv_counts, recv_displs, MPI_DOUBLE, dst->grid->comm);
+    for (int r = 0; r < nprocs; r++) {
+        int row0, rows, col0, cols;
+        grid_block(src->grid, n, r, &row0, &rows, &col0, &cols);
+        dist_copy_overlap(dst, row0, rows, col0, cols, &recv_buf[recv_displs[r]], 0);
+    }
+
+    mm_aligned_free(buffers);
+    free(meta);
+    return 0;
+}
@@ -0,0 +1,191 @@
+// mpi_grid.h
+// 2D process grids and the distributed GEMM strategies built on them
+// (SUMMA, Cannon, and 2.5D, which stacks c copies of a Cannon grid), plus
+// matrix handles that stay distributed across a chain of multiplies.
+// Every matrix is split into pr x pc blocks with the same row / column split
+// as the master-worker slabs (the first n % parts blocks get one extra
+// row or column), so each rank owns one block, about n^2 / P elements, of
+// each of A, B and C.
+
+#ifndef MPI_GRID_H
+#define MPI_GRID_H
+
+#include "mpi_wrapper.h"
+
+typedef struct {
+    MPI_Comm comm;      // pr x pc Cartesian communicator, rank = row * pc + col
+    MPI_Comm row_comm;  // ranks of this grid row, rank = column index
+    MPI_Comm col_comm;  // ranks of this grid column, rank = row index
+    int pr, pc;         // grid rows and columns
+    int row, col;       // this rank's grid coordinates
+} mm_proc_grid;
+
+// mm_proc_grid_dims
+// Output: pr x pc with pr * pc == nprocs. MM_MPI_GRID="RxC" is used when it
+//   matches nprocs; otherwise MPI_Dims_create picks the most square split
+//   (pr >= pc, so a prime rank count gives a single grid column).
+void mm_proc_grid_dims(int nprocs, int *pr, int *pc);
+
+// mm_proc_grid_create / mm_proc_grid_free
+// Input: comm with exactly pr * pc ranks.
+// Behavior: builds the grid communicator (periodic in both dimensions,
+//   ranks not reordered, so rank 0 of comm is grid rank 0) and its row and
+//   column sub-communicators. Collective over comm.
+// Returns 0 on success, -1 when pr * pc does not match the size of comm.
+int mm_proc_grid_create(MPI_Comm comm, int pr, int pc, mm_proc_grid *grid);
+void mm_proc_grid_free(mm_proc_grid *grid);
+
+// mm_block_range
+// Output: the first index and length of block idx when n is split into
+//   parts blocks.
+void mm_block_range(int n, int parts, int idx, int *start, int *len);
+
+// mm_grid_scatter / mm_grid_gather
+// Input: M, the full n x n row-major matrix on grid rank 0 (ignored
+//   elsewhere); local, this rank's block (row, col) stored contiguously
+//   (rows x cols, leading dimension cols).
+// Behavior: distribute M's blocks from rank 0 / collect them back into M.
+//   Rank 0 packs through one n x n staging buffer. Collective over the grid.
+void mm_grid_scatter(const mm_proc_grid *grid, int n, const double *M, double *local);
+void mm_grid_gather(const mm_proc_grid *grid, int n, const double *local, double *M);
+
+// mm_summa
+// Input: this rank's blocks of A, B and C (mm_grid_scatter layout).
+// Behavior:
+//   C = A * B by SUMMA: k is walked in panels of at most MM_SUMMA_PANEL
+//   (default 256) columns that never straddle a block boundary. For each
+//   panel the owning grid column broadcasts its slice of A along the grid
+//   rows, the owning grid row broadcasts its slice of B down the grid
+//   columns, and every rank accumulates the panel product into its C block
+//   with mpi_local_gemm. The broadcasts of the next panel are posted before
+//   the current product runs (two panel buffers).
+// Complexity:
+//   Per rank: n^3 / P flops, about n^2 / pr + n^2 / pc elements received,
+//   O(n^2 / P + panel * n / min(pr, pc)) memory.
+void mm_summa(const mm_proc_grid *grid, int n, kernel_func_t kernel,
+              const double *local_A, const double *local_B, double *local_C);
+
+// mm_cannon
+// Input: as mm_summa, on a square q x q grid.
+// Behavior:
+//   C = A * B by Cannon's algorithm. An initial skew moves A's block row i
+//   i ranks left and B's block column j j ranks up, after which every rank
+//   holds a matching pair of blocks. Each of the q steps multiplies the pair
+//   into C with mpi_local_gemm while the next pair is already travelling:
+//   A one rank left, B one rank up (point-to-point on the periodic grid).
+// Complexity:
+//   Per rank: n^3 / P flops, about 2n^2 / q elements received over the
+//   skew and the q - 1 shifts, O(n^2 / P) memory.
+void mm_cannon(const mm_proc_grid *grid, int n, kernel_func_t kernel,
+               const double *local_A, const double *local_B, double *local_C);
+
+// mm_proc_grid_square
+// Output: q when nprocs == q * q, otherwise 0.
+int mm_proc_grid_square(int nprocs);
+
+// mpi_matmul_summa
+// Input: as mpi_matmul_master_worker; only rank 0's A, B, C are used.
+// Behavior: builds the grid (mm_proc_grid_dims over MPI_COMM_WORLD),
+//   scatters A and B as blocks, runs mm_summa and gathers C on rank 0.
+void mpi_matmul_summa(double *A, double *B, double *C, int n, kernel_func_t kernel);
+
+// mpi_matmul_cannon
+// Input: as mpi_matmul_summa.
+// Behavior: the same block scatter / gather around mm_cannon on a
+//   sqrt(P) x sqrt(P) grid (MM_MPI_GRID is ignored). Falls back to
+//   mpi_matmul_summa, with a warning, when P is not a perfect square.
+void mpi_matmul_cannon(double *A, double *B, double *C, int n, kernel_func_t kernel);
+
+// mm_25d_replication
+// Output: the replication factor c for nprocs ranks: MM_MPI_REPLICATION
+//   when nprocs = q * q * c with c <= q, otherwise (with a warning if it
+//   was set) the largest such c. 0 when nprocs has no such shape.
+int mm_25d_replication(int nprocs);
+
+// mpi_matmul_25d
+// Input: as mpi_matmul_summa.
+// Behavior:
+//   2.5D multiply on a q x q x c grid (c = mm_25d_replication, P = q*q*c).
+//   Rank 0 scatters A and B as q x q blocks to layer 0, which broadcasts
+//   them to the other c - 1 layers (replicate). Layer l runs its share of
+//   the q Cannon steps, about q / c, starting from its own skew offset, so
+//   the shifts per layer drop by c. The partial C blocks are summed on
+//   layer 0 (reduce) and gathered on rank 0. c = 1 is Cannon. Falls back to
+//   mpi_matmul_summa, with a warning, when P has no q*q*c shape.
+// Complexity:
+//   Per rank: n^3 / P flops, about 2n^2 / sqrt(P c) elements shifted
+//   (a factor sqrt(c) below Cannon on P ranks), O(c n^2 / P) memory.
+void mpi_matmul_25d(double *A, double *B, double *C, int n, kernel_func_t kernel);
+
+// ========== Distributed-resident matrices ==========
+// A matrix that stays spread over the ranks between multiplies, so a chain
+// C = A * B, D = C * E, ... pays the trip through rank 0 only when the
+// caller asks for it. The distribution is the handle's grid: a pr x pc grid
+// gives 2D blocks, a P x 1 grid gives block rows. The grid is borrowed and
+// must outlive every handle created on it.
+
+typedef struct {
+    const mm_proc_grid *grid;
+    int n;
+    int row0, rows;   // this rank's block: rows [row0, row0 + rows)
+    int col0, cols;   //   and columns [col0, col0 + cols)
+    double *local;    // rows x cols, leading dimension cols (NULL if empty)
+} mm_dist_matrix;
+
+// mm_dist_create / mm_dist_free
+// Input: grid (mm_proc_grid_create), n > 0.
+// Behavior: allocates this rank's block (64-byte aligned, first-touched by
+//   the computing threads) and zeroes it. Not collective; aborts when the
+//   allocation fails.
+void mm_dist_create(const mm_proc_grid *grid, int n, mm_dist_matrix *M);
+void mm_dist_free(mm_dist_matrix *M);
+
+// mm_dist_scatter / mm_dist_gather
+// Input: full, an n x n row-major matrix on grid rank 0 (ignored elsewhere).
+// Behavior: load M from rank 0 / copy it back to rank 0 (mm_grid_scatter /
+//   mm_grid_gather). The only operations that go through rank 0; a chain
+//   of multiplies needs them at its ends at most. Collective over the grid.
+void mm_dist_scatter(mm_dist_matrix *M, const double *full);
+void mm_dist_gather(const mm_dist_matrix *M, double *full);
+
+// mm_dist_multiply
+// Input: A, B, C of the same n on the same grid shape; C must not alias A
+//   or B.
+// Behavior: C = A * B with mm_summa on the handles' blocks; nothing leaves
+//   the grid. Collective over the grid.
+// Returns 0, or -1 (C untouched) when the sizes or grid shapes differ.
+int mm_dist_multiply(kernel_func_t kernel, const mm_dist_matrix *A,
+                     const mm_dist_matrix *B, mm_dist_matrix *C);
+
+// mm_dist_redistribute
+// Input: src and dst of the same n on grids over the same communicator
+//   (for example a 2D grid and a P x 1 block-row grid).
+// Behavior: dst = src in dst's distribution. Each rank sends the overlap of
+//   its src block with every dst block straight to that block's owner in
+//   one MPI_Alltoallv; rank 0 carries only its own share. A plain copy when
+//   the grid shapes match. Collective over the communicator.
+// Returns 0, or -1 when the sizes or rank counts differ.
+int mm_dist_redistribute(const mm_dist_matrix *src, mm_dist_matrix *dst);
+
+// mm_grid_phase_stats_reset / mm_grid_phase_stats_get
+// Behavior: wall time this rank spent in each phase of the grid strategies,
+//   accumulated over calls since the last reset. shift is the wait for the
+//   SUMMA panel broadcasts or the Cannon / 2.5D block shifts; compute is
+//   the local block products. replication is the c of the last call (1
+//   for SUMMA and Cannon).
+typedef struct {
+    double scatter;    // blocks from rank 0 (layer 0 under 2.5D)
+    double replicate;  // 2.5D: layer 0 -> other layers
+    double skew;       // Cannon / 2.5D initial alignment
+    double shift;      // per-step exchanges
+    double reduce;     // 2.5D: partial C sum onto layer 0
+    double gather;     // C back to rank 0
+    double compute;
+    int replication;
+    long calls;
+} mm_grid_phase_stats;
+
+void mm_grid_phase_stats_reset(void);
+void mm_grid_phase_stats_get(mm_grid_phase_stats *stats);
+
+#endif // MPI_GRID_H
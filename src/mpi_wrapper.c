@@ -3,7 +3,12 @@
 // Handles distributed-memory parallelization using master-worker model
 
 #include "mpi_wrapper.h"
+#include "gemm.h"
 #include "kernels.h"
+#include "mpi_grid.h"
+#include "oblivious.h"
+#include "packed_gemm.h"
+#include "tuning.h"
 #include "utility.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,6 +21,24 @@
 void mpi_init(int *argc, char ***argv) {
     // Initialize the MPI runtime
     MPI_Init(argc, argv);
+
+    // Ranks on the same node share its last-level cache; size the per-rank
+    // packed B panel (nc) for this rank's share
+    MPI_Comm node_comm;
+    int node_ranks = 1;
+    int node_rank = 0;
+    if (MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, 0,
+                            MPI_INFO_NULL, &node_comm) == MPI_SUCCESS) {
+        MPI_Comm_size(node_comm, &node_ranks);
+        MPI_Comm_rank(node_comm, &node_rank);
+        MPI_Comm_free(&node_comm);
+    }
+    mm_tuning_set_cache_sharers(node_ranks);
+
+    // Same node split for thread pinning (MM_AFFINITY), then pin this rank's
+    // OpenMP team
+    matrix_affinity_partition(node_rank, node_ranks);
+    matrix_pin_threads();
 }
 
 void mpi_finalize() {
@@ -58,11 +81,8 @@ void mpi_gather_rows(double *local_matrix, double *matrix, int n, int local_rows
                root, MPI_COMM_WORLD);
 }
 
-// Internal helper to compute a block of rows locally.
-// If the block is the full matrix (np=1), defer to the chosen kernel.
-// Otherwise use a simple triple loop (OMP parallelized when available).
-#define MPI_BLOCK_SIZE 64
-
+// Internal helper to compute a block of rows locally with the packed-panel
+// engine used by the proposed kernels (local_rows x n times n x n).
 static void matmul_blocked_transposed(double *local_A,
                                       double *B,
                                       double *local_C,
@@ -71,73 +91,7 @@ static void matmul_blocked_transposed(double *local_A,
                                       int use_omp) {
     if (local_rows == 0) return;
 
-    double *B_T = (double *)malloc(n * n * sizeof(double));
-    if (!B_T) {
-        // Fallback to naive multiply
-        for (int i = 0; i < local_rows * n; i++) local_C[i] = 0.0;
-        for (int i = 0; i < local_rows; i++) {
-            for (int j = 0; j < n; j++) {
-                double sum = 0.0;
-                for (int k = 0; k < n; k++) {
-                    sum += local_A[i * n + k] * B[k * n + j];
-                }
-                local_C[i * n + j] = sum;
-            }
-        }
-        return;
-    }
-
-    matrix_transpose(B, B_T, n);
-    for (int i = 0; i < local_rows * n; i++) {
-        local_C[i] = 0.0;
-    }
-
-#ifdef _OPENMP
-    if (use_omp) {
-        #pragma omp parallel for collapse(2) schedule(static)
-        for (int ii = 0; ii < local_rows; ii += MPI_BLOCK_SIZE) {
-            for (int jj = 0; jj < n; jj += MPI_BLOCK_SIZE) {
-                int i_end = (ii + MPI_BLOCK_SIZE < local_rows) ? ii + MPI_BLOCK_SIZE : local_rows;
-                int j_end = (jj + MPI_BLOCK_SIZE < n) ? jj + MPI_BLOCK_SIZE : n;
-                for (int kk = 0; kk < n; kk += MPI_BLOCK_SIZE) {
-                    int k_end = (kk + MPI_BLOCK_SIZE < n) ? kk + MPI_BLOCK_SIZE : n;
-                    for (int i = ii; i < i_end; i++) {
-                        for (int j = jj; j < j_end; j++) {
-                            double sum = 0.0;
-                            for (int k = kk; k < k_end; k++) {
-                                sum += local_A[i * n + k] * B_T[j * n + k];
-                            }
-                            local_C[i * n + j] += sum;
-                        }
-                    }
-                }
-            }
-        }
-        free(B_T);
-        return;
-    }
-#endif
-
-    for (int ii = 0; ii < local_rows; ii += MPI_BLOCK_SIZE) {
-        for (int jj = 0; jj < n; jj += MPI_BLOCK_SIZE) {
-            int i_end = (ii + MPI_BLOCK_SIZE < local_rows) ? ii + MPI_BLOCK_SIZE : local_rows;
-            int j_end = (jj + MPI_BLOCK_SIZE < n) ? jj + MPI_BLOCK_SIZE : n;
-            for (int kk = 0; kk < n; kk += MPI_BLOCK_SIZE) {
-                int k_end = (kk + MPI_BLOCK_SIZE < n) ? kk + MPI_BLOCK_SIZE : n;
-                for (int i = ii; i < i_end; i++) {
-                    for (int j = jj; j < j_end; j++) {
-                        double sum = 0.0;
-                        for (int k = kk; k < k_end; k++) {
-                            sum += local_A[i * n + k] * B_T[j * n + k];
-                        }
-                        local_C[i * n + j] += sum;
-                    }
-                }
-            }
-        }
-    }
-
-    free(B_T);
+    packed_gemm(local_rows, n, n, local_A, n, B, n, local_C, n, 0, use_omp);
 }
 
 static int kernel_is_proposed(kernel_func_t kernel) {
@@ -147,11 +101,9 @@ static int kernel_is_proposed(kernel_func_t kernel) {
 static int kernel_is_omp(kernel_func_t kernel) {
     return kernel == matmul_omp ||
            kernel == strassen_omp ||
-           kernel == proposed_omp;
-}
-
-static int kernel_is_strassen(kernel_func_t kernel) {
-    return kernel == strassen_serial || kernel == strassen_omp;
+           kernel == winograd_omp ||
+           kernel == proposed_omp ||
+           kernel == oblivious_omp;
 }
 
 static void compute_block(kernel_func_t kernel,
@@ -175,38 +127,29 @@ static void compute_block(kernel_func_t kernel,
         return;
     }
 
-    if (kernel_is_strassen(kernel)) {
-        int padded_n = (local_rows > n) ? local_rows : n;
-        double *A_pad = matrix_allocate(padded_n);
-        double *B_pad = matrix_allocate(padded_n);
-        double *C_pad = matrix_allocate(padded_n);
-        if (!A_pad || !B_pad || !C_pad) {
-            if (A_pad) matrix_free(A_pad);
-            if (B_pad) matrix_free(B_pad);
-            if (C_pad) matrix_free(C_pad);
-        } else {
-            matrix_zero_init(A_pad, padded_n);
-            matrix_zero_init(B_pad, padded_n);
-            matrix_zero_init(C_pad, padded_n);
-
-            for (int i = 0; i < local_rows; i++) {
-                memcpy(&A_pad[i * padded_n], &local_A[i * n], n * sizeof(double));
-            }
-            for (int i = 0; i < n; i++) {
-                memcpy(&B_pad[i * padded_n], &B[i * n], n * sizeof(double));
-            }
-
-            kernel(A_pad, B_pad, C_pad, padded_n);
-
-            for (int i = 0; i < local_rows; i++) {
-                memcpy(&local_C[i * n], &C_pad[i * padded_n], n * sizeof(double));
-            }
+    if (kernel == oblivious_serial || kernel == oblivious_omp) {
+        oblivious_gemm(local_rows, n, n, local_A, n, B, n, local_C, n,
+                       kernel == oblivious_omp);
+        return;
+    }
 
-            matrix_free(A_pad);
-            matrix_free(B_pad);
-            matrix_free(C_pad);
-            return;
-        }
+    // Strassen-type kernels run on the local_rows x n slab directly; odd
+    // sizes are peeled inside the recursion, so the slab is never padded.
+    if (kernel == strassen_serial) {
+        strassen_serial_rect(local_rows, n, n, local_A, n, B, n, local_C, n);
+        return;
+    }
+    if (kernel == strassen_omp) {
+        strassen_omp_rect(local_rows, n, n, local_A, n, B, n, local_C, n);
+        return;
+    }
+    if (kernel == winograd_serial) {
+        winograd_serial_rect(local_rows, n, n, local_A, n, B, n, local_C, n);
+        return;
+    }
+    if (kernel == winograd_omp) {
+        winograd_omp_rect(local_rows, n, n, local_A, n, B, n, local_C, n);
+        return;
     }
 
     int use_omp = kernel_is_omp(kernel);
@@ -238,7 +181,51 @@ static void compute_block(kernel_func_t kernel,
     }
 }
 
+// Slab multiply followed by the epilogue. The packed engine fuses it into
+// its register tiles; other kernels get one pass over the slab afterwards,
+// through a separate product buffer when beta reads the old C.
+static void compute_block_epilogue(kernel_func_t kernel,
+                                   double *local_A,
+                                   double *B,
+                                   double *local_C,
+                                   int local_rows,
+                                   int n,
+                                   const mm_epilogue *ep) {
+    if (local_rows == 0) {
+        return;
+    }
+    if (kernel_is_proposed(kernel)) {
+        packed_gemm_epilogue(local_rows, n, n, local_A, n, B, n, local_C, n, ep,
+                             kernel == proposed_omp);
+        return;
+    }
+
+    double *product = local_C;
+    if (ep->beta != 0.0) {
+        product = (double *)mm_aligned_alloc((size_t)local_rows * n * sizeof(double));
+        if (!product) {
+            fprintf(stderr, "Rank %d: failed to allocate epilogue buffer\n", mpi_get_rank());
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+    }
+    compute_block(kernel, local_A, B, product, local_rows, n);
+
+    #pragma omp parallel for schedule(static) if(kernel_is_omp(kernel))
+    for (int i = 0; i < local_rows; i++) {
+        mm_epilogue_apply(ep, 1, n, i, 0, &product[(size_t)i * n], n,
+                          &local_C[(size_t)i * n], n);
+    }
+    if (product != local_C) {
+        mm_aligned_free(product);
+    }
+}
+
 void mpi_matmul_master_worker(double *A, double *B, double *C, int n, kernel_func_t kernel) {
+    mpi_matmul_master_worker_epilogue(A, B, C, n, kernel, NULL);
+}
+
+void mpi_matmul_master_worker_epilogue(double *A, double *B, double *C, int n,
+                                       kernel_func_t kernel, const mm_epilogue *ep) {
     // Master-worker driver: scatter A, broadcast B, compute partial C, gather results
     int rank = mpi_get_rank();
     int size = mpi_get_size();
@@ -253,12 +240,16 @@ void mpi_matmul_master_worker(double *A, double *B, double *C, int n, kernel_fun
     double *local_A = NULL;
     double *local_C = NULL;
     if (local_elems > 0) {
-        local_A = (double *)malloc(local_elems * sizeof(double));
-        local_C = (double *)malloc(local_elems * sizeof(double));
+        local_A = (double *)mm_aligned_alloc(local_elems * sizeof(double));
+        local_C = (double *)mm_aligned_alloc(local_elems * sizeof(double));
         if (!local_A || !local_C) {
             fprintf(stderr, "Rank %d: failed to allocate local buffers\n", rank);
             MPI_Abort(MPI_COMM_WORLD, 1);
         }
+        // Place the slab rows on the nodes of the threads that compute them
+        // (hybrid mode) before MPI writes into them
+        matrix_first_touch(local_A, (size_t)local_rows, (size_t)n);
+        matrix_first_touch(local_C, (size_t)local_rows, (size_t)n);
     }
 
     // Prepare counts/displacements on root for scatter/gather
@@ -290,18 +281,325 @@ void mpi_matmul_master_worker(double *A, double *B, double *C, int n, kernel_fun
                  local_A, local_elems, MPI_DOUBLE,
                  0, MPI_COMM_WORLD);
 
-    // Each process computes its portion using provided kernel
-    compute_block(kernel, local_A, B, local_C, local_rows, n);
+    if (ep) {
+        // Epilogue parameters live on rank 0: broadcast the scalars and the
+        // column bias, scatter the old C rows (beta != 0) and the row bias
+        // like the rows of A
+        double params[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        if (rank == 0) {
+            params[0] = ep->alpha;
+            params[1] = ep->beta;
+            params[2] = ep->lo;
+            params[3] = ep->hi;
+            params[4] = (double)ep->op;
+            params[5] = (ep->row_bias ? 1.0 : 0.0) + (ep->col_bias ? 2.0 : 0.0);
+        }
+        MPI_Bcast(params, 6, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+        int bias_flags = (int)params[5];
+
+        mm_epilogue local_ep = MM_EPILOGUE_INIT;
+        local_ep.alpha = params[0];
+        local_ep.beta = params[1];
+        local_ep.lo = params[2];
+        local_ep.hi = params[3];
+        local_ep.op = (mm_epilogue_op)(int)params[4];
+
+        double *row_bias = NULL;
+        double *col_bias = NULL;
+        if (bias_flags & 1) {
+            row_bias = (double *)malloc(((size_t)local_rows + 1) * sizeof(double));
+            int *row_counts = NULL;
+            int *row_displs = NULL;
+            if (rank == 0) {
+                row_counts = (int *)malloc(size * sizeof(int));
+                row_displs = (int *)malloc(size * sizeof(int));
+                if (row_counts && row_displs) {
+                    for (int i = 0; i < size; i++) {
+                        row_counts[i] = counts[i] / n;
+                        row_displs[i] = displs[i] / n;
+                    }
+                }
+            }
+            if (!row_bias || (rank == 0 && (!row_counts || !row_displs))) {
+                fprintf(stderr, "Rank %d: failed to allocate epilogue bias\n", rank);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            MPI_Scatterv(rank == 0 ? ep->row_bias : NULL, row_counts, row_displs, MPI_DOUBLE,
+                         row_bias, local_rows, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            free(row_counts);
+            free(row_displs);
+            local_ep.row_bias = row_bias;
+        }
+        if (bias_flags & 2) {
+            col_bias = (double *)malloc((size_t)n * sizeof(double));
+            if (!col_bias) {
+                fprintf(stderr, "Rank %d: failed to allocate epilogue bias\n", rank);
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            if (rank == 0) {
+                for (int j = 0; j < n; j++) col_bias[j] = ep->col_bias[j];
+            }
+            MPI_Bcast(col_bias, n, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+            local_ep.col_bias = col_bias;
+        }
+        if (local_ep.beta != 0.0) {
+            MPI_Scatterv(C, counts, displs, MPI_DOUBLE,
+                         local_C, local_elems, MPI_DOUBLE,
+                         0, MPI_COMM_WORLD);
+        }
+
+        compute_block_epilogue(kernel, local_A, B, local_C, local_rows, n, &local_ep);
+        free(row_bias);
+        free(col_bias);
+    } else {
+        // Each process computes its portion using provided kernel
+        compute_block(kernel, local_A, B, local_C, local_rows, n);
+    }
 
     // Gather results back to master
     MPI_Gatherv(local_C, local_elems, MPI_DOUBLE,
                 C, counts, displs, MPI_DOUBLE,
                 0, MPI_COMM_WORLD);
 
-    free(local_A);
-    free(local_C);
+    mm_aligned_free(local_A);
+    mm_aligned_free(local_C);
     if (rank == 0) {
         free(counts);
         free(displs);
     }
 }
+
+static int env_positive_int(const char *name, int fallback) {
+    const char *value = getenv(name);
+    if (value && *value) {
+        int v = atoi(value);
+        if (v > 0) return v;
+    }
+    return fallback;
+}
+
+// Drive outstanding nonblocking collectives between local products; most
+// MPI libraries only progress them inside MPI calls.
+static void pipeline_progress(MPI_Request *reqs, int count) {
+    int done = 0;
+    MPI_Testall(count, reqs, &done, MPI_STATUSES_IGNORE);
+}
+
+// Rows of chunk t in a slab of slab_rows (0 once the slab is exhausted).
+static int chunk_rows_at(int slab_rows, int t, int chunk_rows) {
+    int rows = slab_rows - t * chunk_rows;
+    if (rows > chunk_rows) rows = chunk_rows;
+    return rows > 0 ? rows : 0;
+}
+
+void mpi_matmul_pipelined(double *A, double *B, double *C, int n, kernel_func_t kernel) {
+    int rank = mpi_get_rank();
+    int size = mpi_get_size();
+
+    // Same row slabs as mpi_matmul_master_worker, cut into chunks of
+    // chunk_rows; every rank walks the same chunk count so the collectives
+    // match, sending zero rows once its slab is done
+    int base_rows = n / size;
+    int remainder = n % size;
+    int local_rows = base_rows + (rank < remainder ? 1 : 0);
+    int max_rows = base_rows + (remainder ? 1 : 0);
+    // Default: about eight chunks per slab, at least 16 rows each
+    int chunk_rows = env_positive_int("MM_PIPELINE_ROWS", max_rows > 128 ? (max_rows + 7) / 8 : 16);
+    if (chunk_rows > max_rows) chunk_rows = max_rows > 0 ? max_rows : 1;
+    int chunks = (max_rows + chunk_rows - 1) / chunk_rows;
+    int panels = env_positive_int("MM_PIPELINE_PANELS", 4);
+    if (panels > n) panels = n;
+
+    // B travels as column panels (n x width each, contiguous) so the first
+    // chunk can start on panel 0 while the rest are in flight. Rank 0 packs
+    // them; every rank keeps all of them, as in the row-slab driver
+    double *B_panels = (double *)mm_aligned_alloc((size_t)n * n * sizeof(double));
+    double *local_A = (double *)mm_aligned_alloc(2 * (size_t)chunk_rows * n * sizeof(double) + sizeof(double));
+    double *local_C = (double *)mm_aligned_alloc(((size_t)local_rows * n + 1) * sizeof(double));
+    int nreqs = panels + 2 * chunks;
+    MPI_Request *reqs = (MPI_Request *)malloc((size_t)nreqs * sizeof(MPI_Request));
+    int *counts = NULL;
+    int *displs = NULL;
+    if (rank == 0) {
+        counts = (int *)malloc((size_t)chunks * size * sizeof(int));
+        displs = (int *)malloc((size_t)chunks * size * sizeof(int));
+    }
+    if (!B_panels || !local_A || !local_C || !reqs || (rank == 0 && (!counts || !displs))) {
+        fprintf(stderr, "Rank %d: failed to allocate pipeline buffers\n", rank);
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+    matrix_first_touch(local_C, (size_t)local_rows, (size_t)n);
+    for (int i = 0; i < nreqs; i++) {
+        reqs[i] = MPI_REQUEST_NULL;
+    }
+
+    // Chunk t of rank r covers its slab rows [t * chunk_rows, ...); the
+    // same counts serve the scatter of A and the gather of C
+    if (rank == 0) {
+        int slab_start = 0;
+        for (int r = 0; r < size; r++) {
+            int rows = base_rows + (r < remainder ? 1 : 0);
+            for (int t = 0; t < chunks; t++) {
+                int first = t * chunk_rows;
+                counts[(size_t)t * size + r] = chunk_rows_at(rows, t, chunk_rows) * n;
+                displs[(size_t)t * size + r] = (slab_start + (first < rows ? first : rows)) * n;
+            }
+            slab_start += rows;
+        }
+    }
+
+    MPI_Request *bcast_reqs = reqs;
+    MPI_Request *scatter_reqs = reqs + panels;
+    MPI_Request *gather_reqs = reqs + panels + chunks;
+
+    // Post every panel broadcast, then the first two A chunks
+    for (int j = 0; j < panels; j++) {
+        int j0, width;
+        mm_block_range(n, panels, j, &j0, &width);
+        double *panel = &B_panels[(size_t)n * j0];
+        if (rank == 0) {
+            for (int k = 0; k < n; k++) {
+                memcpy(&panel[(size_t)k * width], &B[(size_t)k * n + j0], (size_t)width * sizeof(double));
+            }
+        }
+        MPI_Ibcast(panel, n * width, MPI_DOUBLE, 0, MPI_COMM_WORLD, &bcast_reqs[j]);
+    }
+    for (int t = 0; t < chunks && t < 2; t++) {
+        MPI_Iscatterv(A, counts ? &counts[(size_t)t * size] : NULL,
+                      displs ? &displs[(size_t)t * size] : NULL, MPI_DOUBLE,
+                      &local_A[(size_t)t * chunk_rows * n],
+                      chunk_rows_at(local_rows, t, chunk_rows) * n,
+                      MPI_DOUBLE, 0, MPI_COMM_WORLD, &scatter_reqs[t]);
+    }
+
+    for (int t = 0; t < chunks; t++) {
+        int first = t * chunk_rows;
+        int rows = chunk_rows_at(local_rows, t, chunk_rows);
+        double *a_chunk = &local_A[(size_t)(t % 2) * chunk_rows * n];
+        double *c_chunk = &local_C[(size_t)(first < local_rows ? first : local_rows) * n];
+
+        MPI_Wait(&scatter_reqs[t], MPI_STATUS_IGNORE);
+        for (int j = 0; j < panels; j++) {
+            int j0, width;
+            mm_block_range(n, panels, j, &j0, &width);
+            if (t == 0) {
+                MPI_Wait(&bcast_reqs[j], MPI_STATUS_IGNORE);
+            }
+            mpi_local_gemm(kernel, rows, width, n, a_chunk, n, &B_panels[(size_t)n * j0], width,
+                           &c_chunk[j0], n, 0);
+            pipeline_progress(reqs, nreqs);
+        }
+
+        // Finished rows go back at once; the chunk buffer takes chunk t + 2
+        MPI_Igatherv(c_chunk, rows * n, MPI_DOUBLE,
+                     C, counts ? &counts[(size_t)t * size] : NULL,
+                     displs ? &displs[(size_t)t * size] : NULL, MPI_DOUBLE,
+                     0, MPI_COMM_WORLD, &gather_reqs[t]);
+        if (t + 2 < chunks) {
+            MPI_Iscatterv(A, counts ? &counts[(size_t)(t + 2) * size] : NULL,
+                          displs ? &displs[(size_t)(t + 2) * size] : NULL, MPI_DOUBLE,
+                          a_chunk, chunk_rows_at(local_rows, t + 2, chunk_rows) * n,
+                          MPI_DOUBLE, 0, MPI_COMM_WORLD, &scatter_reqs[t + 2]);
+        }
+    }
+    MPI_Waitall(chunks, gather_reqs, MPI_STATUSES_IGNORE);
+
+    free(reqs);
+    free(counts);
+    free(displs);
+    mm_aligned_free(B_panels);
+    mm_aligned_free(local_A);
+    mm_aligned_free(local_C);
+}
+
+static const char *const strategy_names[] = {"rows", "summa", "cannon", "2.5d", "pipeline"};
+
+int mpi_strategy_parse(const char *name) {
+    if (!name) return -1;
+    for (int s = 0; s < (int)(sizeof(strategy_names) / sizeof(strategy_names[0])); s++) {
+        if (strcmp(name, strategy_names[s]) == 0) return s;
+    }
+    return -1;
+}
+
+const char *mpi_strategy_name(mm_mpi_strategy strategy) {
+    if ((int)strategy < 0 ||
+        (int)strategy >= (int)(sizeof(strategy_names) / sizeof(strategy_names[0]))) {
+        return "unknown";
+    }
+    return strategy_names[strategy];
+}
+
+mm_mpi_strategy mpi_strategy_default(void) {
+    const char *name = getenv("MM_MPI_STRATEGY");
+    if (!name || !*name) return MM_MPI_ROWS;
+    int strategy = mpi_strategy_parse(name);
+    if (strategy < 0) {
+        if (mpi_get_rank() == 0) {
+            fprintf(stderr, "Warning: unknown MM_MPI_STRATEGY '%s', using rows\n", name);
+        }
+        return MM_MPI_ROWS;
+    }
+    return (mm_mpi_strategy)strategy;
+}
+
+void mpi_matmul(mm_mpi_strategy strategy, double *A, double *B, double *C, int n,
+                kernel_func_t kernel) {
+    switch (strategy) {
+        case MM_MPI_SUMMA:
+            mpi_matmul_summa(A, B, C, n, kernel);
+            break;
+        case MM_MPI_CANNON:
+            mpi_matmul_cannon(A, B, C, n, kernel);
+            break;
+        case MM_MPI_25D:
+            mpi_matmul_25d(A, B, C, n, kernel);
+            break;
+        case MM_MPI_PIPELINE:
+            mpi_matmul_pipelined(A, B, C, n, kernel);
+            break;
+        case MM_MPI_ROWS:
+        default:
+            mpi_matmul_master_worker(A, B, C, n, kernel);
+            break;
+    }
+}
+
+void mpi_local_gemm(kernel_func_t kernel, int m, int n, int k,
+                    const double *A, int lda, const double *B, int ldb,
+                    double *C, int ldc, int accumulate) {
+    if (m <= 0 || n <= 0) return;
+    int use_omp = kernel_is_omp(kernel);
+    double beta = accumulate ? 1.0 : 0.0;
+
+    if ((kernel == oblivious_serial || kernel == oblivious_omp) && k > 0) {
+        if (!accumulate) {
+            oblivious_gemm(m, n, k, A, lda, B, ldb, C, ldc, use_omp);
+            return;
+        }
+        double *product = (double *)mm_aligned_alloc((size_t)m * n * sizeof(double));
+        if (product) {
+            oblivious_gemm(m, n, k, A, lda, B, ldb, product, n, use_omp);
+            #pragma omp parallel for schedule(static) if(use_omp)
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < n; j++) {
+                    C[(size_t)i * ldc + j] += product[(size_t)i * n + j];
+                }
+            }
+            mm_aligned_free(product);
+            return;
+        }
+        fprintf(stderr, "Rank %d: failed to allocate oblivious product, using packed engine\n",
+                mpi_get_rank());
+    }
+
+    mm_gemm_engine engine = MM_GEMM_NAIVE;
+    if (kernel_is_proposed(kernel) || kernel == oblivious_serial || kernel == oblivious_omp) {
+        engine = MM_GEMM_PROPOSED;
+    } else if (kernel == strassen_serial || kernel == strassen_omp) {
+        engine = MM_GEMM_STRASSEN;
+    } else if (kernel == winograd_serial || kernel == winograd_omp) {
+        engine = MM_GEMM_WINOGRAD;
+    }
+    mm_dgemm(engine, use_omp, 'N', 'N', m, n, k, 1.0, A, lda, B, ldb, beta, C, ldc);
+}
@@ -5,6 +5,7 @@
 #ifndef MPI_WRAPPER_H
 #define MPI_WRAPPER_H
 
+#include "epilogue.h"
 #include <mpi.h>
 
 // Type definition for kernel function pointer
@@ -13,7 +14,10 @@ typedef void (*kernel_func_t)(double *A, double *B, double *C, int n);
 
 // mpi_init
 // Input: pointers to argc/argv from main.
-// Behavior: wraps MPI_Init so all approaches share one entry point.
+// Behavior: wraps MPI_Init so all approaches share one entry point, then
+//   tells the tuning layer how many ranks share this node's last-level cache
+//   and pins this rank's OpenMP threads to its share of the node
+//   (MM_AFFINITY, see matrix_pin_threads).
 // Constraints: must be called exactly once before any MPI usage.
 void mpi_init(int *argc, char ***argv);
 
@@ -46,6 +50,80 @@ int mpi_get_size();
 //   Communication O(n^2) per scatter/gather; computation cost depends on kernel.
 void mpi_matmul_master_worker(double *A, double *B, double *C, int n, kernel_func_t kernel);
 
+// mpi_matmul_master_worker_epilogue
+// Input: as mpi_matmul_master_worker, plus ep (epilogue.h). ep must be
+//   non-NULL on every rank or on none; its contents are read on rank 0 only.
+// Behavior:
+//   C = op(alpha * A * B + beta * C + row_bias + col_bias) on rank 0's C.
+//   The scalars and column bias are broadcast; the row bias, and the old C
+//   rows when beta != 0, are scattered with the rows of A. Each rank applies
+//   the epilogue in its slab compute: fused into the register tiles by the
+//   proposed kernels, one pass over the slab right after the multiply for
+//   the others, so C reaches rank 0 finished.
+void mpi_matmul_master_worker_epilogue(double *A, double *B, double *C, int n,
+                                       kernel_func_t kernel, const mm_epilogue *ep);
+
+// ========== Distribution strategies ==========
+
+typedef enum {
+    MM_MPI_ROWS = 0,  // master-worker row slabs, full B on every rank
+    MM_MPI_SUMMA,     // SUMMA on a 2D process grid (mpi_grid.h)
+    MM_MPI_CANNON,    // Cannon on a square process grid (mpi_grid.h)
+    MM_MPI_25D,       // 2.5D: Cannon replicated over c layers (mpi_grid.h)
+    MM_MPI_PIPELINE   // row slabs with nonblocking, overlapped transfers
+} mm_mpi_strategy;
+
+// mpi_strategy_parse / mpi_strategy_name
+// Behavior: map "rows", "summa", "cannon", "2.5d", "pipeline" to the strategy and back. parse returns -1
+//   for an unknown name.
+int mpi_strategy_parse(const char *name);
+const char *mpi_strategy_name(mm_mpi_strategy strategy);
+
+// mpi_strategy_default
+// Output: the MM_MPI_STRATEGY environment variable when it names a strategy,
+//   otherwise MM_MPI_ROWS (an unknown name is reported on stderr).
+mm_mpi_strategy mpi_strategy_default(void);
+
+// mpi_matmul
+// Input: as mpi_matmul_master_worker, plus the distribution strategy.
+// Behavior: C = A * B on rank 0 with the chosen strategy; A, B and C only
+//   need to be valid on rank 0 (MM_MPI_ROWS also needs a B buffer of n*n
+//   on every rank).
+void mpi_matmul(mm_mpi_strategy strategy, double *A, double *B, double *C, int n,
+                kernel_func_t kernel);
+
+// mpi_local_gemm
+// Input:
+//   kernel:  selects the engine and serial / OpenMP, as for the row slabs.
+//   m, n, k: C is m x n, A is m x k, B is k x n (row-major views).
+//   lda/ldb/ldc: leading dimensions; accumulate: non-zero adds to C.
+// Behavior:
+//   C = A * B, or C += A * B, on rectangular local blocks with the engine
+//   behind kernel (mm_dgemm; oblivious kernels through a scratch product).
+//   Used by the 2D-grid strategies for their per-step block updates.
+void mpi_local_gemm(kernel_func_t kernel, int m, int n, int k,
+                    const double *A, int lda, const double *B, int ldb,
+                    double *C, int ldc, int accumulate);
+
+// mpi_matmul_pipelined
+// Input: as mpi_matmul_master_worker.
+// Behavior:
+//   The row-slab decomposition of mpi_matmul_master_worker with the
+//   transfers overlapped with compute:
+//     * B is broadcast as MM_PIPELINE_PANELS (default 4) column panels with
+//       MPI_Ibcast; the first row chunk starts on panel 0 while the others
+//       are still in flight.
+//     * Each slab is cut into chunks of MM_PIPELINE_ROWS rows (default about
+//       an eighth of a slab, at least 16); chunk t + 1 arrives by
+//       MPI_Iscatterv into the second of two chunk buffers while chunk t is
+//       multiplied.
+//     * A finished chunk of C goes back with MPI_Igatherv right away.
+//   Between panel products the outstanding requests are tested so the MPI
+//   library can progress them.
+// Constraints: as mpi_matmul_master_worker; needs MPI-3 nonblocking
+//   collectives.
+void mpi_matmul_pipelined(double *A, double *B, double *C, int n, kernel_func_t kernel);
+
 // mpi_broadcast_matrix
 // Convenience wrapper around MPI_Bcast for entire n x n matrices.
 void mpi_broadcast_matrix(double *matrix, int n, int root);
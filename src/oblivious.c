@@ -0,0 +1,227 @@
+// oblivious.c
+// Cache-oblivious recursive GEMM on Z-order tiles (see oblivious.h).
+
+#include "oblivious.h"
+#include "utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#define TILE MM_OBLIVIOUS_TILE
+#define TILE_ELEMS ((size_t)TILE * TILE)
+
+// Subproblems of at least this many tile products are split into OpenMP
+// tasks (about 0.5 MFLOP), smaller ones run inside their parent's task.
+#define TASK_MIN_TILE_PRODUCTS 8
+
+// One operand in tiled form: a rows x cols grid of TILE x TILE row-major
+// tiles whose storage order is Z-order; offset maps grid position to tile.
+typedef struct {
+    int rows, cols;
+    size_t *offset;   // offset[r * cols + c]: first element of tile (r, c)
+    double *data;
+} tile_grid;
+
+static int min_int(int a, int b) {
+    return (a < b) ? a : b;
+}
+
+static int tiles_for(int elems) {
+    return (elems + TILE - 1) / TILE;
+}
+
+// Number tiles [r0, r1) x [c0, c1) in Z-order: visit the quadrants
+// top-left, top-right, bottom-left, bottom-right, halving each dimension
+// that still spans more than one tile.
+static void zorder_walk(tile_grid *grid, int r0, int r1, int c0, int c1, size_t *next) {
+    if (r0 >= r1 || c0 >= c1) return;
+    if (r1 - r0 == 1 && c1 - c0 == 1) {
+        grid->offset[(size_t)r0 * grid->cols + c0] = (*next)++ * TILE_ELEMS;
+        return;
+    }
+    int rm = (r1 - r0 > 1) ? r0 + (r1 - r0) / 2 : r1;
+    int cm = (c1 - c0 > 1) ? c0 + (c1 - c0) / 2 : c1;
+    zorder_walk(grid, r0, rm, c0, cm, next);
+    zorder_walk(grid, r0, rm, cm, c1, next);
+    zorder_walk(grid, rm, r1, c0, cm, next);
+    zorder_walk(grid, rm, r1, cm, c1, next);
+}
+
+static int grid_init(tile_grid *grid, int rows, int cols, double *data) {
+    grid->rows = rows;
+    grid->cols = cols;
+    grid->data = data;
+    grid->offset = (size_t *)malloc((size_t)rows * cols * sizeof(size_t));
+    if (!grid->offset) return -1;
+    size_t next = 0;
+    zorder_walk(grid, 0, rows, 0, cols, &next);
+    return 0;
+}
+
+static double *grid_tile(const tile_grid *grid, int r, int c) {
+    return grid->data + grid->offset[(size_t)r * grid->cols + c];
+}
+
+// Row-major rows x cols matrix -> grid (edges zero-padded). Called by every
+// thread of the current team; tile rows are shared out by the loop.
+static void grid_load(tile_grid *grid, const double *src, int ld, int rows, int cols) {
+    #pragma omp for schedule(static)
+    for (int tr = 0; tr < grid->rows; tr++) {
+        for (int tc = 0; tc < grid->cols; tc++) {
+            double *tile = grid_tile(grid, tr, tc);
+            int valid = min_int(TILE, cols - tc * TILE);
+            for (int i = 0; i < TILE; i++) {
+                int r = tr * TILE + i;
+                double *t_row = tile + (size_t)i * TILE;
+                int copied = 0;
+                if (r < rows) {
+                    memcpy(t_row, src + (size_t)r * ld + tc * TILE, (size_t)valid * sizeof(double));
+                    copied = valid;
+                }
+                memset(t_row + copied, 0, (size_t)(TILE - copied) * sizeof(double));
+            }
+        }
+    }
+}
+
+static void grid_zero(tile_grid *grid) {
+    #pragma omp for schedule(static)
+    for (int tr = 0; tr < grid->rows; tr++) {
+        for (int tc = 0; tc < grid->cols; tc++) {
+            memset(grid_tile(grid, tr, tc), 0, TILE_ELEMS * sizeof(double));
+        }
+    }
+}
+
+// grid -> row-major rows x cols matrix (padding dropped).
+static void grid_store(const tile_grid *grid, double *dst, int ld, int rows, int cols) {
+    #pragma omp for schedule(static)
+    for (int tr = 0; tr < grid->rows; tr++) {
+        int valid_rows = min_int(TILE, rows - tr * TILE);
+        for (int tc = 0; tc < grid->cols; tc++) {
+            const double *tile = grid_tile(grid, tr, tc);
+            int valid = min_int(TILE, cols - tc * TILE);
+            for (int i = 0; i < valid_rows; i++) {
+                memcpy(dst + (size_t)(tr * TILE + i) * ld + tc * TILE,
+                       tile + (size_t)i * TILE, (size_t)valid * sizeof(double));
+            }
+        }
+    }
+}
+
+// c += a * b on TILE x TILE tiles. Each row of c is accumulated in a local
+// array across the whole p loop; the fixed bounds let the compiler keep it
+// in vector registers and unroll the contiguous j loop.
+static void tile_multiply(const double *restrict a, const double *restrict b,
+                          double *restrict c) {
+    for (int i = 0; i < TILE; i++) {
+        double acc[TILE];
+        double *c_row = c + i * TILE;
+        for (int j = 0; j < TILE; j++) {
+            acc[j] = c_row[j];
+        }
+        for (int p = 0; p < TILE; p++) {
+            double aip = a[i * TILE + p];
+            const double *b_row = b + p * TILE;
+            for (int j = 0; j < TILE; j++) {
+                acc[j] += aip * b_row[j];
+            }
+        }
+        for (int j = 0; j < TILE; j++) {
+            c_row[j] = acc[j];
+        }
+    }
+}
+
+// C[i0, i1) x [j0, j1) += A[i0, i1) x [p0, p1) * B[p0, p1) x [j0, j1), in
+// tiles. Halves the largest dimension; ties prefer m, then n, whose halves
+// write disjoint parts of C and may run as concurrent tasks.
+static void oblivious_recursive(const tile_grid *A, const tile_grid *B, tile_grid *C,
+                                int i0, int i1, int j0, int j1, int p0, int p1,
+                                int use_tasks) {
+    int mt = i1 - i0, nt = j1 - j0, kt = p1 - p0;
+    if (mt == 1 && nt == 1 && kt == 1) {
+        tile_multiply(grid_tile(A, i0, p0), grid_tile(B, p0, j0), grid_tile(C, i0, j0));
+        return;
+    }
+
+    int spawn = use_tasks && (long)mt * nt * kt >= TASK_MIN_TILE_PRODUCTS;
+    if (mt >= nt && mt >= kt) {
+        int im = i0 + mt / 2;
+        #pragma omp task if(spawn)
+        oblivious_recursive(A, B, C, i0, im, j0, j1, p0, p1, use_tasks);
+        oblivious_recursive(A, B, C, im, i1, j0, j1, p0, p1, use_tasks);
+        #pragma omp taskwait
+    } else if (nt >= kt) {
+        int jm = j0 + nt / 2;
+        #pragma omp task if(spawn)
+        oblivious_recursive(A, B, C, i0, i1, j0, jm, p0, p1, use_tasks);
+        oblivious_recursive(A, B, C, i0, i1, jm, j1, p0, p1, use_tasks);
+        #pragma omp taskwait
+    } else {
+        // Both halves of k accumulate into the same C block
+        int pm = p0 + kt / 2;
+        oblivious_recursive(A, B, C, i0, i1, j0, j1, p0, pm, use_tasks);
+        oblivious_recursive(A, B, C, i0, i1, j0, j1, pm, p1, use_tasks);
+    }
+}
+
+void oblivious_gemm(int m, int n, int k,
+                    const double *A, int lda,
+                    const double *B, int ldb,
+                    double *C, int ldc,
+                    int use_omp) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0) {
+        for (int i = 0; i < m; i++) {
+            memset(C + (size_t)i * ldc, 0, (size_t)n * sizeof(double));
+        }
+        return;
+    }
+
+    int mt = tiles_for(m), nt = tiles_for(n), kt = tiles_for(k);
+    size_t a_tiles = (size_t)mt * kt;
+    size_t b_tiles = (size_t)kt * nt;
+    size_t c_tiles = (size_t)mt * nt;
+    double *buf = (double *)mm_aligned_alloc((a_tiles + b_tiles + c_tiles) * TILE_ELEMS * sizeof(double));
+    tile_grid ga = {0}, gb = {0}, gc = {0};
+    int failed = !buf;
+    if (!failed) {
+        failed = grid_init(&ga, mt, kt, buf) != 0 ||
+                 grid_init(&gb, kt, nt, buf + a_tiles * TILE_ELEMS) != 0 ||
+                 grid_init(&gc, mt, nt, buf + (a_tiles + b_tiles) * TILE_ELEMS) != 0;
+    }
+    if (failed) {
+        fprintf(stderr, "oblivious_gemm: failed to allocate tiled operands, using naive multiply\n");
+        matrix_mul_strided(m, n, k, A, lda, B, ldb, C, ldc, 0);
+    } else {
+        int nthreads = 1;
+#ifdef _OPENMP
+        if (use_omp) {
+            nthreads = omp_get_max_threads();
+        }
+#endif
+        #pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+        {
+            grid_load(&ga, A, lda, m, k);
+            grid_load(&gb, B, ldb, k, n);
+            grid_zero(&gc);
+
+            // One thread walks the recursion; the others run its tasks at
+            // the barrier that closes the single construct
+            #pragma omp single
+            oblivious_recursive(&ga, &gb, &gc, 0, mt, 0, nt, 0, kt, nthreads > 1);
+
+            grid_store(&gc, C, ldc, m, n);
+        }
+    }
+
+    free(ga.offset);
+    free(gb.offset);
+    free(gc.offset);
+    mm_aligned_free(buf);
+}
@@ -0,0 +1,38 @@
+// oblivious.h
+// Cache-oblivious recursive GEMM on a Z-order (Morton) tiled layout behind
+// the "oblivious" kernels.
+
+#ifndef OBLIVIOUS_H
+#define OBLIVIOUS_H
+
+// Leaf tile edge (elements). Three 32 x 32 fp64 tiles take 24KB, which fits
+// the L1 of every core we run on, so this is not a per-machine constant:
+// the recursion, not the tile size, adapts to L2/L3.
+#define MM_OBLIVIOUS_TILE 32
+
+// oblivious_gemm
+// Input:
+//   m, n, k:  C is m x n, A is m x k, B is k x n (row-major views).
+//   A, lda / B, ldb / C, ldc: operands with their leading dimensions.
+//   use_omp:  non-zero runs the conversions and independent halves of the
+//             recursion on the OpenMP team.
+// Behavior:
+//   C = A * B (C overwritten). On entry A, B and C are converted to a tiled
+//   layout: MM_OBLIVIOUS_TILE^2 row-major tiles (zero-padded at the edges)
+//   stored in Z-order, i.e. the order a quadrant-by-quadrant walk of the
+//   tile grid visits them (Morton order for power-of-two grids). The
+//   multiply then halves the largest of m, n, k, in whole tiles, until one
+//   tile of each operand remains, so every level of the memory hierarchy
+//   sees subproblems that fit it without any blocking parameter. C is
+//   converted back to row-major at exit. Halves of m or n are independent
+//   (OpenMP tasks); halves of k run one after the other.
+// Complexity:
+//   Time O(m*n*k), extra space (m*k + k*n + m*n) doubles rounded up to whole
+//   tiles. Falls back to the strided naive loop if that cannot be allocated.
+void oblivious_gemm(int m, int n, int k,
+                    const double *A, int lda,
+                    const double *B, int ldb,
+                    double *C, int ldc,
+                    int use_omp);
+
+#endif // OBLIVIOUS_H
@@ -3,8 +3,13 @@
 // Member 1 responsible
 
 #include "kernels.h"
+#include "oblivious.h"
+#include "packed_gemm.h"
+#include "tuning.h"
 #include "utility.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 // Include omp.h only when OpenMP is enabled; otherwise these
 // functions compile as serial fallbacks.
@@ -30,295 +35,614 @@ void matmul_omp(double *A, double *B, double *C, int n) {
 }
 
 // ========== STRASSEN ALGORITHM (OpenMP) ==========
-#define STRASSEN_THRESHOLD_OMP 64
-#define STRASSEN_PARALLEL_CUTOFF 256  // Only parallelize above this size
+// Base-case size and task cutoff come from the tuning profile (keys
+// strassen_threshold_omp and strassen_parallel_cutoff, default 256: only
+// levels at least this large spawn tasks). Base cases run the packed SIMD
+// engine serially on the strided views (packed_gemm_small), one per task. Tasks are spawned on
+// the top strassen_task_depth levels (0 = derived from the thread count, see
+// strassen_omp_task_depth), so up to 7^depth products run concurrently. Each
+// task level multiplies the scratch by about 7/4, so the depth is capped by a
+// memory budget (MM_STRASSEN_OMP_WS_BUDGET copies of the operands).
 
-static int next_power_of_2_omp(int n) {
-    int p = 1;
-    while (p < n) p *= 2;
-    return p;
+// Odd dimensions are peeled (see strassen_serial_rect): every level recurses
+// on the even part and matrix_peel_fixup handles the odd row, column and
+// inner term, so nothing is padded to a power of two.
+
+// Rows of C per combine / peel task at task levels.
+#define STRASSEN_TASK_ROWS 64
+
+static int is_strassen_base(int m, int n, int k) {
+    int cutoff = mm_tuning()->strassen_threshold_omp;
+    return m <= cutoff || n <= cutoff || k <= cutoff;
 }
 
-// Helper: Copy submatrix (same as serial)
-static void copy_submatrix_omp(double *src, double *dst, int n, 
-                               int rowSrc, int colSrc, int strideSrc,
-                               int rowDst, int colDst, int strideDst) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            dst[(rowDst + i) * strideDst + (colDst + j)] = 
-                src[(rowSrc + i) * strideSrc + (colSrc + j)];
+static int is_task_level(int m, int n, int k, int task_depth) {
+    int cutoff = mm_tuning()->strassen_parallel_cutoff;
+    return task_depth > 0 && m >= cutoff && n >= cutoff && k >= cutoff;
+}
+
+// Workspace (in elements) of a serial (task-free) Strassen subtree on an
+// m x n x k problem: each level carves an A-side sum, a B-side sum and one
+// product buffer, and the seven products reuse one child slice in turn. A
+// base case needs the packing buffers of packed_gemm_small.
+static size_t strassen_serial_ws_elems(int m, int n, int k) {
+    if (is_strassen_base(m, n, k)) return packed_gemm_small_workspace(m, n, k);
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    return (size_t)hm * hk + (size_t)hk * hn + (size_t)hm * hn +
+           strassen_serial_ws_elems(hm, hn, hk);
+}
+
+// Task levels actually taken for an m x n x k problem: every node of one
+// level has the same shape, so the task levels form a complete 7-ary tree
+// whose 7^levels leaves are serial subtrees.
+static int strassen_task_levels(int m, int n, int k, int task_depth) {
+    if (is_strassen_base(m, n, k) || !is_task_level(m, n, k, task_depth)) return 0;
+    return 1 + strassen_task_levels(m / 2, n / 2, k / 2, task_depth - 1);
+}
+
+// Workspace (in elements) of the task levels alone: M1..M5 each get a
+// product buffer (M6/M7 accumulate straight into C22/C11), five tasks an
+// A-side sum, five a B-side sum, and every task, when its child is a task
+// level too, the child's own task workspace.
+static size_t strassen_task_tree_elems(int m, int n, int k, int task_depth) {
+    if (is_strassen_base(m, n, k) || !is_task_level(m, n, k, task_depth)) return 0;
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    return 5 * ((size_t)hm * hn + (size_t)hm * hk + (size_t)hk * hn) +
+           7 * strassen_task_tree_elems(hm, hn, hk, task_depth - 1);
+}
+
+// Shape of one serial leaf below the task levels.
+static void strassen_leaf_shape(int *m, int *n, int *k, int task_depth) {
+    while (!is_strassen_base(*m, *n, *k) && is_task_level(*m, *n, *k, task_depth)) {
+        *m /= 2;
+        *n /= 2;
+        *k /= 2;
+        task_depth--;
+    }
+}
+
+// Leaf scratch slots: a leaf never reaches a task scheduling point, so it
+// can borrow the slot of the thread that runs it, and no more leaves than
+// threads are ever in flight. With more threads than leaves, each leaf
+// keeps a slot of its own instead.
+static long strassen_leaf_count(int levels) {
+    long leaves = 1;
+    for (int l = 0; l < levels; l++) leaves *= 7;
+    return leaves;
+}
+
+static long strassen_leaf_slots(int levels, int nthreads) {
+    long leaves = strassen_leaf_count(levels);
+    return nthreads < leaves ? nthreads : leaves;
+}
+
+size_t strassen_omp_team_workspace(int m, int n, int k, int task_depth, int nthreads) {
+    int lm = m, ln = n, lk = k;
+    strassen_leaf_shape(&lm, &ln, &lk, task_depth);
+    long slots = strassen_leaf_slots(strassen_task_levels(m, n, k, task_depth),
+                                     nthreads > 0 ? nthreads : 1);
+    return strassen_task_tree_elems(m, n, k, task_depth) +
+           (size_t)slots * strassen_serial_ws_elems(lm, ln, lk);
+}
+
+int strassen_omp_task_depth(int m, int n, int k, int nthreads) {
+    if (nthreads <= 1) return 0;
+    int depth = mm_tuning()->strassen_task_depth;
+    if (depth <= 0) {
+        // Enough products to keep every thread busy through the uneven
+        // combine phase: 7^depth >= 2 * nthreads
+        depth = 1;
+        for (long tasks = 7; tasks < 2L * nthreads && depth < MM_STRASSEN_MAX_TASK_DEPTH;
+             tasks *= 7) {
+            depth++;
         }
     }
+    // Every task level multiplies the scratch by about 7/4: give up levels
+    // until it fits in a few copies of the operands
+    size_t budget = (size_t)MM_STRASSEN_OMP_WS_BUDGET * ((size_t)m * k + (size_t)k * n);
+    while (depth > 0 && strassen_omp_team_workspace(m, n, k, depth, nthreads) > budget) {
+        depth--;
+    }
+    return depth;
 }
 
-// Recursive Strassen with OpenMP tasks
-static void strassen_recursive_omp(double *A, double *B, double *C, int n, int stride, int use_tasks) {
-    // Base case: use naive multiplication
-    if (n <= STRASSEN_THRESHOLD_OMP) {
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                double sum = 0.0;
-                for (int k = 0; k < n; k++) {
-                    sum += A[i * stride + k] * B[k * stride + j];
-                }
-                C[i * stride + j] += sum;
+// Where the serial leaves below the task levels find their scratch.
+typedef struct {
+    double *base;
+    size_t slot_elems;
+    int by_thread;   // slot = thread number, otherwise slot = leaf ordinal
+} strassen_leaf_pool;
+
+static double *strassen_leaf_ws(const strassen_leaf_pool *pool, long ordinal) {
+    long slot = ordinal;
+#ifdef _OPENMP
+    if (pool->by_thread) slot = omp_get_thread_num();
+#endif
+    return pool->base + (size_t)slot * pool->slot_elems;
+}
+
+// C += sp * P + sq * Q + sr * R over a rows x cols block (R may be NULL);
+// P, Q, R are contiguous with leading dimension cols.
+static void combine_products(int rows, int cols, double *C, int ldc,
+                             const double *P, double sp, const double *Q, double sq,
+                             const double *R, double sr) {
+    for (int i = 0; i < rows; i++) {
+        double *c_row = C + (size_t)i * ldc;
+        const double *p_row = P + (size_t)i * cols;
+        const double *q_row = Q + (size_t)i * cols;
+        if (R) {
+            const double *r_row = R + (size_t)i * cols;
+            for (int j = 0; j < cols; j++) {
+                c_row[j] += sp * p_row[j] + sq * q_row[j] + sr * r_row[j];
+            }
+        } else {
+            for (int j = 0; j < cols; j++) {
+                c_row[j] += sp * p_row[j] + sq * q_row[j];
             }
         }
+    }
+}
+
+static void strassen_recursive_omp(int m, int n, int k,
+                                   const double *A, int lda, const double *B, int ldb,
+                                   double *C, int ldc, int task_depth, double *ws,
+                                   const strassen_leaf_pool *pool, long ordinal);
+
+// One of the seven products of a task level: a task-level child runs on its
+// slice of the task workspace (tree_ws), a serial child on a leaf slot.
+static void strassen_child_omp(int m, int n, int k,
+                               const double *A, int lda, const double *B, int ldb,
+                               double *C, int ldc, int task_depth, double *tree_ws,
+                               const strassen_leaf_pool *pool, long ordinal) {
+    if (tree_ws) {
+        strassen_recursive_omp(m, n, k, A, lda, B, ldb, C, ldc, task_depth, tree_ws,
+                               pool, ordinal);
+    } else {
+        strassen_recursive_omp(m, n, k, A, lda, B, ldb, C, ldc, 0,
+                               strassen_leaf_ws(pool, ordinal), pool, 0);
+    }
+}
+
+// Recursive Strassen with OpenMP tasks on strided views: C += A * B where C
+// is m x n, A is m x k and B is k x n. Quadrants are read and written in
+// place; all temporaries are slices of ws (strassen_task_tree_elems on task
+// levels, strassen_serial_ws_elems below them) or of the leaf pool, so
+// neither the recursion nor the tasks copy quadrants or touch the
+// allocator. ordinal numbers this node among the nodes of its level.
+static void strassen_recursive_omp(int m, int n, int k,
+                                   const double *A, int lda, const double *B, int ldb,
+                                   double *C, int ldc, int task_depth, double *ws,
+                                   const strassen_leaf_pool *pool, long ordinal) {
+    // Base case: packed engine on the strided views
+    if (is_strassen_base(m, n, k)) {
+        packed_gemm_small(m, n, k, A, lda, B, ldb, C, ldc, 1, ws);
         return;
     }
     
-    int half = n / 2;
-    
-    // Allocate temporary matrices
-    double *A11 = matrix_allocate(half);
-    double *A12 = matrix_allocate(half);
-    double *A21 = matrix_allocate(half);
-    double *A22 = matrix_allocate(half);
-    
-    double *B11 = matrix_allocate(half);
-    double *B12 = matrix_allocate(half);
-    double *B21 = matrix_allocate(half);
-    double *B22 = matrix_allocate(half);
-    
-    double *M1 = matrix_allocate(half);
-    double *M2 = matrix_allocate(half);
-    double *M3 = matrix_allocate(half);
-    double *M4 = matrix_allocate(half);
-    double *M5 = matrix_allocate(half);
-    double *M6 = matrix_allocate(half);
-    double *M7 = matrix_allocate(half);
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    size_t a_elems = (size_t)hm * hk;
+    size_t b_elems = (size_t)hk * hn;
+    size_t c_elems = (size_t)hm * hn;
     
-    double *temp1 = matrix_allocate(half);
-    double *temp2 = matrix_allocate(half);
+    // Quadrant views of the even part
+    const double *A11 = A, *A12 = A + hk, *A21 = A + hm * lda, *A22 = A + hm * lda + hk;
+    const double *B11 = B, *B12 = B + hn, *B21 = B + hk * ldb, *B22 = B + hk * ldb + hn;
+    double *C11 = C, *C12 = C + hn, *C21 = C + hm * ldc, *C22 = C + hm * ldc + hn;
     
-    // Copy submatrices
-    copy_submatrix_omp(A, A11, half, 0, 0, stride, 0, 0, half);
-    copy_submatrix_omp(A, A12, half, 0, half, stride, 0, 0, half);
-    copy_submatrix_omp(A, A21, half, half, 0, stride, 0, 0, half);
-    copy_submatrix_omp(A, A22, half, half, half, stride, 0, 0, half);
-    
-    copy_submatrix_omp(B, B11, half, 0, 0, stride, 0, 0, half);
-    copy_submatrix_omp(B, B12, half, 0, half, stride, 0, 0, half);
-    copy_submatrix_omp(B, B21, half, half, 0, stride, 0, 0, half);
-    copy_submatrix_omp(B, B22, half, half, half, stride, 0, 0, half);
-    
-    // Decide whether to use tasks (only at top levels to avoid overhead)
-    int use_tasks_recursive = use_tasks && (n >= STRASSEN_PARALLEL_CUTOFF);
-    
-    if (use_tasks_recursive) {
-        // Parallelize the 7 products using OpenMP tasks
-        #pragma omp task shared(M1, A11, A22, B11, B22, temp1, temp2)
-        {
-            matrix_add(A11, A22, temp1, half);
-            matrix_add(B11, B22, temp2, half);
-            matrix_zero_init(M1, half);
-            strassen_recursive_omp(temp1, temp2, M1, half, half, 0);
-        }
-        
-        #pragma omp task shared(M2, A21, A22, B11)
-        {
-            double *t1 = matrix_allocate(half);
-            matrix_add(A21, A22, t1, half);
-            matrix_zero_init(M2, half);
-            strassen_recursive_omp(t1, B11, M2, half, half, 0);
-            matrix_free(t1);
-        }
-        
-        #pragma omp task shared(M3, A11, B12, B22)
-        {
-            double *t2 = matrix_allocate(half);
-            matrix_sub(B12, B22, t2, half);
-            matrix_zero_init(M3, half);
-            strassen_recursive_omp(A11, t2, M3, half, half, 0);
-            matrix_free(t2);
-        }
+    if (is_task_level(m, n, k, task_depth)) {
+        // Every operand sum, product and combine block is its own task,
+        // ordered by depend clauses instead of taskwaits: a product starts
+        // as soon as its two sums exist and each C quadrant is combined, in
+        // row blocks, as soon as the products it needs are done. M1..M5 feed
+        // two C quadrants each; M6 and M7 accumulate straight into C22 and
+        // C11, which the combine of those quadrants waits for. After the
+        // product buffers, task i owns the operand sums it reads (M2 and M5
+        // need only an A-side sum, M3 and M4 only a B-side one), then the
+        // task workspace of its child when that is a task level too. A
+        // serial child takes its scratch from the leaf pool when it starts.
+        static const int uses_s[7] = {1, 1, 0, 0, 1, 1, 1};
+        static const int uses_t[7] = {1, 0, 1, 1, 0, 1, 1};
+        double *M1 = ws + 0 * c_elems;
+        double *M2 = ws + 1 * c_elems;
+        double *M3 = ws + 2 * c_elems;
+        double *M4 = ws + 3 * c_elems;
+        double *M5 = ws + 4 * c_elems;
+        double *next = ws + 5 * c_elems;
         
-        #pragma omp task shared(M4, A22, B21, B11)
-        {
-            double *t2 = matrix_allocate(half);
-            matrix_sub(B21, B11, t2, half);
-            matrix_zero_init(M4, half);
-            strassen_recursive_omp(A22, t2, M4, half, half, 0);
-            matrix_free(t2);
-        }
-        
-        #pragma omp task shared(M5, A11, A12, B22)
-        {
-            double *t1 = matrix_allocate(half);
-            matrix_add(A11, A12, t1, half);
-            matrix_zero_init(M5, half);
-            strassen_recursive_omp(t1, B22, M5, half, half, 0);
-            matrix_free(t1);
+        int child_depth = task_depth - 1;
+        int child_tasks = strassen_task_levels(hm, hn, hk, child_depth) > 0;
+        size_t child_elems = strassen_task_tree_elems(hm, hn, hk, child_depth);
+        double *S[7], *T[7], *child_ws[7];
+        for (int t = 0; t < 7; t++) {
+            S[t] = uses_s[t] ? next : NULL;
+            next += uses_s[t] ? a_elems : 0;
+            T[t] = uses_t[t] ? next : NULL;
+            next += uses_t[t] ? b_elems : 0;
+            child_ws[t] = next;
+            next += child_elems;
         }
         
-        #pragma omp task shared(M6, A21, A11, B11, B12)
+        #pragma omp taskgroup
         {
-            double *t1 = matrix_allocate(half);
-            double *t2 = matrix_allocate(half);
-            matrix_sub(A21, A11, t1, half);
-            matrix_add(B11, B12, t2, half);
-            matrix_zero_init(M6, half);
-            strassen_recursive_omp(t1, t2, M6, half, half, 0);
-            matrix_free(t1);
-            matrix_free(t2);
+            // Operand sums
+            #pragma omp task depend(out: S[0][0])
+            matrix_add_strided(hm, hk, A11, lda, A22, lda, S[0], hk);
+            #pragma omp task depend(out: T[0][0])
+            matrix_add_strided(hk, hn, B11, ldb, B22, ldb, T[0], hn);
+            #pragma omp task depend(out: S[1][0])
+            matrix_add_strided(hm, hk, A21, lda, A22, lda, S[1], hk);
+            #pragma omp task depend(out: T[2][0])
+            matrix_sub_strided(hk, hn, B12, ldb, B22, ldb, T[2], hn);
+            #pragma omp task depend(out: T[3][0])
+            matrix_sub_strided(hk, hn, B21, ldb, B11, ldb, T[3], hn);
+            #pragma omp task depend(out: S[4][0])
+            matrix_add_strided(hm, hk, A11, lda, A12, lda, S[4], hk);
+            #pragma omp task depend(out: S[5][0])
+            matrix_sub_strided(hm, hk, A21, lda, A11, lda, S[5], hk);
+            #pragma omp task depend(out: T[5][0])
+            matrix_add_strided(hk, hn, B11, ldb, B12, ldb, T[5], hn);
+            #pragma omp task depend(out: S[6][0])
+            matrix_sub_strided(hm, hk, A12, lda, A22, lda, S[6], hk);
+            #pragma omp task depend(out: T[6][0])
+            matrix_add_strided(hk, hn, B21, ldb, B22, ldb, T[6], hn);
+            
+            // Products
+            #pragma omp task depend(in: S[0][0], T[0][0]) depend(out: M1[0])
+            {
+                memset(M1, 0, c_elems * sizeof(double));
+                strassen_child_omp(hm, hn, hk, S[0], hk, T[0], hn, M1, hn, child_depth,
+                                   child_tasks ? child_ws[0] : NULL, pool, ordinal * 7 + 0);
+            }
+            #pragma omp task depend(in: S[1][0]) depend(out: M2[0])
+            {
+                memset(M2, 0, c_elems * sizeof(double));
+                strassen_child_omp(hm, hn, hk, S[1], hk, B11, ldb, M2, hn, child_depth,
+                                   child_tasks ? child_ws[1] : NULL, pool, ordinal * 7 + 1);
+            }
+            #pragma omp task depend(in: T[2][0]) depend(out: M3[0])
+            {
+                memset(M3, 0, c_elems * sizeof(double));
+                strassen_child_omp(hm, hn, hk, A11, lda, T[2], hn, M3, hn, child_depth,
+                                   child_tasks ? child_ws[2] : NULL, pool, ordinal * 7 + 2);
+            }
+            #pragma omp task depend(in: T[3][0]) depend(out: M4[0])
+            {
+                memset(M4, 0, c_elems * sizeof(double));
+                strassen_child_omp(hm, hn, hk, A22, lda, T[3], hn, M4, hn, child_depth,
+                                   child_tasks ? child_ws[3] : NULL, pool, ordinal * 7 + 3);
+            }
+            #pragma omp task depend(in: S[4][0]) depend(out: M5[0])
+            {
+                memset(M5, 0, c_elems * sizeof(double));
+                strassen_child_omp(hm, hn, hk, S[4], hk, B22, ldb, M5, hn, child_depth,
+                                   child_tasks ? child_ws[4] : NULL, pool, ordinal * 7 + 4);
+            }
+            #pragma omp task depend(in: S[5][0], T[5][0]) depend(out: C22[0])
+            strassen_child_omp(hm, hn, hk, S[5], hk, T[5], hn, C22, ldc, child_depth,
+                               child_tasks ? child_ws[5] : NULL, pool, ordinal * 7 + 5);
+            #pragma omp task depend(in: S[6][0], T[6][0]) depend(out: C11[0])
+            strassen_child_omp(hm, hn, hk, S[6], hk, T[6], hn, C11, ldc, child_depth,
+                               child_tasks ? child_ws[6] : NULL, pool, ordinal * 7 + 6);
+            
+            // Combine in row blocks. Blocks of one quadrant write disjoint
+            // rows, so they only read the dependence on the quadrant.
+            for (int r = 0; r < hm; r += STRASSEN_TASK_ROWS) {
+                int rows = (hm - r < STRASSEN_TASK_ROWS) ? hm - r : STRASSEN_TASK_ROWS;
+                size_t off = (size_t)r * hn;
+                size_t c_off = (size_t)r * ldc;
+                #pragma omp task depend(in: M1[0], M4[0], M5[0], C11[0])
+                combine_products(rows, hn, C11 + c_off, ldc, M1 + off, 1.0, M4 + off, 1.0,
+                                 M5 + off, -1.0);
+                #pragma omp task depend(in: M3[0], M5[0])
+                combine_products(rows, hn, C12 + c_off, ldc, M3 + off, 1.0, M5 + off, 1.0,
+                                 NULL, 0.0);
+                #pragma omp task depend(in: M2[0], M4[0])
+                combine_products(rows, hn, C21 + c_off, ldc, M2 + off, 1.0, M4 + off, 1.0,
+                                 NULL, 0.0);
+                #pragma omp task depend(in: M1[0], M2[0], M3[0], C22[0])
+                combine_products(rows, hn, C22 + c_off, ldc, M1 + off, 1.0, M2 + off, -1.0,
+                                 M3 + off, 1.0);
+            }
         }
         
-        #pragma omp task shared(M7, A12, A22, B21, B22)
-        {
-            double *t1 = matrix_allocate(half);
-            double *t2 = matrix_allocate(half);
-            matrix_sub(A12, A22, t1, half);
-            matrix_add(B21, B22, t2, half);
-            matrix_zero_init(M7, half);
-            strassen_recursive_omp(t1, t2, M7, half, half, 0);
-            matrix_free(t1);
-            matrix_free(t2);
+        // Peel in row slabs: every slab but the last has an even row count,
+        // so only the last one owns the odd row of C
+        if ((m | n | k) & 1) {
+            #pragma omp taskgroup
+            {
+                for (int r = 0; r < m; r += STRASSEN_TASK_ROWS) {
+                    int rows = (m - r <= STRASSEN_TASK_ROWS + 1) ? m - r : STRASSEN_TASK_ROWS;
+                    #pragma omp task
+                    matrix_peel_fixup(rows, n, k, A + (size_t)r * lda, lda, B, ldb,
+                                      C + (size_t)r * ldc, ldc, 1);
+                    if (rows != STRASSEN_TASK_ROWS) break;
+                }
+            }
         }
-        
-        #pragma omp taskwait
-        
-    } else {
-        // Serial execution for smaller problems
-        matrix_add(A11, A22, temp1, half);
-        matrix_add(B11, B22, temp2, half);
-        matrix_zero_init(M1, half);
-        strassen_recursive_omp(temp1, temp2, M1, half, half, 0);
-        
-        matrix_add(A21, A22, temp1, half);
-        matrix_zero_init(M2, half);
-        strassen_recursive_omp(temp1, B11, M2, half, half, 0);
-        
-        matrix_sub(B12, B22, temp2, half);
-        matrix_zero_init(M3, half);
-        strassen_recursive_omp(A11, temp2, M3, half, half, 0);
-        
-        matrix_sub(B21, B11, temp2, half);
-        matrix_zero_init(M4, half);
-        strassen_recursive_omp(A22, temp2, M4, half, half, 0);
-        
-        matrix_add(A11, A12, temp1, half);
-        matrix_zero_init(M5, half);
-        strassen_recursive_omp(temp1, B22, M5, half, half, 0);
-        
-        matrix_sub(A21, A11, temp1, half);
-        matrix_add(B11, B12, temp2, half);
-        matrix_zero_init(M6, half);
-        strassen_recursive_omp(temp1, temp2, M6, half, half, 0);
-        
-        matrix_sub(A12, A22, temp1, half);
-        matrix_add(B21, B22, temp2, half);
-        matrix_zero_init(M7, half);
-        strassen_recursive_omp(temp1, temp2, M7, half, half, 0);
+        return;
     }
     
-    // Combine results into C
-    for (int i = 0; i < half; i++) {
-        for (int j = 0; j < half; j++) {
-            C[i * stride + j] += M1[i * half + j] + M4[i * half + j] - M5[i * half + j] + M7[i * half + j];
-            C[i * stride + (j + half)] += M3[i * half + j] + M5[i * half + j];
-            C[(i + half) * stride + j] += M2[i * half + j] + M4[i * half + j];
-            C[(i + half) * stride + (j + half)] += M1[i * half + j] - M2[i * half + j] + M3[i * half + j] + M6[i * half + j];
+    // Serial execution for smaller problems: one product buffer, each
+    // product folded into C as soon as it is computed
+    double *TA = ws;
+    double *TB = TA + a_elems;
+    double *M = TB + b_elems;
+    double *child_ws = M + c_elems;
+    
+    matrix_add_strided(hm, hk, A11, lda, A22, lda, TA, hk);
+    matrix_add_strided(hk, hn, B11, ldb, B22, ldb, TB, hn);
+    memset(M, 0, c_elems * sizeof(double));
+    strassen_recursive_omp(hm, hn, hk, TA, hk, TB, hn, M, hn, 0, child_ws, pool, 0);
+    matrix_add_strided(hm, hn, C11, ldc, M, hn, C11, ldc);
+    matrix_add_strided(hm, hn, C22, ldc, M, hn, C22, ldc);
+    
+    matrix_add_strided(hm, hk, A21, lda, A22, lda, TA, hk);
+    memset(M, 0, c_elems * sizeof(double));
+    strassen_recursive_omp(hm, hn, hk, TA, hk, B11, ldb, M, hn, 0, child_ws, pool, 0);
+    matrix_add_strided(hm, hn, C21, ldc, M, hn, C21, ldc);
+    matrix_sub_strided(hm, hn, C22, ldc, M, hn, C22, ldc);
+    
+    matrix_sub_strided(hk, hn, B12, ldb, B22, ldb, TB, hn);
+    memset(M, 0, c_elems * sizeof(double));
+    strassen_recursive_omp(hm, hn, hk, A11, lda, TB, hn, M, hn, 0, child_ws, pool, 0);
+    matrix_add_strided(hm, hn, C12, ldc, M, hn, C12, ldc);
+    matrix_add_strided(hm, hn, C22, ldc, M, hn, C22, ldc);
+    
+    matrix_sub_strided(hk, hn, B21, ldb, B11, ldb, TB, hn);
+    memset(M, 0, c_elems * sizeof(double));
+    strassen_recursive_omp(hm, hn, hk, A22, lda, TB, hn, M, hn, 0, child_ws, pool, 0);
+    matrix_add_strided(hm, hn, C11, ldc, M, hn, C11, ldc);
+    matrix_add_strided(hm, hn, C21, ldc, M, hn, C21, ldc);
+    
+    matrix_add_strided(hm, hk, A11, lda, A12, lda, TA, hk);
+    memset(M, 0, c_elems * sizeof(double));
+    strassen_recursive_omp(hm, hn, hk, TA, hk, B22, ldb, M, hn, 0, child_ws, pool, 0);
+    matrix_sub_strided(hm, hn, C11, ldc, M, hn, C11, ldc);
+    matrix_add_strided(hm, hn, C12, ldc, M, hn, C12, ldc);
+    
+    matrix_sub_strided(hm, hk, A21, lda, A11, lda, TA, hk);
+    matrix_add_strided(hk, hn, B11, ldb, B12, ldb, TB, hn);
+    strassen_recursive_omp(hm, hn, hk, TA, hk, TB, hn, C22, ldc, 0, child_ws, pool, 0);
+    
+    matrix_sub_strided(hm, hk, A12, lda, A22, lda, TA, hk);
+    matrix_add_strided(hk, hn, B21, ldb, B22, ldb, TB, hn);
+    strassen_recursive_omp(hm, hn, hk, TA, hk, TB, hn, C11, ldc, 0, child_ws, pool, 0);
+    
+    // Peel: odd row, column and inner term of this level
+    matrix_peel_fixup(m, n, k, A, lda, B, ldb, C, ldc, 1);
+}
+
+void strassen_omp_team(int m, int n, int k,
+                       const double *A, int lda, const double *B, int ldb,
+                       double *C, int ldc, int task_depth, double *ws) {
+    // The recursion accumulates into C: the whole team clears it first, in
+    // the static row split used for first-touch placement
+    #pragma omp for schedule(static)
+    for (int i = 0; i < m; i++) {
+        memset(&C[(size_t)i * ldc], 0, (size_t)n * sizeof(double));
+    }
+
+    // The leaf pool follows the task levels (see strassen_omp_team_workspace)
+    int levels = strassen_task_levels(m, n, k, task_depth);
+    int team = 1;
+#ifdef _OPENMP
+    team = omp_get_num_threads();
+#endif
+    int lm = m, ln = n, lk = k;
+    strassen_leaf_shape(&lm, &ln, &lk, task_depth);
+    strassen_leaf_pool pool;
+    pool.base = ws + strassen_task_tree_elems(m, n, k, task_depth);
+    pool.slot_elems = strassen_serial_ws_elems(lm, ln, lk);
+    pool.by_thread = team <= strassen_leaf_count(levels);
+
+    // One thread walks the recursion; the rest of the team picks up its
+    // tasks at the barrier that closes the single construct
+    #pragma omp single
+    strassen_child_omp(m, n, k, A, lda, B, ldb, C, ldc, task_depth,
+                       levels > 0 ? ws : NULL, &pool, 0);
+}
+
+void strassen_omp_rect(int m, int n, int k,
+                       const double *A, int lda, const double *B, int ldb,
+                       double *C, int ldc) {
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_max_threads();
+#endif
+    int task_depth = strassen_omp_task_depth(m, n, k, nthreads);
+
+    // One allocation covers every level and every task; when it fails,
+    // fewer task levels need less
+    double *workspace = NULL;
+    for (;;) {
+        size_t ws_elems = strassen_omp_team_workspace(m, n, k, task_depth, nthreads);
+        if (ws_elems == 0) break;
+        workspace = (double *)mm_aligned_alloc(ws_elems * sizeof(double));
+        if (workspace) break;
+        if (task_depth == 0) {
+            fprintf(stderr, "strassen_omp: failed to allocate workspace, using naive multiply\n");
+            matrix_mul_strided(m, n, k, A, lda, B, ldb, C, ldc, 0);
+            return;
         }
+        task_depth--;
+        fprintf(stderr, "strassen_omp: workspace allocation failed, retrying with %d task levels\n",
+                task_depth);
     }
     
-    // Free temporary matrices
-    matrix_free(A11); matrix_free(A12); matrix_free(A21); matrix_free(A22);
-    matrix_free(B11); matrix_free(B12); matrix_free(B21); matrix_free(B22);
-    matrix_free(M1); matrix_free(M2); matrix_free(M3); matrix_free(M4);
-    matrix_free(M5); matrix_free(M6); matrix_free(M7);
-    matrix_free(temp1); matrix_free(temp2);
+    // Create parallel region for tasks
+    #pragma omp parallel num_threads(nthreads)
+    strassen_omp_team(m, n, k, A, lda, B, ldb, C, ldc, task_depth, workspace);
+    
+    mm_aligned_free(workspace);
 }
 
 void strassen_omp(double *A, double *B, double *C, int n) {
-    int padded_n = next_power_of_2_omp(n);
-    
-    if (padded_n != n) {
-        // Need padding
-        double *A_padded = matrix_allocate(padded_n);
-        double *B_padded = matrix_allocate(padded_n);
-        double *C_padded = matrix_allocate(padded_n);
-        
-        matrix_zero_init(A_padded, padded_n);
-        matrix_zero_init(B_padded, padded_n);
-        matrix_zero_init(C_padded, padded_n);
-        
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                A_padded[i * padded_n + j] = A[i * n + j];
-                B_padded[i * padded_n + j] = B[i * n + j];
-            }
-        }
-        
-        // Create parallel region for tasks
-        #pragma omp parallel
+    strassen_omp_rect(n, n, n, A, n, B, n, C, n);
+}
+
+// ========== STRASSEN-WINOGRAD (OpenMP) ==========
+// Below the parallel cutoff this follows the two-temporary schedule of
+// winograd_serial. At task levels the seven products run as OpenMP tasks, so
+// every product needs its own destination: P2..P5 go straight into the C
+// quadrants and P1, P6, P7 into three extra temporaries (11 per level).
+// Odd dimensions are peeled as in strassen_recursive_omp.
+
+// Workspace (in elements) for winograd_recursive_omp on an m x n x k problem.
+static size_t winograd_omp_workspace_elems(int m, int n, int k, int use_tasks) {
+    if (is_strassen_base(m, n, k)) return packed_gemm_small_workspace(m, n, k);
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    size_t a_elems = (size_t)hm * hk;
+    size_t b_elems = (size_t)hk * hn;
+    size_t c_elems = (size_t)hm * hn;
+    size_t child = winograd_omp_workspace_elems(hm, hn, hk, 0);
+    if (is_task_level(m, n, k, use_tasks)) {
+        return 4 * a_elems + 4 * b_elems + 3 * c_elems + 7 * child;
+    }
+    return (size_t)hm * (hk > hn ? hk : hn) + b_elems + child;
+}
+
+// C = A * B (overwrite) where C is m x n, A is m x k and B is k x n, each a
+// strided view with leading dimension lda/ldb/ldc.
+static void winograd_recursive_omp(int m, int n, int k,
+                                   const double *A, int lda, const double *B, int ldb,
+                                   double *C, int ldc, int use_tasks, double *ws) {
+    if (is_strassen_base(m, n, k)) {
+        packed_gemm_small(m, n, k, A, lda, B, ldb, C, ldc, 0, ws);
+        return;
+    }
+
+    int hm = m / 2, hn = n / 2, hk = k / 2;
+    size_t a_elems = (size_t)hm * hk;
+    size_t b_elems = (size_t)hk * hn;
+    size_t c_elems = (size_t)hm * hn;
+
+    const double *A11 = A, *A12 = A + hk, *A21 = A + hm * lda, *A22 = A + hm * lda + hk;
+    const double *B11 = B, *B12 = B + hn, *B21 = B + hk * ldb, *B22 = B + hk * ldb + hn;
+    double *C11 = C, *C12 = C + hn, *C21 = C + hm * ldc, *C22 = C + hm * ldc + hn;
+
+    if (is_task_level(m, n, k, use_tasks)) {
+        double *S1 = ws, *S2 = S1 + a_elems, *S3 = S2 + a_elems, *S4 = S3 + a_elems;
+        double *T1 = S4 + a_elems, *T2 = T1 + b_elems, *T3 = T2 + b_elems, *T4 = T3 + b_elems;
+        double *P1 = T4 + b_elems, *P6 = P1 + c_elems, *P7 = P6 + c_elems;
+        size_t child = winograd_omp_workspace_elems(hm, hn, hk, 0);
+        double *child_ws = P7 + c_elems;
+
+        // The A-side and B-side sums are independent chains
+        #pragma omp task
         {
-            #pragma omp single
-            {
-                strassen_recursive_omp(A_padded, B_padded, C_padded, padded_n, padded_n, 1);
-            }
+            matrix_add_strided(hm, hk, A21, lda, A22, lda, S1, hk);
+            matrix_sub_strided(hm, hk, S1, hk, A11, lda, S2, hk);
+            matrix_sub_strided(hm, hk, A11, lda, A21, lda, S3, hk);
+            matrix_sub_strided(hm, hk, A12, lda, S2, hk, S4, hk);
         }
-        
-        for (int i = 0; i < n; i++) {
-            for (int j = 0; j < n; j++) {
-                C[i * n + j] = C_padded[i * padded_n + j];
-            }
+        #pragma omp task
+        {
+            matrix_sub_strided(hk, hn, B12, ldb, B11, ldb, T1, hn);
+            matrix_sub_strided(hk, hn, B22, ldb, T1, hn, T2, hn);
+            matrix_sub_strided(hk, hn, B22, ldb, B12, ldb, T3, hn);
+            matrix_sub_strided(hk, hn, T2, hn, B21, ldb, T4, hn);
         }
-        
-        matrix_free(A_padded);
-        matrix_free(B_padded);
-        matrix_free(C_padded);
+        #pragma omp taskwait
+
+        #pragma omp task
+        winograd_recursive_omp(hm, hn, hk, A11, lda, B11, ldb, P1, hn, 0, child_ws + 0 * child);
+        #pragma omp task
+        winograd_recursive_omp(hm, hn, hk, A12, lda, B21, ldb, C11, ldc, 0, child_ws + 1 * child);
+        #pragma omp task
+        winograd_recursive_omp(hm, hn, hk, S4, hk, B22, ldb, C12, ldc, 0, child_ws + 2 * child);
+        #pragma omp task
+        winograd_recursive_omp(hm, hn, hk, A22, lda, T4, hn, C21, ldc, 0, child_ws + 3 * child);
+        #pragma omp task
+        winograd_recursive_omp(hm, hn, hk, S1, hk, T1, hn, C22, ldc, 0, child_ws + 4 * child);
+        #pragma omp task
+        winograd_recursive_omp(hm, hn, hk, S2, hk, T2, hn, P6, hn, 0, child_ws + 5 * child);
+        #pragma omp task
+        winograd_recursive_omp(hm, hn, hk, S3, hk, T3, hn, P7, hn, 0, child_ws + 6 * child);
+        #pragma omp taskwait
+
+        matrix_add_strided(hm, hn, P1, hn, P6, hn, P6, hn);            // U2 = P1 + P6
+        matrix_add_strided(hm, hn, P6, hn, P7, hn, P7, hn);            // U3 = U2 + P7
+        matrix_add_strided(hm, hn, P1, hn, C11, ldc, C11, ldc);        // U1 = P1 + P2
+        matrix_add_strided(hm, hn, C12, ldc, P6, hn, C12, ldc);        // P3 + U2
+        matrix_add_strided(hm, hn, C12, ldc, C22, ldc, C12, ldc);      // U5 = U4 + P3
+        matrix_sub_strided(hm, hn, P7, hn, C21, ldc, C21, ldc);        // U6 = U3 - P4
+        matrix_add_strided(hm, hn, P7, hn, C22, ldc, C22, ldc);        // U7 = U3 + P5
     } else {
-        // Already power of 2
-        matrix_zero_init(C, n);
-        
-        #pragma omp parallel
+        double *X = ws;
+        double *Y = ws + (size_t)hm * (hk > hn ? hk : hn);
+        double *child_ws = Y + b_elems;
+
+        matrix_sub_strided(hm, hk, A11, lda, A21, lda, X, hk);                      // S3
+        matrix_sub_strided(hk, hn, B22, ldb, B12, ldb, Y, hn);                      // T3
+        winograd_recursive_omp(hm, hn, hk, X, hk, Y, hn, C21, ldc, 0, child_ws);    // P7
+        matrix_add_strided(hm, hk, A21, lda, A22, lda, X, hk);                      // S1
+        matrix_sub_strided(hk, hn, B12, ldb, B11, ldb, Y, hn);                      // T1
+        winograd_recursive_omp(hm, hn, hk, X, hk, Y, hn, C22, ldc, 0, child_ws);    // P5
+        matrix_sub_strided(hm, hk, X, hk, A11, lda, X, hk);                         // S2
+        matrix_sub_strided(hk, hn, B22, ldb, Y, hn, Y, hn);                         // T2
+        winograd_recursive_omp(hm, hn, hk, X, hk, Y, hn, C12, ldc, 0, child_ws);    // P6
+        matrix_sub_strided(hm, hk, A12, lda, X, hk, X, hk);                         // S4
+        winograd_recursive_omp(hm, hn, hk, X, hk, B22, ldb, C11, ldc, 0, child_ws); // P3
+        winograd_recursive_omp(hm, hn, hk, A11, lda, B11, ldb, X, hn, 0, child_ws); // P1
+        matrix_add_strided(hm, hn, X, hn, C12, ldc, C12, ldc);                      // U2
+        matrix_add_strided(hm, hn, C12, ldc, C21, ldc, C21, ldc);                   // U3
+        matrix_add_strided(hm, hn, C12, ldc, C22, ldc, C12, ldc);                   // U4
+        matrix_add_strided(hm, hn, C21, ldc, C22, ldc, C22, ldc);                   // U7
+        matrix_add_strided(hm, hn, C12, ldc, C11, ldc, C12, ldc);                   // U5
+        matrix_sub_strided(hk, hn, Y, hn, B21, ldb, Y, hn);                         // T4
+        winograd_recursive_omp(hm, hn, hk, A22, lda, Y, hn, C11, ldc, 0, child_ws); // P4
+        matrix_sub_strided(hm, hn, C21, ldc, C11, ldc, C21, ldc);                   // U6
+        winograd_recursive_omp(hm, hn, hk, A12, lda, B21, ldb, C11, ldc, 0, child_ws); // P2
+        matrix_add_strided(hm, hn, X, hn, C11, ldc, C11, ldc);                      // U1
+    }
+
+    // Peel: odd row, column and inner term of this level
+    matrix_peel_fixup(m, n, k, A, lda, B, ldb, C, ldc, 0);
+}
+
+void winograd_omp_rect(int m, int n, int k,
+                       const double *A, int lda, const double *B, int ldb,
+                       double *C, int ldc) {
+    double *workspace = NULL;
+    size_t ws_elems = winograd_omp_workspace_elems(m, n, k, 1);
+    if (ws_elems > 0) {
+        workspace = (double *)mm_aligned_alloc(ws_elems * sizeof(double));
+        if (!workspace) {
+            fprintf(stderr, "winograd_omp: failed to allocate workspace, using naive multiply\n");
+            matrix_mul_strided(m, n, k, A, lda, B, ldb, C, ldc, 0);
+            return;
+        }
+    }
+
+    #pragma omp parallel
+    {
+        #pragma omp single
         {
-            #pragma omp single
-            {
-                strassen_recursive_omp(A, B, C, n, n, 1);
-            }
+            winograd_recursive_omp(m, n, k, A, lda, B, ldb, C, ldc, 1, workspace);
         }
     }
+
+    mm_aligned_free(workspace);
 }
 
-// ========== PROPOSED ALGORITHM (OpenMP) ==========
-#define BLOCK_SIZE_OMP 64
+void winograd_omp(double *A, double *B, double *C, int n) {
+    winograd_omp_rect(n, n, n, A, n, B, n, C, n);
+}
 
+// ========== PROPOSED ALGORITHM (OpenMP) ==========
+// Same packed-panel engine as proposed_serial; B panels are packed
+// cooperatively and each thread packs and multiplies its own row blocks of A.
 void proposed_omp(double *A, double *B, double *C, int n) {
-    // Step 1: Transpose B (serial is fine, not the bottleneck)
-    double *B_T = matrix_allocate(n);
-    matrix_transpose(B, B_T, n);
-    
-    // Step 2: Zero-initialize C
-    matrix_zero_init(C, n);
-    
-    // Step 3: Cache-blocked multiplication with OpenMP parallelization over tiles
-    // Parallelize over (ii, jj) - each thread gets a set of output tiles
-    // Do NOT parallelize kk to avoid race conditions on C
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int ii = 0; ii < n; ii += BLOCK_SIZE_OMP) {
-        for (int jj = 0; jj < n; jj += BLOCK_SIZE_OMP) {
-            int i_end = (ii + BLOCK_SIZE_OMP < n) ? ii + BLOCK_SIZE_OMP : n;
-            int j_end = (jj + BLOCK_SIZE_OMP < n) ? jj + BLOCK_SIZE_OMP : n;
-            
-            // Loop over k blocks (serial within each thread)
-            for (int kk = 0; kk < n; kk += BLOCK_SIZE_OMP) {
-                int k_end = (kk + BLOCK_SIZE_OMP < n) ? kk + BLOCK_SIZE_OMP : n;
-                
-                // Inner block computation
-                for (int i = ii; i < i_end; i++) {
-                    for (int j = jj; j < j_end; j++) {
-                        double sum = 0.0;
-                        for (int k = kk; k < k_end; k++) {
-                            sum += A[i * n + k] * B_T[j * n + k];
-                        }
-                        C[i * n + j] += sum;
-                    }
-                }
-            }
-        }
-    }
-    
-    // Step 4: Clean up
-    matrix_free(B_T);
+    packed_gemm(n, n, n, A, n, B, n, C, n, 0, 1);
+}
+
+void proposed_omp_epilogue(double *A, double *B, double *C, int n, const mm_epilogue *ep) {
+    packed_gemm_epilogue(n, n, n, A, n, B, n, C, n, ep, 1);
+}
+
+// ========== CACHE-OBLIVIOUS ALGORITHM (OpenMP) ==========
+// Same recursion as oblivious_serial; conversions are split across the team
+// and independent m/n halves become tasks.
+void oblivious_omp(double *A, double *B, double *C, int n) {
+    oblivious_gemm(n, n, n, A, n, B, n, C, n, 1);
 }
@@ -0,0 +1,446 @@
+// packed_gemm.c
+// Packed-panel GEMM engine: cache-sized packing of A and B plus an
+// MR x NR register-blocked micro-kernel (serial and OpenMP drivers).
+// The micro-kernel and its tile shape come from the SIMD dispatch table.
+
+#include "packed_gemm.h"
+#include "simd_kernels.h"
+#include "tile_sched.h"
+#include "tuning.h"
+#include "utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// Tiles queued per thread when a team splits one B panel; a few per thread
+// leaves room for stealing to even out uneven row blocks and slow cores.
+#define SCHED_TILES_PER_THREAD 4
+
+static int min_int(int a, int b) {
+    return (a < b) ? a : b;
+}
+
+static int round_up(int value, int multiple) {
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+// Fallback used only when the packing buffers cannot be allocated.
+// C += alpha * op(A) * op(B) (C already scaled by beta) or, when
+// accumulate == 0, C = alpha * op(A) * op(B).
+static void gemm_unpacked(int trans_a, int trans_b, int m, int n, int k, double alpha,
+                          const double *A, int lda,
+                          const double *B, int ldb,
+                          double *C, int ldc, int accumulate) {
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (int p = 0; p < k; p++) {
+                double a = trans_a ? A[p * lda + i] : A[i * lda + p];
+                double b = trans_b ? B[j * ldb + p] : B[p * ldb + j];
+                sum += a * b;
+            }
+            C[i * ldc + j] = (accumulate ? C[i * ldc + j] : 0.0) + alpha * sum;
+        }
+    }
+}
+
+// Pack an mc x kc block of op(A) into mr-tall micro-panels, scaled by alpha.
+// Layout: panel r holds op(A)[r*mr .. r*mr+mr-1][0..kc-1] column by column,
+// so the micro-kernel reads mr consecutive values per k step. A points at
+// element (0, 0) of the block; with trans_a it is stored k x m.
+static void pack_A(int mc, int kc, const double *A, int lda, double *Ap, int mr,
+                   int trans_a, double alpha) {
+    for (int ir = 0; ir < mc; ir += mr) {
+        int rows = min_int(mr, mc - ir);
+        for (int p = 0; p < kc; p++) {
+            if (trans_a) {
+                const double *a_col = &A[p * lda + ir];
+                for (int i = 0; i < rows; i++) {
+                    Ap[p * mr + i] = alpha * a_col[i];
+                }
+            } else {
+                for (int i = 0; i < rows; i++) {
+                    Ap[p * mr + i] = alpha * A[(ir + i) * lda + p];
+                }
+            }
+            for (int i = rows; i < mr; i++) {
+                Ap[p * mr + i] = 0.0;
+            }
+        }
+        Ap += mr * kc;
+    }
+}
+
+// Pack one nr-wide micro-panel of a kc x nc panel of op(B) (row by row).
+// B points at element (0, 0) of the panel; with trans_b it is stored n x k.
+static void pack_B_panel(int kc, int cols, const double *B, int ldb, double *Bp, int nr,
+                         int trans_b) {
+    for (int p = 0; p < kc; p++) {
+        if (trans_b) {
+            for (int j = 0; j < cols; j++) {
+                Bp[p * nr + j] = B[j * ldb + p];
+            }
+        } else {
+            for (int j = 0; j < cols; j++) {
+                Bp[p * nr + j] = B[p * ldb + j];
+            }
+        }
+        for (int j = cols; j < nr; j++) {
+            Bp[p * nr + j] = 0.0;
+        }
+    }
+}
+
+// C = beta * C over an mc x nc block (beta == 0 clears it without reading).
+static void scale_block(int mc, int nc, double beta, double *C, int ldc) {
+    for (int i = 0; i < mc; i++) {
+        double *c_row = &C[i * ldc];
+        for (int j = 0; j < nc; j++) {
+            c_row[j] = (beta == 0.0) ? 0.0 : beta * c_row[j];
+        }
+    }
+}
+
+// Multiply a packed mc x kc block of A by a packed kc x nc panel of B.
+// post (NULL on all but the last k block) is applied to each register tile
+// as soon as the micro-kernel has stored it; (row0, col0) is the position
+// of this C block in the whole C, for the bias vectors.
+static void macro_kernel(const simd_kernel_table *simd, int mc, int nc, int kc,
+                         const double *Ap, const double *Bp,
+                         double *C, int ldc, int accumulate,
+                         const mm_epilogue *post, int row0, int col0) {
+    int MR = simd->mr;
+    int NR = simd->nr;
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = min_int(NR, nc - jr);
+        for (int ir = 0; ir < mc; ir += MR) {
+            int mr = min_int(MR, mc - ir);
+            simd->gemm_ukernel(kc, Ap + ir * kc, Bp + jr * kc,
+                               &C[ir * ldc + jr], ldc, mr, nr, accumulate);
+            if (post) {
+                mm_epilogue_post(post, mr, nr, row0 + ir, col0 + jr, &C[ir * ldc + jr], ldc);
+            }
+        }
+    }
+}
+
+void packed_gemm(int m, int n, int k,
+                 const double *A, int lda,
+                 const double *B, int ldb,
+                 double *C, int ldc,
+                 int accumulate, int use_omp) {
+    packed_gemm_ex(0, 0, m, n, k, 1.0, A, lda, B, ldb,
+                   accumulate ? 1.0 : 0.0, C, ldc, use_omp);
+}
+
+// Blocking of one call, derived identically by every thread that asks.
+typedef struct {
+    int MR, NR;
+    int MC, KC, NC;
+    int mc_block;   // row block per thread (MC shrunk for small m)
+    int nc_alloc;   // columns of the packed B panel buffer
+    int kc_alloc;   // depth of the packed buffers
+} packed_plan;
+
+static packed_plan make_plan(const simd_kernel_table *simd, int m, int n, int k, int nthreads) {
+    packed_plan plan;
+    plan.MR = simd->mr;
+    plan.NR = simd->nr;
+
+    // Blocking from the tuning profile, read once so every thread of this
+    // call agrees on it
+    const mm_tuning_params *tune = mm_tuning();
+    plan.MC = round_up(tune->mc, plan.MR);
+    plan.KC = tune->kc;
+    plan.NC = round_up(tune->nc, plan.NR);
+
+    // Shrink the row block when there are fewer MC blocks than threads so
+    // every thread gets work on mid-size problems.
+    plan.mc_block = plan.MC;
+    if (nthreads > 1) {
+        int per_thread = round_up((m + nthreads - 1) / nthreads, plan.MR);
+        if (per_thread < plan.mc_block) plan.mc_block = per_thread;
+    }
+
+    plan.nc_alloc = min_int(plan.NC, round_up(n, plan.NR));
+    plan.kc_alloc = min_int(plan.KC, k);
+    return plan;
+}
+
+// Packing buffer sizes (elements) for plan: one shared B panel, one A block
+// per thread.
+static size_t plan_bp_elems(const packed_plan *plan) {
+    return (size_t)plan->kc_alloc * plan->nc_alloc;
+}
+
+static size_t plan_ap_elems(const packed_plan *plan) {
+    return (size_t)plan->mc_block * plan->kc_alloc;
+}
+
+// Loop nest of one multiply. Called by every thread of the current team
+// (a team of one outside parallel regions); a worksharing loop splits B
+// packing across that team, and the C tiles of each B panel (row block x
+// column chunk, numbered row-major so consecutive tiles share a packed A
+// block) go through the work-stealing scheduler in tile_sched.h. deques
+// holds one slot per thread of the team. beta == 0 overwrites C and
+// beta == 1 accumulates; any other beta is applied to each C tile by the
+// thread that runs it just before its first k block, so scaling C costs no
+// separate (serial) pass. post (bias / op, may be NULL) is fused the same
+// way into the last k block.
+static void packed_gemm_body(const simd_kernel_table *simd, const packed_plan *plan,
+                             int trans_a, int trans_b, int m, int n, int k, double alpha,
+                             const double *A, int lda, const double *B, int ldb,
+                             double beta, double *C, int ldc, const mm_epilogue *post,
+                             double *Bp, double *Ap_all, mm_tile_deque *deques) {
+    int MR = plan->MR;
+    int NR = plan->NR;
+    int KC = plan->KC;
+    int NC = plan->NC;
+    int mc_block = plan->mc_block;
+
+    int tid = 0;
+    int team = 1;
+#ifdef _OPENMP
+    tid = omp_get_thread_num();
+    team = omp_get_num_threads();
+#endif
+    double *Ap = Ap_all + (size_t)tid * plan_ap_elems(plan);
+    int accumulate = (beta != 0.0);
+    int prescale = accumulate && beta != 1.0;
+    int row_blocks = (m + mc_block - 1) / mc_block;
+    double busy = 0.0;
+    long tiles_run = 0;
+    long steals = 0;
+
+    for (int jc = 0; jc < n; jc += NC) {
+        int nc = min_int(NC, n - jc);
+        int panels = (nc + NR - 1) / NR;
+
+        // Split the panel into column chunks (whole micro-panels) only when
+        // there are too few row blocks to give every thread several tiles
+        int col_tiles = 1;
+        if (team > 1) {
+            col_tiles = (SCHED_TILES_PER_THREAD * team + row_blocks - 1) / row_blocks;
+            if (col_tiles > panels) col_tiles = panels;
+        }
+        int chunk = ((panels + col_tiles - 1) / col_tiles) * NR;
+        col_tiles = (nc + chunk - 1) / chunk;
+        int tiles = row_blocks * col_tiles;
+
+        for (int pc = 0; pc < k; pc += KC) {
+            int kc = min_int(KC, k - pc);
+            // The first k block overwrites C unless the caller accumulates,
+            // which fuses the zeroing of C into the multiply.
+            int acc = accumulate || pc > 0;
+            const mm_epilogue *tile_post = (pc + kc >= k) ? post : NULL;
+
+            // Refill this thread's deque; the barrier closing the B packing
+            // loop publishes every deque before anyone steals
+            tile_sched_init(deques, team, tid, tiles);
+
+            #pragma omp for schedule(static)
+            for (int jp = 0; jp < panels; jp++) {
+                int jr = jp * NR;
+                const double *B_panel = trans_b ? &B[(jc + jr) * ldb + pc]
+                                                : &B[pc * ldb + jc + jr];
+                pack_B_panel(kc, min_int(NR, nc - jr), B_panel, ldb, Bp + jr * kc,
+                             NR, trans_b);
+            }
+
+            int packed_rb = -1;
+            int stolen = 0;
+            int tile;
+            while ((tile = tile_sched_next(deques, team, tid, &stolen)) >= 0) {
+                double start = tile_sched_clock();
+                int rb = tile / col_tiles;
+                int jt = (tile % col_tiles) * chunk;
+                int ic = rb * mc_block;
+                int mc = min_int(mc_block, m - ic);
+                int ncols = min_int(chunk, nc - jt);
+                double *C_tile = &C[ic * ldc + jc + jt];
+                if (rb != packed_rb) {
+                    const double *A_block = trans_a ? &A[pc * lda + ic] : &A[ic * lda + pc];
+                    pack_A(mc, kc, A_block, lda, Ap, MR, trans_a, alpha);
+                    packed_rb = rb;
+                }
+                if (prescale && pc == 0) {
+                    scale_block(mc, ncols, beta, C_tile, ldc);
+                }
+                macro_kernel(simd, mc, ncols, kc, Ap, Bp + jt * kc, C_tile, ldc, acc,
+                             tile_post, ic, jc + jt);
+                busy += tile_sched_clock() - start;
+                tiles_run++;
+                steals += stolen;
+            }
+
+            // Bp and the deques are reused by the next k block
+            #pragma omp barrier
+        }
+    }
+    mm_sched_record(tid, team, busy, tiles_run, steals);
+}
+
+// packed_gemm_ex plus an optional fused bias / op (post).
+static void packed_gemm_run(int trans_a, int trans_b, int m, int n, int k,
+                            double alpha, const double *A, int lda,
+                            const double *B, int ldb,
+                            double beta, double *C, int ldc,
+                            const mm_epilogue *post, int use_omp) {
+    if (m <= 0 || n <= 0) return;
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    if (use_omp) {
+        nthreads = omp_get_max_threads();
+    }
+#endif
+
+    // beta == 0 overwrites C (BLAS semantics: C is not read); other values
+    // of beta are fused into the tile loop (packed_gemm_body).
+    if (k <= 0 || alpha == 0.0) {
+        if (beta != 1.0) {
+            #pragma omp parallel for schedule(static) num_threads(nthreads) if(nthreads > 1)
+            for (int i = 0; i < m; i++) {
+                scale_block(1, n, beta, &C[i * ldc], ldc);
+            }
+        }
+        if (post) {
+            #pragma omp parallel for schedule(static) num_threads(nthreads) if(nthreads > 1)
+            for (int i = 0; i < m; i++) {
+                mm_epilogue_post(post, 1, n, i, 0, &C[i * ldc], ldc);
+            }
+        }
+        return;
+    }
+
+    const simd_kernel_table *simd = simd_kernels();
+    packed_plan plan = make_plan(simd, m, n, k, nthreads);
+    double *Bp = (double *)mm_aligned_alloc(plan_bp_elems(&plan) * sizeof(double));
+    double *Ap_all = (double *)mm_aligned_alloc((size_t)nthreads * plan_ap_elems(&plan) * sizeof(double));
+    mm_tile_deque *deques = (mm_tile_deque *)mm_aligned_alloc((size_t)nthreads * sizeof(mm_tile_deque));
+    if (!Bp || !Ap_all || !deques) {
+        fprintf(stderr, "packed_gemm: failed to allocate packing buffers, using unpacked loop\n");
+        mm_aligned_free(Bp);
+        mm_aligned_free(Ap_all);
+        mm_aligned_free(deques);
+        if (beta != 0.0 && beta != 1.0) {
+            scale_block(m, n, beta, C, ldc);
+        }
+        gemm_unpacked(trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb, C, ldc, beta != 0.0);
+        mm_epilogue_post(post, m, n, 0, 0, C, ldc);
+        return;
+    }
+
+    #pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+    packed_gemm_body(simd, &plan, trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb,
+                     beta, C, ldc, post, Bp, Ap_all, deques);
+
+    mm_aligned_free(Bp);
+    mm_aligned_free(Ap_all);
+    mm_aligned_free(deques);
+}
+
+void packed_gemm_ex(int trans_a, int trans_b, int m, int n, int k,
+                    double alpha, const double *A, int lda,
+                    const double *B, int ldb,
+                    double beta, double *C, int ldc, int use_omp) {
+    packed_gemm_run(trans_a, trans_b, m, n, k, alpha, A, lda, B, ldb, beta, C, ldc,
+                    NULL, use_omp);
+}
+
+void packed_gemm_epilogue(int m, int n, int k,
+                          const double *A, int lda,
+                          const double *B, int ldb,
+                          double *C, int ldc,
+                          const mm_epilogue *ep, int use_omp) {
+    if (!ep) {
+        packed_gemm(m, n, k, A, lda, B, ldb, C, ldc, 0, use_omp);
+        return;
+    }
+    packed_gemm_run(0, 0, m, n, k, ep->alpha, A, lda, B, ldb, ep->beta, C, ldc,
+                    mm_epilogue_has_post(ep) ? ep : NULL, use_omp);
+}
+
+size_t packed_gemm_team_workspace(int m, int n, int k, int nthreads) {
+    if (m <= 0 || n <= 0 || k <= 0) return 0;
+    if (nthreads < 1) nthreads = 1;
+    packed_plan plan = make_plan(simd_kernels(), m, n, k, nthreads);
+    return plan_bp_elems(&plan) + (size_t)nthreads * plan_ap_elems(&plan) +
+           MM_TILE_DEQUE_ELEMS(nthreads);
+}
+
+void packed_gemm_team(int m, int n, int k,
+                      const double *A, int lda,
+                      const double *B, int ldb,
+                      double *C, int ldc,
+                      int accumulate, double *ws) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0) {
+        if (!accumulate) {
+            #pragma omp for schedule(static)
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < n; j++) {
+                    C[i * ldc + j] = 0.0;
+                }
+            }
+        }
+        return;
+    }
+
+    int nthreads = 1;
+#ifdef _OPENMP
+    nthreads = omp_get_num_threads();
+#endif
+    const simd_kernel_table *simd = simd_kernels();
+    packed_plan plan = make_plan(simd, m, n, k, nthreads);
+    double *Ap_all = ws + plan_bp_elems(&plan);
+    mm_tile_deque *deques = (mm_tile_deque *)(Ap_all + (size_t)nthreads * plan_ap_elems(&plan));
+    packed_gemm_body(simd, &plan, 0, 0, m, n, k, 1.0, A, lda, B, ldb,
+                     accumulate ? 1.0 : 0.0, C, ldc, NULL, ws, Ap_all, deques);
+}
+
+size_t packed_gemm_small_workspace(int m, int n, int k) {
+    if (m <= 0 || n <= 0 || k <= 0) return 0;
+    packed_plan plan = make_plan(simd_kernels(), m, n, k, 1);
+    return plan_bp_elems(&plan) + plan_ap_elems(&plan);
+}
+
+void packed_gemm_small(int m, int n, int k,
+                       const double *A, int lda,
+                       const double *B, int ldb,
+                       double *C, int ldc,
+                       int accumulate, double *ws) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0) {
+        if (!accumulate) scale_block(m, n, 0.0, C, ldc);
+        return;
+    }
+
+    const simd_kernel_table *simd = simd_kernels();
+    packed_plan plan = make_plan(simd, m, n, k, 1);
+    double *Bp = ws;
+    double *Ap = ws + plan_bp_elems(&plan);
+
+    // Same loop nest as packed_gemm_body without worksharing or scheduler,
+    // so it may run on any one thread of an enclosing team
+    for (int jc = 0; jc < n; jc += plan.NC) {
+        int nc = min_int(plan.NC, n - jc);
+        for (int pc = 0; pc < k; pc += plan.KC) {
+            int kc = min_int(plan.KC, k - pc);
+            int acc = accumulate || pc > 0;
+            for (int jr = 0; jr < nc; jr += plan.NR) {
+                pack_B_panel(kc, min_int(plan.NR, nc - jr), &B[pc * ldb + jc + jr], ldb,
+                             Bp + jr * kc, plan.NR, 0);
+            }
+            for (int ic = 0; ic < m; ic += plan.mc_block) {
+                int mc = min_int(plan.mc_block, m - ic);
+                pack_A(mc, kc, &A[ic * lda + pc], lda, Ap, plan.MR, 0, 1.0);
+                macro_kernel(simd, mc, nc, kc, Ap, Bp, &C[ic * ldc + jc], ldc, acc,
+                             NULL, 0, 0);
+            }
+        }
+    }
+}
@@ -0,0 +1,115 @@
+// packed_gemm.h
+// Packed-panel GEMM engine (GotoBLAS/BLIS-style) behind the "proposed" kernels.
+
+#ifndef PACKED_GEMM_H
+#define PACKED_GEMM_H
+
+#include "epilogue.h"
+#include <stddef.h>
+
+// Register tile: the micro-kernel keeps an MR x NR block of C in registers
+// for the whole k loop. MR/NR come from the SIMD dispatch table
+// (simd_kernels.h): 4x8 for scalar/AVX2/NEON, 8x8 for AVX-512.
+
+// Cache blocking (in elements) comes from the tuning profile (tuning.h:
+// mc/kc/nc). With the defaults:
+//   KC x NR sliver of packed B  -> L1   (256 * 8 * 8B  = 16KB)
+//   MC x KC block of packed A   -> L2   (128 * 256 * 8B = 256KB)
+//   KC x NC panel of packed B   -> L3   (256 * 4096 * 8B = 8MB)
+// MC is rounded up to a multiple of MR and NC to a multiple of NR.
+
+// packed_gemm
+// Input:
+//   m, n, k:    C is m x n, A is m x k, B is k x n (all row-major).
+//   A, lda:     A with leading dimension lda >= k.
+//   B, ldb:     B with leading dimension ldb >= n.
+//   C, ldc:     C with leading dimension ldc >= n.
+//   accumulate: 0 overwrites C with A*B, non-zero computes C += A*B.
+//   use_omp:    non-zero parallelizes packing and tiles of C across the
+//               OpenMP team (ignored in builds without OpenMP).
+// Behavior:
+//   Packs B into KC x NC panels of NR-wide micro-panels and A into MC x KC
+//   blocks of MR-tall micro-panels, then drives the register-blocked
+//   micro-kernel over every MR x NR tile of C. Edge tiles are zero-padded in
+//   the packed buffers, so any m, n, k >= 0 is supported. With a team, the
+//   C tiles under each B panel (row block x column chunk) are dealt out by
+//   the work-stealing scheduler (tile_sched.h), whose per-thread busy time
+//   is available through mm_sched_stats_get.
+// Complexity:
+//   Time O(m*n*k), extra space O(KC*NC + threads*MC*KC).
+void packed_gemm(int m, int n, int k,
+                 const double *A, int lda,
+                 const double *B, int ldb,
+                 double *C, int ldc,
+                 int accumulate, int use_omp);
+
+// packed_gemm_ex
+// Input:
+//   trans_a, trans_b: non-zero to use the transpose of A / B. A transposed A
+//               is stored k x m (lda >= m), a transposed B n x k (ldb >= k).
+//   alpha, beta: scalars of C = alpha * op(A) * op(B) + beta * C.
+//   Remaining arguments as packed_gemm.
+// Behavior:
+//   Transposes are absorbed by the packing routines and alpha is folded into
+//   the packed A block, so neither costs an extra pass. beta == 0 overwrites C
+//   without reading it; other values scale each C block inside the tile
+//   loop, by the thread that multiplies into it, just before its first k
+//   block.
+void packed_gemm_ex(int trans_a, int trans_b, int m, int n, int k,
+                    double alpha, const double *A, int lda,
+                    const double *B, int ldb,
+                    double beta, double *C, int ldc, int use_omp);
+
+// packed_gemm_epilogue
+// Input: as packed_gemm, plus ep (epilogue.h; NULL is the plain product).
+// Behavior:
+//   C = op(alpha * A * B + beta * C + row_bias + col_bias). alpha and beta
+//   are handled as in packed_gemm_ex; bias and op are applied to each
+//   MR x NR register tile by the thread that computed it, right after the
+//   micro-kernel stores the tile's last k block, so the epilogue reads and
+//   writes C only while the tile is in L1 and no pass over C remains.
+void packed_gemm_epilogue(int m, int n, int k,
+                          const double *A, int lda,
+                          const double *B, int ldb,
+                          double *C, int ldc,
+                          const mm_epilogue *ep, int use_omp);
+
+// packed_gemm_team_workspace
+// Output: scratch (in elements) that packed_gemm_team needs for an
+//   m x n x k multiply on a team of nthreads threads.
+size_t packed_gemm_team_workspace(int m, int n, int k, int nthreads);
+
+// packed_gemm_team
+// Input: as packed_gemm, plus ws (packed_gemm_team_workspace elements for
+//   the size of the current team).
+// Behavior:
+//   Same multiply as packed_gemm, but for callers that already run a team:
+//   every thread of the innermost enclosing parallel region must call it
+//   with the same arguments, and it splits the work across that team with
+//   orphaned worksharing loops and the tile scheduler instead of opening a
+//   region. Outside any
+//   parallel region it runs serially. Uses only ws; nothing is allocated.
+void packed_gemm_team(int m, int n, int k,
+                      const double *A, int lda,
+                      const double *B, int ldb,
+                      double *C, int ldc,
+                      int accumulate, double *ws);
+
+// packed_gemm_small_workspace
+// Output: scratch (in elements) that packed_gemm_small needs for an
+//   m x n x k multiply.
+size_t packed_gemm_small_workspace(int m, int n, int k);
+
+// packed_gemm_small
+// Input: as packed_gemm, plus ws (packed_gemm_small_workspace elements).
+// Behavior:
+//   Same multiply as packed_gemm on the calling thread alone: no parallel
+//   region, worksharing or allocation, so each thread of a team can run its
+//   own small multiply (batched GEMM, mm_context small jobs).
+void packed_gemm_small(int m, int n, int k,
+                       const double *A, int lda,
+                       const double *B, int ldb,
+                       double *C, int ldc,
+                       int accumulate, double *ws);
+
+#endif // PACKED_GEMM_H
@@ -0,0 +1,383 @@
+// packed_gemm_f32.c
+// fp32 and mixed-precision (fp32 storage, fp64 accumulation) drivers of the
+// packed-panel engine. Loop structure and blocking mirror packed_gemm.c.
+
+#include "packed_gemm_f32.h"
+#include "simd_kernels.h"
+#include "tuning.h"
+#include "utility.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static int min_int(int a, int b) {
+    return (a < b) ? a : b;
+}
+
+static int round_up(int value, int multiple) {
+    return ((value + multiple - 1) / multiple) * multiple;
+}
+
+static int team_size(int use_omp) {
+    int nthreads = 1;
+#ifdef _OPENMP
+    if (use_omp) {
+        nthreads = omp_get_max_threads();
+    }
+#endif
+    return nthreads;
+}
+
+// Row block per thread; shrunk when there are fewer MC blocks than threads.
+static int row_block(int m, int MC, int MR, int nthreads) {
+    int mc_block = MC;
+    if (nthreads > 1) {
+        int per_thread = round_up((m + nthreads - 1) / nthreads, MR);
+        if (per_thread < mc_block) mc_block = per_thread;
+    }
+    return mc_block;
+}
+
+// Fallback used only when the packing buffers cannot be allocated.
+// wide != 0 accumulates in fp64 (mixed mode).
+static void gemm_unpacked_f32(int m, int n, int k, const float *A, int lda,
+                              const float *B, int ldb, float *C, int ldc,
+                              int accumulate, int wide) {
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            if (wide) {
+                double sum = accumulate ? (double)C[i * ldc + j] : 0.0;
+                for (int p = 0; p < k; p++) {
+                    sum += (double)A[i * lda + p] * (double)B[p * ldb + j];
+                }
+                C[i * ldc + j] = (float)sum;
+            } else {
+                float sum = 0.0f;
+                for (int p = 0; p < k; p++) {
+                    sum += A[i * lda + p] * B[p * ldb + j];
+                }
+                C[i * ldc + j] = (accumulate ? C[i * ldc + j] : 0.0f) + sum;
+            }
+        }
+    }
+}
+
+// ========== fp32 ==========
+
+// Same micro-panel layouts as pack_A / pack_B_panel in packed_gemm.c.
+static void pack_A_f32(int mc, int kc, const float *A, int lda, float *Ap, int mr) {
+    for (int ir = 0; ir < mc; ir += mr) {
+        int rows = min_int(mr, mc - ir);
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < rows; i++) {
+                Ap[p * mr + i] = A[(ir + i) * lda + p];
+            }
+            for (int i = rows; i < mr; i++) {
+                Ap[p * mr + i] = 0.0f;
+            }
+        }
+        Ap += mr * kc;
+    }
+}
+
+static void pack_B_panel_f32(int kc, int cols, const float *B, int ldb, float *Bp, int nr) {
+    for (int p = 0; p < kc; p++) {
+        for (int j = 0; j < cols; j++) {
+            Bp[p * nr + j] = B[p * ldb + j];
+        }
+        for (int j = cols; j < nr; j++) {
+            Bp[p * nr + j] = 0.0f;
+        }
+    }
+}
+
+static void macro_kernel_f32(const simd_kernel_table *simd, int mc, int nc, int kc,
+                             const float *Ap, const float *Bp,
+                             float *C, int ldc, int accumulate) {
+    int MR = simd->smr;
+    int NR = simd->snr;
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = min_int(NR, nc - jr);
+        for (int ir = 0; ir < mc; ir += MR) {
+            int mr = min_int(MR, mc - ir);
+            simd->sgemm_ukernel(kc, Ap + ir * kc, Bp + jr * kc,
+                                &C[ir * ldc + jr], ldc, mr, nr, accumulate);
+        }
+    }
+}
+
+void packed_sgemm(int m, int n, int k,
+                  const float *A, int lda,
+                  const float *B, int ldb,
+                  float *C, int ldc,
+                  int accumulate, int use_omp) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0) {
+        if (!accumulate) {
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < n; j++) {
+                    C[i * ldc + j] = 0.0f;
+                }
+            }
+        }
+        return;
+    }
+
+    const simd_kernel_table *simd = simd_kernels();
+    int MR = simd->smr;
+    int NR = simd->snr;
+
+    const mm_tuning_params *tune = mm_tuning();
+    int MC = round_up(tune->mc, MR);
+    int KC = tune->kc;
+    int NC = round_up(tune->nc, NR);
+
+    int nthreads = team_size(use_omp);
+    int mc_block = row_block(m, MC, MR, nthreads);
+
+    int nc_alloc = min_int(NC, round_up(n, NR));
+    int kc_alloc = min_int(KC, k);
+    float *Bp = (float *)mm_aligned_alloc((size_t)kc_alloc * nc_alloc * sizeof(float));
+    float *Ap_all = (float *)mm_aligned_alloc((size_t)nthreads * mc_block * kc_alloc * sizeof(float));
+    if (!Bp || !Ap_all) {
+        fprintf(stderr, "packed_sgemm: failed to allocate packing buffers, using unpacked loop\n");
+        mm_aligned_free(Bp);
+        mm_aligned_free(Ap_all);
+        gemm_unpacked_f32(m, n, k, A, lda, B, ldb, C, ldc, accumulate, 0);
+        return;
+    }
+
+    #pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+    {
+        int tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        float *Ap = Ap_all + (size_t)tid * mc_block * kc_alloc;
+
+        for (int jc = 0; jc < n; jc += NC) {
+            int nc = min_int(NC, n - jc);
+            int panels = (nc + NR - 1) / NR;
+
+            for (int pc = 0; pc < k; pc += KC) {
+                int kc = min_int(KC, k - pc);
+                int acc = accumulate || pc > 0;
+
+                #pragma omp for schedule(static)
+                for (int jp = 0; jp < panels; jp++) {
+                    int jr = jp * NR;
+                    pack_B_panel_f32(kc, min_int(NR, nc - jr), &B[pc * ldb + jc + jr], ldb,
+                                     Bp + jr * kc, NR);
+                }
+
+                #pragma omp for schedule(dynamic)
+                for (int ic = 0; ic < m; ic += mc_block) {
+                    int mc = min_int(mc_block, m - ic);
+                    pack_A_f32(mc, kc, &A[ic * lda + pc], lda, Ap, MR);
+                    macro_kernel_f32(simd, mc, nc, kc, Ap, Bp, &C[ic * ldc + jc], ldc, acc);
+                }
+            }
+        }
+    }
+
+    mm_aligned_free(Bp);
+    mm_aligned_free(Ap_all);
+}
+
+size_t packed_sgemm_small_workspace(int m, int n, int k) {
+    if (m <= 0 || n <= 0 || k <= 0) return 0;
+    const simd_kernel_table *simd = simd_kernels();
+    const mm_tuning_params *tune = mm_tuning();
+    int MC = round_up(tune->mc, simd->smr);
+    int NC = round_up(tune->nc, simd->snr);
+    size_t kc_alloc = (size_t)min_int(tune->kc, k);
+    return kc_alloc * min_int(NC, round_up(n, simd->snr)) +
+           kc_alloc * min_int(MC, round_up(m, simd->smr));
+}
+
+void packed_sgemm_small(int m, int n, int k,
+                        const float *A, int lda,
+                        const float *B, int ldb,
+                        float *C, int ldc,
+                        int accumulate, float *ws) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0) {
+        if (!accumulate) {
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < n; j++) {
+                    C[i * ldc + j] = 0.0f;
+                }
+            }
+        }
+        return;
+    }
+
+    const simd_kernel_table *simd = simd_kernels();
+    int MR = simd->smr;
+    int NR = simd->snr;
+    const mm_tuning_params *tune = mm_tuning();
+    int MC = round_up(tune->mc, MR);
+    int KC = tune->kc;
+    int NC = round_up(tune->nc, NR);
+
+    // Layout of ws as sized by packed_sgemm_small_workspace
+    float *Bp = ws;
+    float *Ap = ws + (size_t)min_int(KC, k) * min_int(NC, round_up(n, NR));
+
+    for (int jc = 0; jc < n; jc += NC) {
+        int nc = min_int(NC, n - jc);
+        for (int pc = 0; pc < k; pc += KC) {
+            int kc = min_int(KC, k - pc);
+            int acc = accumulate || pc > 0;
+            for (int jr = 0; jr < nc; jr += NR) {
+                pack_B_panel_f32(kc, min_int(NR, nc - jr), &B[pc * ldb + jc + jr], ldb,
+                                 Bp + jr * kc, NR);
+            }
+            for (int ic = 0; ic < m; ic += MC) {
+                int mc = min_int(MC, m - ic);
+                pack_A_f32(mc, kc, &A[ic * lda + pc], lda, Ap, MR);
+                macro_kernel_f32(simd, mc, nc, kc, Ap, Bp, &C[ic * ldc + jc], ldc, acc);
+            }
+        }
+    }
+}
+
+// ========== MIXED (fp32 storage, fp64 accumulation) ==========
+
+// pack_A_f32 / pack_B_panel_f32 that widen to fp64 on the way into the
+// packed buffers, so the fp64 micro-kernel runs unchanged.
+static void pack_A_widen(int mc, int kc, const float *A, int lda, double *Ap, int mr) {
+    for (int ir = 0; ir < mc; ir += mr) {
+        int rows = min_int(mr, mc - ir);
+        for (int p = 0; p < kc; p++) {
+            for (int i = 0; i < rows; i++) {
+                Ap[p * mr + i] = (double)A[(ir + i) * lda + p];
+            }
+            for (int i = rows; i < mr; i++) {
+                Ap[p * mr + i] = 0.0;
+            }
+        }
+        Ap += mr * kc;
+    }
+}
+
+static void pack_B_panel_widen(int kc, int cols, const float *B, int ldb, double *Bp, int nr) {
+    for (int p = 0; p < kc; p++) {
+        for (int j = 0; j < cols; j++) {
+            Bp[p * nr + j] = (double)B[p * ldb + j];
+        }
+        for (int j = cols; j < nr; j++) {
+            Bp[p * nr + j] = 0.0;
+        }
+    }
+}
+
+void packed_gemm_mixed(int m, int n, int k,
+                       const float *A, int lda,
+                       const float *B, int ldb,
+                       float *C, int ldc,
+                       int accumulate, int use_omp) {
+    if (m <= 0 || n <= 0) return;
+    if (k <= 0) {
+        if (!accumulate) {
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < n; j++) {
+                    C[i * ldc + j] = 0.0f;
+                }
+            }
+        }
+        return;
+    }
+
+    const simd_kernel_table *simd = simd_kernels();
+    int MR = simd->mr;
+    int NR = simd->nr;
+
+    const mm_tuning_params *tune = mm_tuning();
+    int MC = round_up(tune->mc, MR);
+    int KC = tune->kc;
+    int NC = round_up(tune->nc, NR);
+
+    int nthreads = team_size(use_omp);
+    int mc_block = row_block(m, MC, MR, nthreads);
+
+    int nc_alloc = min_int(NC, round_up(n, NR));
+    int kc_alloc = min_int(KC, k);
+    double *Bp = (double *)mm_aligned_alloc((size_t)kc_alloc * nc_alloc * sizeof(double));
+    double *Ap_all = (double *)mm_aligned_alloc((size_t)nthreads * mc_block * kc_alloc * sizeof(double));
+    // fp64 accumulator for one m x nc column panel of C
+    double *Cw = (double *)mm_aligned_alloc((size_t)m * nc_alloc * sizeof(double));
+    if (!Bp || !Ap_all || !Cw) {
+        fprintf(stderr, "packed_gemm_mixed: failed to allocate packing buffers, using unpacked loop\n");
+        mm_aligned_free(Bp);
+        mm_aligned_free(Ap_all);
+        mm_aligned_free(Cw);
+        gemm_unpacked_f32(m, n, k, A, lda, B, ldb, C, ldc, accumulate, 1);
+        return;
+    }
+
+    #pragma omp parallel num_threads(nthreads) if(nthreads > 1)
+    {
+        int tid = 0;
+#ifdef _OPENMP
+        tid = omp_get_thread_num();
+#endif
+        double *Ap = Ap_all + (size_t)tid * mc_block * kc_alloc;
+
+        for (int jc = 0; jc < n; jc += NC) {
+            int nc = min_int(NC, n - jc);
+            int panels = (nc + NR - 1) / NR;
+
+            if (accumulate) {
+                #pragma omp for schedule(static)
+                for (int i = 0; i < m; i++) {
+                    for (int j = 0; j < nc; j++) {
+                        Cw[(size_t)i * nc_alloc + j] = (double)C[i * ldc + jc + j];
+                    }
+                }
+            }
+
+            for (int pc = 0; pc < k; pc += KC) {
+                int kc = min_int(KC, k - pc);
+                int acc = accumulate || pc > 0;
+
+                #pragma omp for schedule(static)
+                for (int jp = 0; jp < panels; jp++) {
+                    int jr = jp * NR;
+                    pack_B_panel_widen(kc, min_int(NR, nc - jr), &B[pc * ldb + jc + jr], ldb,
+                                       Bp + jr * kc, NR);
+                }
+
+                #pragma omp for schedule(dynamic)
+                for (int ic = 0; ic < m; ic += mc_block) {
+                    int mc = min_int(mc_block, m - ic);
+                    pack_A_widen(mc, kc, &A[ic * lda + pc], lda, Ap, MR);
+                    for (int jr = 0; jr < nc; jr += NR) {
+                        int nr = min_int(NR, nc - jr);
+                        for (int ir = 0; ir < mc; ir += MR) {
+                            int mr = min_int(MR, mc - ir);
+                            simd->gemm_ukernel(kc, Ap + ir * kc, Bp + jr * kc,
+                                               &Cw[(size_t)(ic + ir) * nc_alloc + jr], nc_alloc,
+                                               mr, nr, acc);
+                        }
+                    }
+                }
+            }
+
+            // Single rounding of the finished column panel
+            #pragma omp for schedule(static)
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < nc; j++) {
+                    C[i * ldc + jc + j] = (float)Cw[(size_t)i * nc_alloc + j];
+                }
+            }
+        }
+    }
+
+    mm_aligned_free(Bp);
+    mm_aligned_free(Ap_all);
+    mm_aligned_free(Cw);
+}
@@ -0,0 +1,53 @@
+// packed_gemm_f32.h
+// Single- and mixed-precision variants of the packed-panel engine
+// (packed_gemm.h) behind the fp32 "proposed" kernels.
+
+#ifndef PACKED_GEMM_F32_H
+#define PACKED_GEMM_F32_H
+
+#include <stddef.h>
+
+// Blocking comes from the same tuning profile keys (mc/kc/nc, in elements)
+// as the fp64 engine, so an fp32 block occupies half the bytes of its fp64
+// counterpart. The register tile is the table's smr x snr (simd_kernels.h):
+// 4x8 scalar, 8x8 AVX2/NEON, 8x16 AVX-512.
+
+// packed_sgemm
+// Input/behavior: as packed_gemm (packed_gemm.h) with float operands, float
+//   packing buffers and the fp32 micro-kernel. Every product and every
+//   partial sum is rounded to fp32.
+// Complexity:
+//   Time O(m*n*k), extra space O(KC*NC + threads*MC*KC) floats.
+void packed_sgemm(int m, int n, int k,
+                  const float *A, int lda,
+                  const float *B, int ldb,
+                  float *C, int ldc,
+                  int accumulate, int use_omp);
+
+// packed_sgemm_small_workspace / packed_sgemm_small
+// fp32 counterparts of packed_gemm_small_workspace / packed_gemm_small
+// (packed_gemm.h): the packed multiply on the calling thread alone, with
+// scratch (in floats) supplied by the caller. Used as the fp32 Strassen
+// base case.
+size_t packed_sgemm_small_workspace(int m, int n, int k);
+void packed_sgemm_small(int m, int n, int k,
+                        const float *A, int lda,
+                        const float *B, int ldb,
+                        float *C, int ldc,
+                        int accumulate, float *ws);
+
+// packed_gemm_mixed
+// Input/behavior: as packed_sgemm, but only storage is fp32: A and B are
+//   widened to fp64 while they are packed, the fp64 micro-kernel computes
+//   every product, and partial sums over the k blocks stay in an fp64 copy of
+//   the current C column panel. C is rounded to fp32 once, after the last k
+//   block, so the result carries one rounding instead of one per term.
+// Complexity:
+//   Time O(m*n*k), extra space O(KC*NC + threads*MC*KC + m*NC) doubles.
+void packed_gemm_mixed(int m, int n, int k,
+                       const float *A, int lda,
+                       const float *B, int ldb,
+                       float *C, int ldc,
+                       int accumulate, int use_omp);
+
+#endif // PACKED_GEMM_F32_H
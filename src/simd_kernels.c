@@ -0,0 +1,647 @@
+// simd_kernels.c
+// Scalar, AVX2/FMA, AVX-512 and NEON inner kernels (fp64 and fp32) plus
+// the runtime dispatcher that picks one table per process.
+
+#include "simd_kernels.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define SIMD_HAVE_X86 1
+#include <immintrin.h>
+#endif
+
+#if defined(__aarch64__)
+#define SIMD_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+// Transpose cache block (elements per side).
+#define TRANSPOSE_BLOCK 32
+
+// Merge a register tile spilled to tmp into the valid mr x nr corner of C.
+static void store_edge_tile(const double *tmp, int tmp_ld,
+                            double *C, int ldc, int mr, int nr, int accumulate) {
+    for (int i = 0; i < mr; i++) {
+        for (int j = 0; j < nr; j++) {
+            if (accumulate) {
+                C[i * ldc + j] += tmp[i * tmp_ld + j];
+            } else {
+                C[i * ldc + j] = tmp[i * tmp_ld + j];
+            }
+        }
+    }
+}
+
+static void store_edge_tile_f32(const float *tmp, int tmp_ld,
+                                float *C, int ldc, int mr, int nr, int accumulate) {
+    for (int i = 0; i < mr; i++) {
+        for (int j = 0; j < nr; j++) {
+            if (accumulate) {
+                C[i * ldc + j] += tmp[i * tmp_ld + j];
+            } else {
+                C[i * ldc + j] = tmp[i * tmp_ld + j];
+            }
+        }
+    }
+}
+
+// ========== SCALAR (portable reference) ==========
+#define SCALAR_MR 4
+#define SCALAR_NR 8
+
+static void gemm_ukernel_scalar(int kc, const double *Ap, const double *Bp,
+                                double *C, int ldc, int mr, int nr, int accumulate) {
+    double c[SCALAR_MR][SCALAR_NR] = {{0.0}};
+
+    for (int p = 0; p < kc; p++) {
+        const double *a = Ap + p * SCALAR_MR;
+        const double *b = Bp + p * SCALAR_NR;
+        for (int i = 0; i < SCALAR_MR; i++) {
+            double ai = a[i];
+            for (int j = 0; j < SCALAR_NR; j++) {
+                c[i][j] += ai * b[j];
+            }
+        }
+    }
+
+    store_edge_tile(&c[0][0], SCALAR_NR, C, ldc, mr, nr, accumulate);
+}
+
+static void sgemm_ukernel_scalar(int kc, const float *Ap, const float *Bp,
+                                 float *C, int ldc, int mr, int nr, int accumulate) {
+    float c[SCALAR_MR][SCALAR_NR] = {{0.0f}};
+
+    for (int p = 0; p < kc; p++) {
+        const float *a = Ap + p * SCALAR_MR;
+        const float *b = Bp + p * SCALAR_NR;
+        for (int i = 0; i < SCALAR_MR; i++) {
+            float ai = a[i];
+            for (int j = 0; j < SCALAR_NR; j++) {
+                c[i][j] += ai * b[j];
+            }
+        }
+    }
+
+    store_edge_tile_f32(&c[0][0], SCALAR_NR, C, ldc, mr, nr, accumulate);
+}
+
+static void vec_add_scalar(const double *a, const double *b, double *c, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+static void vec_sub_scalar(const double *a, const double *b, double *c, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        c[i] = a[i] - b[i];
+    }
+}
+
+static void transpose_scalar(const double *src, double *dst, int n) {
+    for (int ii = 0; ii < n; ii += TRANSPOSE_BLOCK) {
+        int i_end = (ii + TRANSPOSE_BLOCK < n) ? ii + TRANSPOSE_BLOCK : n;
+        for (int jj = 0; jj < n; jj += TRANSPOSE_BLOCK) {
+            int j_end = (jj + TRANSPOSE_BLOCK < n) ? jj + TRANSPOSE_BLOCK : n;
+            for (int i = ii; i < i_end; i++) {
+                for (int j = jj; j < j_end; j++) {
+                    dst[j * n + i] = src[i * n + j];
+                }
+            }
+        }
+    }
+}
+
+#ifdef SIMD_HAVE_X86
+// ========== AVX2 + FMA (4 x 8 tile, 8 ymm accumulators) ==========
+__attribute__((target("avx2,fma")))
+static void gemm_ukernel_avx2(int kc, const double *Ap, const double *Bp,
+                              double *C, int ldc, int mr, int nr, int accumulate) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = _mm256_setzero_pd();
+    __m256d c10 = _mm256_setzero_pd(), c11 = _mm256_setzero_pd();
+    __m256d c20 = _mm256_setzero_pd(), c21 = _mm256_setzero_pd();
+    __m256d c30 = _mm256_setzero_pd(), c31 = _mm256_setzero_pd();
+
+    for (int p = 0; p < kc; p++) {
+        __m256d b0 = _mm256_loadu_pd(Bp);
+        __m256d b1 = _mm256_loadu_pd(Bp + 4);
+        __m256d a;
+
+        a = _mm256_broadcast_sd(Ap + 0);
+        c00 = _mm256_fmadd_pd(a, b0, c00);
+        c01 = _mm256_fmadd_pd(a, b1, c01);
+        a = _mm256_broadcast_sd(Ap + 1);
+        c10 = _mm256_fmadd_pd(a, b0, c10);
+        c11 = _mm256_fmadd_pd(a, b1, c11);
+        a = _mm256_broadcast_sd(Ap + 2);
+        c20 = _mm256_fmadd_pd(a, b0, c20);
+        c21 = _mm256_fmadd_pd(a, b1, c21);
+        a = _mm256_broadcast_sd(Ap + 3);
+        c30 = _mm256_fmadd_pd(a, b0, c30);
+        c31 = _mm256_fmadd_pd(a, b1, c31);
+
+        Ap += 4;
+        Bp += 8;
+    }
+
+    __m256d rows[4][2] = {{c00, c01}, {c10, c11}, {c20, c21}, {c30, c31}};
+    if (mr == 4 && nr == 8) {
+        for (int i = 0; i < 4; i++) {
+            double *c = C + i * ldc;
+            if (accumulate) {
+                rows[i][0] = _mm256_add_pd(rows[i][0], _mm256_loadu_pd(c));
+                rows[i][1] = _mm256_add_pd(rows[i][1], _mm256_loadu_pd(c + 4));
+            }
+            _mm256_storeu_pd(c, rows[i][0]);
+            _mm256_storeu_pd(c + 4, rows[i][1]);
+        }
+        return;
+    }
+
+    double tmp[4 * 8];
+    for (int i = 0; i < 4; i++) {
+        _mm256_storeu_pd(tmp + i * 8, rows[i][0]);
+        _mm256_storeu_pd(tmp + i * 8 + 4, rows[i][1]);
+    }
+    store_edge_tile(tmp, 8, C, ldc, mr, nr, accumulate);
+}
+
+// fp32: 8 x 8 tile, one ymm (8 floats) per row, so the same 8 accumulators
+// retire twice the flops of the fp64 4 x 8 tile per FMA.
+__attribute__((target("avx2,fma")))
+static void sgemm_ukernel_avx2(int kc, const float *Ap, const float *Bp,
+                               float *C, int ldc, int mr, int nr, int accumulate) {
+    __m256 c[8];
+    for (int i = 0; i < 8; i++) {
+        c[i] = _mm256_setzero_ps();
+    }
+
+    for (int p = 0; p < kc; p++) {
+        __m256 b = _mm256_loadu_ps(Bp);
+        c[0] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 0), b, c[0]);
+        c[1] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 1), b, c[1]);
+        c[2] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 2), b, c[2]);
+        c[3] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 3), b, c[3]);
+        c[4] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 4), b, c[4]);
+        c[5] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 5), b, c[5]);
+        c[6] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 6), b, c[6]);
+        c[7] = _mm256_fmadd_ps(_mm256_broadcast_ss(Ap + 7), b, c[7]);
+        Ap += 8;
+        Bp += 8;
+    }
+
+    if (nr == 8) {
+        for (int i = 0; i < mr; i++) {
+            float *row = C + i * ldc;
+            if (accumulate) {
+                c[i] = _mm256_add_ps(c[i], _mm256_loadu_ps(row));
+            }
+            _mm256_storeu_ps(row, c[i]);
+        }
+        return;
+    }
+
+    float tmp[8 * 8];
+    for (int i = 0; i < 8; i++) {
+        _mm256_storeu_ps(tmp + i * 8, c[i]);
+    }
+    store_edge_tile_f32(tmp, 8, C, ldc, mr, nr, accumulate);
+}
+
+__attribute__((target("avx2")))
+static void vec_add_avx2(const double *a, const double *b, double *c, size_t len) {
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        _mm256_storeu_pd(c + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    for (; i < len; i++) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+__attribute__((target("avx2")))
+static void vec_sub_avx2(const double *a, const double *b, double *c, size_t len) {
+    size_t i = 0;
+    for (; i + 4 <= len; i += 4) {
+        _mm256_storeu_pd(c + i, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+    }
+    for (; i < len; i++) {
+        c[i] = a[i] - b[i];
+    }
+}
+
+// 4x4 in-register transpose via unpack + 128-bit lane permutes.
+__attribute__((target("avx2")))
+static void transpose_4x4_avx2(const double *src, double *dst, int n) {
+    __m256d r0 = _mm256_loadu_pd(src);
+    __m256d r1 = _mm256_loadu_pd(src + n);
+    __m256d r2 = _mm256_loadu_pd(src + 2 * n);
+    __m256d r3 = _mm256_loadu_pd(src + 3 * n);
+
+    __m256d t0 = _mm256_unpacklo_pd(r0, r1);
+    __m256d t1 = _mm256_unpackhi_pd(r0, r1);
+    __m256d t2 = _mm256_unpacklo_pd(r2, r3);
+    __m256d t3 = _mm256_unpackhi_pd(r2, r3);
+
+    _mm256_storeu_pd(dst,         _mm256_permute2f128_pd(t0, t2, 0x20));
+    _mm256_storeu_pd(dst + n,     _mm256_permute2f128_pd(t1, t3, 0x20));
+    _mm256_storeu_pd(dst + 2 * n, _mm256_permute2f128_pd(t0, t2, 0x31));
+    _mm256_storeu_pd(dst + 3 * n, _mm256_permute2f128_pd(t1, t3, 0x31));
+}
+
+__attribute__((target("avx2")))
+static void transpose_avx2(const double *src, double *dst, int n) {
+    for (int ii = 0; ii < n; ii += TRANSPOSE_BLOCK) {
+        int i_end = (ii + TRANSPOSE_BLOCK < n) ? ii + TRANSPOSE_BLOCK : n;
+        for (int jj = 0; jj < n; jj += TRANSPOSE_BLOCK) {
+            int j_end = (jj + TRANSPOSE_BLOCK < n) ? jj + TRANSPOSE_BLOCK : n;
+            int i = ii;
+            for (; i + 4 <= i_end; i += 4) {
+                int j = jj;
+                for (; j + 4 <= j_end; j += 4) {
+                    transpose_4x4_avx2(&src[i * n + j], &dst[j * n + i], n);
+                }
+                for (; j < j_end; j++) {
+                    for (int r = i; r < i + 4; r++) {
+                        dst[j * n + r] = src[r * n + j];
+                    }
+                }
+            }
+            for (; i < i_end; i++) {
+                for (int j = jj; j < j_end; j++) {
+                    dst[j * n + i] = src[i * n + j];
+                }
+            }
+        }
+    }
+}
+
+// ========== AVX-512F (8 x 8 tile, 8 zmm accumulators) ==========
+__attribute__((target("avx512f")))
+static void gemm_ukernel_avx512(int kc, const double *Ap, const double *Bp,
+                                double *C, int ldc, int mr, int nr, int accumulate) {
+    __m512d c[8];
+    for (int i = 0; i < 8; i++) {
+        c[i] = _mm512_setzero_pd();
+    }
+
+    for (int p = 0; p < kc; p++) {
+        __m512d b = _mm512_loadu_pd(Bp);
+        c[0] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[0]), b, c[0]);
+        c[1] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[1]), b, c[1]);
+        c[2] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[2]), b, c[2]);
+        c[3] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[3]), b, c[3]);
+        c[4] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[4]), b, c[4]);
+        c[5] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[5]), b, c[5]);
+        c[6] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[6]), b, c[6]);
+        c[7] = _mm512_fmadd_pd(_mm512_set1_pd(Ap[7]), b, c[7]);
+        Ap += 8;
+        Bp += 8;
+    }
+
+    if (nr == 8) {
+        for (int i = 0; i < mr; i++) {
+            double *row = C + i * ldc;
+            if (accumulate) {
+                c[i] = _mm512_add_pd(c[i], _mm512_loadu_pd(row));
+            }
+            _mm512_storeu_pd(row, c[i]);
+        }
+        return;
+    }
+
+    // Partial width: masked loads/stores keep edge tiles inside C.
+    __mmask8 mask = (__mmask8)((1u << nr) - 1u);
+    for (int i = 0; i < mr; i++) {
+        double *row = C + i * ldc;
+        if (accumulate) {
+            c[i] = _mm512_add_pd(c[i], _mm512_maskz_loadu_pd(mask, row));
+        }
+        _mm512_mask_storeu_pd(row, mask, c[i]);
+    }
+}
+
+// fp32: 8 x 16 tile, one zmm (16 floats) per row.
+__attribute__((target("avx512f")))
+static void sgemm_ukernel_avx512(int kc, const float *Ap, const float *Bp,
+                                 float *C, int ldc, int mr, int nr, int accumulate) {
+    __m512 c[8];
+    for (int i = 0; i < 8; i++) {
+        c[i] = _mm512_setzero_ps();
+    }
+
+    for (int p = 0; p < kc; p++) {
+        __m512 b = _mm512_loadu_ps(Bp);
+        c[0] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[0]), b, c[0]);
+        c[1] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[1]), b, c[1]);
+        c[2] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[2]), b, c[2]);
+        c[3] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[3]), b, c[3]);
+        c[4] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[4]), b, c[4]);
+        c[5] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[5]), b, c[5]);
+        c[6] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[6]), b, c[6]);
+        c[7] = _mm512_fmadd_ps(_mm512_set1_ps(Ap[7]), b, c[7]);
+        Ap += 8;
+        Bp += 16;
+    }
+
+    if (nr == 16) {
+        for (int i = 0; i < mr; i++) {
+            float *row = C + i * ldc;
+            if (accumulate) {
+                c[i] = _mm512_add_ps(c[i], _mm512_loadu_ps(row));
+            }
+            _mm512_storeu_ps(row, c[i]);
+        }
+        return;
+    }
+
+    __mmask16 mask = (__mmask16)((1u << nr) - 1u);
+    for (int i = 0; i < mr; i++) {
+        float *row = C + i * ldc;
+        if (accumulate) {
+            c[i] = _mm512_add_ps(c[i], _mm512_maskz_loadu_ps(mask, row));
+        }
+        _mm512_mask_storeu_ps(row, mask, c[i]);
+    }
+}
+
+__attribute__((target("avx512f")))
+static void vec_add_avx512(const double *a, const double *b, double *c, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        _mm512_storeu_pd(c + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    for (; i < len; i++) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+__attribute__((target("avx512f")))
+static void vec_sub_avx512(const double *a, const double *b, double *c, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+        _mm512_storeu_pd(c + i, _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+    }
+    for (; i < len; i++) {
+        c[i] = a[i] - b[i];
+    }
+}
+#endif // SIMD_HAVE_X86
+
+#ifdef SIMD_HAVE_NEON
+// ========== NEON (4 x 8 tile, 16 q-register accumulators) ==========
+static void gemm_ukernel_neon(int kc, const double *Ap, const double *Bp,
+                              double *C, int ldc, int mr, int nr, int accumulate) {
+    float64x2_t c00 = vdupq_n_f64(0.0), c01 = c00, c02 = c00, c03 = c00;
+    float64x2_t c10 = c00, c11 = c00, c12 = c00, c13 = c00;
+    float64x2_t c20 = c00, c21 = c00, c22 = c00, c23 = c00;
+    float64x2_t c30 = c00, c31 = c00, c32 = c00, c33 = c00;
+
+    for (int p = 0; p < kc; p++) {
+        float64x2_t a01 = vld1q_f64(Ap);
+        float64x2_t a23 = vld1q_f64(Ap + 2);
+        float64x2_t b0 = vld1q_f64(Bp);
+        float64x2_t b1 = vld1q_f64(Bp + 2);
+        float64x2_t b2 = vld1q_f64(Bp + 4);
+        float64x2_t b3 = vld1q_f64(Bp + 6);
+
+        c00 = vfmaq_laneq_f64(c00, b0, a01, 0);
+        c01 = vfmaq_laneq_f64(c01, b1, a01, 0);
+        c02 = vfmaq_laneq_f64(c02, b2, a01, 0);
+        c03 = vfmaq_laneq_f64(c03, b3, a01, 0);
+        c10 = vfmaq_laneq_f64(c10, b0, a01, 1);
+        c11 = vfmaq_laneq_f64(c11, b1, a01, 1);
+        c12 = vfmaq_laneq_f64(c12, b2, a01, 1);
+        c13 = vfmaq_laneq_f64(c13, b3, a01, 1);
+        c20 = vfmaq_laneq_f64(c20, b0, a23, 0);
+        c21 = vfmaq_laneq_f64(c21, b1, a23, 0);
+        c22 = vfmaq_laneq_f64(c22, b2, a23, 0);
+        c23 = vfmaq_laneq_f64(c23, b3, a23, 0);
+        c30 = vfmaq_laneq_f64(c30, b0, a23, 1);
+        c31 = vfmaq_laneq_f64(c31, b1, a23, 1);
+        c32 = vfmaq_laneq_f64(c32, b2, a23, 1);
+        c33 = vfmaq_laneq_f64(c33, b3, a23, 1);
+
+        Ap += 4;
+        Bp += 8;
+    }
+
+    double tmp[4 * 8];
+    vst1q_f64(tmp + 0,  c00); vst1q_f64(tmp + 2,  c01); vst1q_f64(tmp + 4,  c02); vst1q_f64(tmp + 6,  c03);
+    vst1q_f64(tmp + 8,  c10); vst1q_f64(tmp + 10, c11); vst1q_f64(tmp + 12, c12); vst1q_f64(tmp + 14, c13);
+    vst1q_f64(tmp + 16, c20); vst1q_f64(tmp + 18, c21); vst1q_f64(tmp + 20, c22); vst1q_f64(tmp + 22, c23);
+    vst1q_f64(tmp + 24, c30); vst1q_f64(tmp + 26, c31); vst1q_f64(tmp + 28, c32); vst1q_f64(tmp + 30, c33);
+    store_edge_tile(tmp, 8, C, ldc, mr, nr, accumulate);
+}
+
+// fp32: 8 x 8 tile, two q registers (4 floats each) per row.
+static void sgemm_ukernel_neon(int kc, const float *Ap, const float *Bp,
+                               float *C, int ldc, int mr, int nr, int accumulate) {
+    float32x4_t c[8][2];
+    for (int i = 0; i < 8; i++) {
+        c[i][0] = vdupq_n_f32(0.0f);
+        c[i][1] = vdupq_n_f32(0.0f);
+    }
+
+    for (int p = 0; p < kc; p++) {
+        float32x4_t a03 = vld1q_f32(Ap);
+        float32x4_t a47 = vld1q_f32(Ap + 4);
+        float32x4_t b0 = vld1q_f32(Bp);
+        float32x4_t b1 = vld1q_f32(Bp + 4);
+
+        c[0][0] = vfmaq_laneq_f32(c[0][0], b0, a03, 0);
+        c[0][1] = vfmaq_laneq_f32(c[0][1], b1, a03, 0);
+        c[1][0] = vfmaq_laneq_f32(c[1][0], b0, a03, 1);
+        c[1][1] = vfmaq_laneq_f32(c[1][1], b1, a03, 1);
+        c[2][0] = vfmaq_laneq_f32(c[2][0], b0, a03, 2);
+        c[2][1] = vfmaq_laneq_f32(c[2][1], b1, a03, 2);
+        c[3][0] = vfmaq_laneq_f32(c[3][0], b0, a03, 3);
+        c[3][1] = vfmaq_laneq_f32(c[3][1], b1, a03, 3);
+        c[4][0] = vfmaq_laneq_f32(c[4][0], b0, a47, 0);
+        c[4][1] = vfmaq_laneq_f32(c[4][1], b1, a47, 0);
+        c[5][0] = vfmaq_laneq_f32(c[5][0], b0, a47, 1);
+        c[5][1] = vfmaq_laneq_f32(c[5][1], b1, a47, 1);
+        c[6][0] = vfmaq_laneq_f32(c[6][0], b0, a47, 2);
+        c[6][1] = vfmaq_laneq_f32(c[6][1], b1, a47, 2);
+        c[7][0] = vfmaq_laneq_f32(c[7][0], b0, a47, 3);
+        c[7][1] = vfmaq_laneq_f32(c[7][1], b1, a47, 3);
+
+        Ap += 8;
+        Bp += 8;
+    }
+
+    float tmp[8 * 8];
+    for (int i = 0; i < 8; i++) {
+        vst1q_f32(tmp + i * 8, c[i][0]);
+        vst1q_f32(tmp + i * 8 + 4, c[i][1]);
+    }
+    store_edge_tile_f32(tmp, 8, C, ldc, mr, nr, accumulate);
+}
+
+static void vec_add_neon(const double *a, const double *b, double *c, size_t len) {
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2) {
+        vst1q_f64(c + i, vaddq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    }
+    for (; i < len; i++) {
+        c[i] = a[i] + b[i];
+    }
+}
+
+static void vec_sub_neon(const double *a, const double *b, double *c, size_t len) {
+    size_t i = 0;
+    for (; i + 2 <= len; i += 2) {
+        vst1q_f64(c + i, vsubq_f64(vld1q_f64(a + i), vld1q_f64(b + i)));
+    }
+    for (; i < len; i++) {
+        c[i] = a[i] - b[i];
+    }
+}
+
+static void transpose_neon(const double *src, double *dst, int n) {
+    for (int ii = 0; ii < n; ii += TRANSPOSE_BLOCK) {
+        int i_end = (ii + TRANSPOSE_BLOCK < n) ? ii + TRANSPOSE_BLOCK : n;
+        for (int jj = 0; jj < n; jj += TRANSPOSE_BLOCK) {
+            int j_end = (jj + TRANSPOSE_BLOCK < n) ? jj + TRANSPOSE_BLOCK : n;
+            int i = ii;
+            for (; i + 2 <= i_end; i += 2) {
+                int j = jj;
+                for (; j + 2 <= j_end; j += 2) {
+                    float64x2_t r0 = vld1q_f64(&src[i * n + j]);
+                    float64x2_t r1 = vld1q_f64(&src[(i + 1) * n + j]);
+                    vst1q_f64(&dst[j * n + i], vtrn1q_f64(r0, r1));
+                    vst1q_f64(&dst[(j + 1) * n + i], vtrn2q_f64(r0, r1));
+                }
+                for (; j < j_end; j++) {
+                    dst[j * n + i] = src[i * n + j];
+                    dst[j * n + i + 1] = src[(i + 1) * n + j];
+                }
+            }
+            for (; i < i_end; i++) {
+                for (int j = jj; j < j_end; j++) {
+                    dst[j * n + i] = src[i * n + j];
+                }
+            }
+        }
+    }
+}
+#endif // SIMD_HAVE_NEON
+
+// ========== DISPATCH ==========
+static const simd_kernel_table table_scalar = {
+    "scalar", SCALAR_MR, SCALAR_NR, gemm_ukernel_scalar,
+    vec_add_scalar, vec_sub_scalar, transpose_scalar,
+    SCALAR_MR, SCALAR_NR, sgemm_ukernel_scalar
+};
+
+#ifdef SIMD_HAVE_X86
+static const simd_kernel_table table_avx2 = {
+    "avx2", 4, 8, gemm_ukernel_avx2,
+    vec_add_avx2, vec_sub_avx2, transpose_avx2,
+    8, 8, sgemm_ukernel_avx2
+};
+
+static const simd_kernel_table table_avx512 = {
+    "avx512", 8, 8, gemm_ukernel_avx512,
+    vec_add_avx512, vec_sub_avx512, transpose_avx2,
+    8, 16, sgemm_ukernel_avx512
+};
+#endif
+
+#ifdef SIMD_HAVE_NEON
+static const simd_kernel_table table_neon = {
+    "neon", 4, 8, gemm_ukernel_neon,
+    vec_add_neon, vec_sub_neon, transpose_neon,
+    8, 8, sgemm_ukernel_neon
+};
+#endif
+
+static const simd_kernel_table *selected_table = NULL;
+
+// Best table the CPU supports, ignoring MM_SIMD.
+static const simd_kernel_table *detect_best(void) {
+#ifdef SIMD_HAVE_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) {
+        return &table_avx512;
+    }
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+        return &table_avx2;
+    }
+#endif
+#ifdef SIMD_HAVE_NEON
+    return &table_neon;
+#endif
+    return &table_scalar;
+}
+
+// Whether a specific table may run on this CPU.
+static int table_supported(const simd_kernel_table *table) {
+#ifdef SIMD_HAVE_X86
+    if (table == &table_avx512) return __builtin_cpu_supports("avx512f");
+    if (table == &table_avx2) {
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    }
+#endif
+    return 1;
+}
+
+static const simd_kernel_table *lookup_table(const char *name) {
+    if (strcmp(name, "scalar") == 0) return &table_scalar;
+#ifdef SIMD_HAVE_X86
+    if (strcmp(name, "avx2") == 0) return &table_avx2;
+    if (strcmp(name, "avx512") == 0) return &table_avx512;
+#endif
+#ifdef SIMD_HAVE_NEON
+    if (strcmp(name, "neon") == 0) return &table_neon;
+#endif
+    return NULL;
+}
+
+static void simd_select(void) {
+    const simd_kernel_table *best = detect_best();
+    const simd_kernel_table *chosen = best;
+
+    const char *request = getenv("MM_SIMD");
+    if (request && *request) {
+        const simd_kernel_table *forced = lookup_table(request);
+        if (forced && table_supported(forced)) {
+            chosen = forced;
+        } else {
+            fprintf(stderr, "[simd] MM_SIMD=%s unavailable on this host, using %s\n",
+                    request, best->isa);
+        }
+    }
+    selected_table = chosen;
+}
+
+#if defined(__GNUC__)
+__attribute__((constructor))
+static void simd_select_at_startup(void) {
+    // The tuning profile may already have picked a variant via simd_use()
+    if (!selected_table) {
+        simd_select();
+    }
+}
+#endif
+
+const simd_kernel_table *simd_kernels(void) {
+    if (!selected_table) {
+        simd_select();
+    }
+    return selected_table;
+}
+
+int simd_use(const char *isa) {
+    const simd_kernel_table *table = isa ? lookup_table(isa) : NULL;
+    if (!table || !table_supported(table)) {
+        return -1;
+    }
+    selected_table = table;
+    return 0;
+}
+
+const char *simd_isa_name(void) {
+    return simd_kernels()->isa;
+}
@@ -0,0 +1,59 @@
+// simd_kernels.h
+// Hand-vectorized inner kernels with runtime CPU feature dispatch.
+// One binary carries scalar, AVX2/FMA, AVX-512 (x86-64) and NEON (aarch64)
+// variants; the best one the host supports is selected once at startup.
+
+#ifndef SIMD_KERNELS_H
+#define SIMD_KERNELS_H
+
+#include <stddef.h>
+
+// gemm_ukernel_t
+// Input:
+//   kc:     length of the k loop.
+//   Ap:     packed MR-tall micro-panel of A (kc * mr values, see packed_gemm.c).
+//   Bp:     packed NR-wide micro-panel of B (kc * nr values).
+//   C, ldc: top-left corner of the destination tile and its leading dimension.
+//   mr, nr: valid rows/columns of the tile (<= the table's mr/nr at edges).
+//   accumulate: 0 overwrites the tile, non-zero adds into it.
+typedef void (*gemm_ukernel_t)(int kc, const double *Ap, const double *Bp,
+                               double *C, int ldc, int mr, int nr, int accumulate);
+
+// sgemm_ukernel_t
+// Single-precision counterpart of gemm_ukernel_t for the smr x snr tile of
+// the fp32 engine (packed_gemm_f32.c). Same packing layout, same arguments.
+typedef void (*sgemm_ukernel_t)(int kc, const float *Ap, const float *Bp,
+                                float *C, int ldc, int mr, int nr, int accumulate);
+
+typedef struct {
+    const char *isa;        // "scalar", "avx2", "avx512", "neon"
+    int mr;                 // register tile rows
+    int nr;                 // register tile columns
+    gemm_ukernel_t gemm_ukernel;
+    void (*vec_add)(const double *a, const double *b, double *c, size_t len);
+    void (*vec_sub)(const double *a, const double *b, double *c, size_t len);
+    void (*transpose)(const double *src, double *dst, int n);
+    int smr;                // fp32 register tile rows
+    int snr;                // fp32 register tile columns
+    sgemm_ukernel_t sgemm_ukernel;
+} simd_kernel_table;
+
+// simd_kernels
+// Output: the dispatch table chosen for this host. Selection happens once
+// (at load time on GCC/Clang, otherwise on first use) from the CPU features
+// the machine reports. MM_SIMD=scalar|avx2|avx512|neon forces a variant;
+// unsupported requests fall back to the best available one with a warning.
+const simd_kernel_table *simd_kernels(void);
+
+// simd_use
+// Input: variant name ("scalar", "avx2", "avx512", "neon").
+// Behavior: switches the dispatch table to that variant (used by the tuning
+//   profile and by `matmul tune` to compare micro-kernel shapes).
+// Returns 0 on success, -1 when the variant is unknown or unsupported here.
+int simd_use(const char *isa);
+
+// simd_isa_name
+// Output: short name of the selected ISA (e.g. "avx2"), used in logs.
+const char *simd_isa_name(void);
+
+#endif // SIMD_KERNELS_H
@@ -0,0 +1,122 @@
+// tile_sched.c
+// Work-stealing tile deques and busy-time counters (see tile_sched.h).
+
+#include "tile_sched.h"
+#include "utility.h"
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+static uint64_t pack_range(uint32_t front, uint32_t back) {
+    return ((uint64_t)front << 32) | back;
+}
+
+void tile_sched_init(mm_tile_deque *deques, int nthreads, int tid, int count) {
+    uint32_t front = (uint32_t)((long long)count * tid / nthreads);
+    uint32_t back = (uint32_t)((long long)count * (tid + 1) / nthreads);
+    atomic_store_explicit(&deques[tid].range, pack_range(front, back), memory_order_release);
+}
+
+// Owner side: take the front tile.
+static int deque_pop_front(mm_tile_deque *deque) {
+    uint64_t cur = atomic_load_explicit(&deque->range, memory_order_acquire);
+    for (;;) {
+        uint32_t front = (uint32_t)(cur >> 32);
+        uint32_t back = (uint32_t)cur;
+        if (front >= back) return -1;
+        if (atomic_compare_exchange_weak_explicit(&deque->range, &cur,
+                                                  pack_range(front + 1, back),
+                                                  memory_order_acq_rel,
+                                                  memory_order_acquire)) {
+            return (int)front;
+        }
+    }
+}
+
+// Thief side: take the back tile, the one furthest from the owner's
+// current position (and from the A block it has packed).
+static int deque_pop_back(mm_tile_deque *deque) {
+    uint64_t cur = atomic_load_explicit(&deque->range, memory_order_acquire);
+    for (;;) {
+        uint32_t front = (uint32_t)(cur >> 32);
+        uint32_t back = (uint32_t)cur;
+        if (front >= back) return -1;
+        if (atomic_compare_exchange_weak_explicit(&deque->range, &cur,
+                                                  pack_range(front, back - 1),
+                                                  memory_order_acq_rel,
+                                                  memory_order_acquire)) {
+            return (int)(back - 1);
+        }
+    }
+}
+
+int tile_sched_next(mm_tile_deque *deques, int nthreads, int tid, int *stolen) {
+    int tile = deque_pop_front(&deques[tid]);
+    if (tile >= 0) {
+        *stolen = 0;
+        return tile;
+    }
+    for (int i = 1; i < nthreads; i++) {
+        tile = deque_pop_back(&deques[(tid + i) % nthreads]);
+        if (tile >= 0) {
+            *stolen = 1;
+            return tile;
+        }
+    }
+    return -1;
+}
+
+double tile_sched_clock(void) {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return get_wtime();
+#endif
+}
+
+// ========== Busy-time counters ==========
+
+static double busy_time[MM_SCHED_MAX_THREADS];
+static long tile_count[MM_SCHED_MAX_THREADS];
+static long steal_count[MM_SCHED_MAX_THREADS];
+static int max_team = 0;
+
+void mm_sched_record(int tid, int team_size, double busy, long tiles, long steals) {
+    if (tid < 0 || tid >= MM_SCHED_MAX_THREADS) return;
+    #pragma omp atomic
+    busy_time[tid] += busy;
+    #pragma omp atomic
+    tile_count[tid] += tiles;
+    #pragma omp atomic
+    steal_count[tid] += steals;
+    #pragma omp critical(mm_sched_team)
+    {
+        if (team_size > max_team) max_team = team_size;
+    }
+}
+
+void mm_sched_stats_reset(void) {
+    memset(busy_time, 0, sizeof(busy_time));
+    memset(tile_count, 0, sizeof(tile_count));
+    memset(steal_count, 0, sizeof(steal_count));
+    max_team = 0;
+}
+
+void mm_sched_stats_get(mm_sched_stats *out) {
+    memset(out, 0, sizeof(*out));
+    int threads = max_team < MM_SCHED_MAX_THREADS ? max_team : MM_SCHED_MAX_THREADS;
+    out->threads = threads;
+    if (threads == 0) return;
+    double sum = 0.0;
+    out->busy_min = busy_time[0];
+    for (int t = 0; t < threads; t++) {
+        sum += busy_time[t];
+        if (busy_time[t] > out->busy_max) out->busy_max = busy_time[t];
+        if (busy_time[t] < out->busy_min) out->busy_min = busy_time[t];
+        out->tiles += tile_count[t];
+        out->steals += steal_count[t];
+    }
+    out->busy_mean = sum / threads;
+}
@@ -0,0 +1,74 @@
+// tile_sched.h
+// Lock-free work-stealing tile scheduler for the OpenMP drivers of the
+// packed-panel engine, plus per-thread busy-time counters that expose load
+// imbalance in the benchmarks.
+//
+// Tiles are numbered 0..count-1 in an order chosen by the caller for cache
+// locality. Each thread of the team starts with a contiguous range of them
+// in its own deque, takes tiles from the front of it, and when it runs dry
+// steals single tiles from the back of other threads' deques. A deque is
+// one 64-bit word (front and back index) updated with compare-and-swap, so
+// neither the owner nor a thief ever blocks.
+
+#ifndef TILE_SCHED_H
+#define TILE_SCHED_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+
+// Upper bound on team sizes tracked by the busy-time counters.
+#define MM_SCHED_MAX_THREADS 256
+
+// One per thread; padded to a cache line so owners and thieves of
+// different deques do not share lines.
+typedef struct {
+    _Atomic uint64_t range;   // front index << 32 | back index (exclusive)
+    char pad[64 - sizeof(uint64_t)];
+} mm_tile_deque;
+
+// Number of doubles that hold nthreads deques (for callers that carve them
+// from a double workspace).
+#define MM_TILE_DEQUE_ELEMS(nthreads) \
+    ((size_t)(nthreads) * (sizeof(mm_tile_deque) / sizeof(double)))
+
+// tile_sched_init
+// Behavior: gives thread tid of a team of nthreads its share
+//   [count * tid / nthreads, count * (tid + 1) / nthreads) of the tiles.
+//   Each thread initializes its own deque; the team must pass a barrier
+//   before anyone calls tile_sched_next.
+void tile_sched_init(mm_tile_deque *deques, int nthreads, int tid, int count);
+
+// tile_sched_next
+// Output: the next tile for thread tid (its own front first, then the back
+//   of the other deques, scanned from tid + 1), or -1 once every deque is
+//   empty. *stolen is set to 1 when the tile came from another thread.
+int tile_sched_next(mm_tile_deque *deques, int nthreads, int tid, int *stolen);
+
+// tile_sched_clock
+// Output: wall-clock seconds (omp_get_wtime, or get_wtime without OpenMP).
+double tile_sched_clock(void);
+
+// ========== Busy-time counters ==========
+
+typedef struct {
+    int threads;        // largest team seen since the last reset
+    double busy_max;    // seconds in tiles, busiest thread
+    double busy_min;    // seconds in tiles, least busy thread (0 if idle)
+    double busy_mean;   // seconds in tiles, mean over threads
+    long tiles;         // tiles executed
+    long steals;        // tiles taken from another thread's deque
+} mm_sched_stats;
+
+// mm_sched_record
+// Behavior: adds one thread's busy time, tile and steal counts for a call
+//   with a team of team_size threads. Safe to call concurrently.
+void mm_sched_record(int tid, int team_size, double busy, long tiles, long steals);
+
+// mm_sched_stats_reset / mm_sched_stats_get
+// Behavior: clear / read the counters accumulated since the last reset.
+//   busy_max / busy_mean is the imbalance ratio (1.0 = perfectly balanced).
+//   Call them between multiplies, never during one.
+void mm_sched_stats_reset(void);
+void mm_sched_stats_get(mm_sched_stats *out);
+
+#endif // TILE_SCHED_H
@@ -0,0 +1,456 @@
+// tuning.c
+// Loads, saves and searches the per-machine tuning profile (see tuning.h).
+
+#include "tuning.h"
+#include "kernels.h"
+#include "logging.h"
+#include "simd_kernels.h"
+#include "utility.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+static mm_tuning_params active;
+static int loaded = 0;
+static char source[512] = "defaults";
+static int nc_from_profile = 0;
+static int l3_sharers_active = 1;
+
+// ========== CACHE SIZES ==========
+
+static mm_cache_sizes caches;
+static int caches_detected = 0;
+
+// "48K", "2M", "32768" -> bytes; 0 when unparsable.
+static long parse_cache_size(const char *text) {
+    char *end = NULL;
+    long value = strtol(text, &end, 10);
+    if (end == text || value <= 0) {
+        return 0;
+    }
+    switch (*end) {
+        case 'K': case 'k': return value * 1024L;
+        case 'M': case 'm': return value * 1024L * 1024L;
+        case 'G': case 'g': return value * 1024L * 1024L * 1024L;
+        default:            return value;
+    }
+}
+
+static long cache_from_env(const char *name) {
+    const char *value = getenv(name);
+    return (value && *value) ? parse_cache_size(value) : 0;
+}
+
+static long cache_from_sysconf(int level) {
+    long value = -1;
+#if defined(_SC_LEVEL1_DCACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE) && \
+    defined(_SC_LEVEL3_CACHE_SIZE)
+    if (level == 1) value = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    if (level == 2) value = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    if (level == 3) value = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+    return value > 0 ? value : 0;
+}
+
+// Data or unified cache of the given level in cpu0's sysfs cache directory.
+static long cache_from_sysfs(int level) {
+    for (int index = 0; index < 8; index++) {
+        char path[128];
+        char type[32] = "";
+        char size[32] = "";
+        int file_level = 0;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/level", index);
+        FILE *fp = fopen(path, "r");
+        if (!fp) break;
+        if (fscanf(fp, "%d", &file_level) != 1) file_level = 0;
+        fclose(fp);
+        if (file_level != level) continue;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/type", index);
+        fp = fopen(path, "r");
+        if (!fp) continue;
+        if (fscanf(fp, "%31s", type) != 1) type[0] = '\0';
+        fclose(fp);
+        if (strcmp(type, "Instruction") == 0) continue;
+
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu0/cache/index%d/size", index);
+        fp = fopen(path, "r");
+        if (!fp) continue;
+        if (fscanf(fp, "%31s", size) != 1) size[0] = '\0';
+        fclose(fp);
+        return parse_cache_size(size);
+    }
+    return 0;
+}
+
+static long detect_level(int level, const char *env_name, const char **origin) {
+    long value = cache_from_env(env_name);
+    const char *from = "env";
+    if (value <= 0) {
+        value = cache_from_sysconf(level);
+        from = "sysconf";
+    }
+    if (value <= 0) {
+        value = cache_from_sysfs(level);
+        from = "sysfs";
+    }
+    if (value > 0 && !*origin) {
+        *origin = from;
+    }
+    return value;
+}
+
+const mm_cache_sizes *mm_caches(void) {
+    if (!caches_detected) {
+        const char *origin = NULL;
+        caches.l1d = detect_level(1, "MM_CACHE_L1", &origin);
+        caches.l2 = detect_level(2, "MM_CACHE_L2", &origin);
+        caches.l3 = detect_level(3, "MM_CACHE_L3", &origin);
+        snprintf(caches.origin, sizeof(caches.origin), "%s", origin ? origin : "none");
+        caches_detected = 1;
+    }
+    return &caches;
+}
+
+static int clamp_int(long value, int lo, int hi) {
+    if (value < lo) return lo;
+    if (value > hi) return hi;
+    return (int)value;
+}
+
+void mm_tuning_blocking_for_caches(const mm_cache_sizes *sizes, int mr, int nr,
+                                   size_t elem_size, int l3_sharers,
+                                   mm_tuning_params *params) {
+    long elem = (long)elem_size;
+    if (l3_sharers < 1) l3_sharers = 1;
+
+    // L1: a kc x nr sliver of packed B stays resident while the micro-kernel
+    // streams mr x kc micro-panels of A past it
+    if (sizes->l1d > 0) {
+        long kc = sizes->l1d / 2 / (nr * elem);
+        params->kc = clamp_int(kc - kc % 8, MM_CACHE_KC_MIN, MM_CACHE_KC_MAX);
+    }
+    // L2: the packed mc x kc block of A is reused for every nr sliver of B
+    if (sizes->l2 > 0) {
+        long mc = sizes->l2 / 2 / ((long)params->kc * elem);
+        params->mc = clamp_int(mc - mc % mr, mr, MM_CACHE_MC_MAX);
+    }
+    // L3: the packed kc x nc panel of B is reused by every row block of A
+    if (sizes->l3 > 0) {
+        long nc = sizes->l3 / l3_sharers / 2 / ((long)params->kc * elem);
+        params->nc = clamp_int(nc - nc % nr, MM_CACHE_NC_MIN, MM_CACHE_NC_MAX);
+    }
+}
+
+// Blocking derived from the detected caches for the current micro-tile.
+static void apply_cache_blocking(mm_tuning_params *params) {
+    const simd_kernel_table *simd = simd_kernels();
+    mm_tuning_blocking_for_caches(mm_caches(), simd->mr, simd->nr, sizeof(double),
+                                  l3_sharers_active, params);
+}
+
+void mm_tuning_set_cache_sharers(int sharers) {
+    mm_tuning();
+    l3_sharers_active = sharers > 0 ? sharers : 1;
+    if (nc_from_profile) {
+        return;
+    }
+    mm_tuning_params derived = active;
+    apply_cache_blocking(&derived);
+    active.nc = derived.nc;
+}
+
+// ========== PROFILE ==========
+
+void mm_tuning_defaults(mm_tuning_params *params) {
+    params->mc = MM_TUNE_DEFAULT_MC;
+    params->kc = MM_TUNE_DEFAULT_KC;
+    params->nc = MM_TUNE_DEFAULT_NC;
+    params->strassen_threshold = MM_TUNE_DEFAULT_STRASSEN_THRESHOLD;
+    params->strassen_threshold_omp = MM_TUNE_DEFAULT_STRASSEN_THRESHOLD_OMP;
+    params->strassen_parallel_cutoff = MM_TUNE_DEFAULT_STRASSEN_PARALLEL_CUTOFF;
+    params->strassen_task_depth = MM_TUNE_DEFAULT_STRASSEN_TASK_DEPTH;
+    params->isa[0] = '\0';
+}
+
+void mm_tuning_profile_path(char *buf, size_t len) {
+    const char *explicit_path = getenv("MM_TUNING_PROFILE");
+    if (explicit_path && *explicit_path) {
+        snprintf(buf, len, "%s", explicit_path);
+        return;
+    }
+    const char *dir = getenv("MM_TUNING_DIR");
+    if (!dir || !*dir) {
+        dir = "tuning";
+    }
+    snprintf(buf, len, "%s/%s.profile", dir, mm_get_machine_id());
+}
+
+int mm_tuning_load(const char *path, mm_tuning_params *params) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) {
+        return -1;
+    }
+
+    char line[256];
+    while (fgets(line, sizeof(line), fp)) {
+        char *hash = strchr(line, '#');
+        if (hash) *hash = '\0';
+
+        char key[64];
+        char value[64];
+        if (sscanf(line, " %63[^= ] = %63s", key, value) != 2) {
+            continue;
+        }
+
+        if (strcmp(key, "mc") == 0) {
+            params->mc = atoi(value);
+        } else if (strcmp(key, "kc") == 0) {
+            params->kc = atoi(value);
+        } else if (strcmp(key, "nc") == 0) {
+            params->nc = atoi(value);
+        } else if (strcmp(key, "strassen_threshold") == 0) {
+            params->strassen_threshold = atoi(value);
+        } else if (strcmp(key, "strassen_threshold_omp") == 0) {
+            params->strassen_threshold_omp = atoi(value);
+        } else if (strcmp(key, "strassen_parallel_cutoff") == 0) {
+            params->strassen_parallel_cutoff = atoi(value);
+        } else if (strcmp(key, "strassen_task_depth") == 0) {
+            params->strassen_task_depth = atoi(value);
+        } else if (strcmp(key, "isa") == 0) {
+            snprintf(params->isa, sizeof(params->isa), "%.15s", value);
+        }
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+int mm_tuning_save(const char *path, const mm_tuning_params *params) {
+    // Create the profile directory (one level) when it does not exist yet
+    char dir[512];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char *slash = strrchr(dir, '/');
+    if (slash && slash != dir) {
+        *slash = '\0';
+        if (mkdir(dir, 0777) != 0 && errno != EEXIST) {
+            return -1;
+        }
+    }
+
+    FILE *fp = fopen(path, "w");
+    if (!fp) {
+        return -1;
+    }
+
+    char timestamp[64];
+    mm_make_timestamp(timestamp, sizeof(timestamp));
+    fprintf(fp, "# matmul tuning profile (written by `matmul tune`)\n");
+    fprintf(fp, "# machine_id=%s generated=%s\n", mm_get_machine_id(), timestamp);
+    fprintf(fp, "isa=%s\n", params->isa[0] ? params->isa : simd_isa_name());
+    fprintf(fp, "mc=%d\n", params->mc);
+    fprintf(fp, "kc=%d\n", params->kc);
+    fprintf(fp, "nc=%d\n", params->nc);
+    fprintf(fp, "strassen_threshold=%d\n", params->strassen_threshold);
+    fprintf(fp, "strassen_threshold_omp=%d\n", params->strassen_threshold_omp);
+    fprintf(fp, "strassen_parallel_cutoff=%d\n", params->strassen_parallel_cutoff);
+    fprintf(fp, "strassen_task_depth=%d\n", params->strassen_task_depth);
+
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+void mm_tuning_set(const mm_tuning_params *params) {
+    // Copy first: callers may pass the active parameters themselves
+    mm_tuning_params next = *params;
+
+    if (next.mc > 0) active.mc = next.mc;
+    if (next.kc > 0) active.kc = next.kc;
+    if (next.nc > 0) active.nc = next.nc;
+    if (next.strassen_threshold > 0) active.strassen_threshold = next.strassen_threshold;
+    if (next.strassen_threshold_omp > 0) {
+        active.strassen_threshold_omp = next.strassen_threshold_omp;
+    }
+    if (next.strassen_parallel_cutoff > 0) {
+        active.strassen_parallel_cutoff = next.strassen_parallel_cutoff;
+    }
+    if (next.strassen_task_depth > 0) {
+        active.strassen_task_depth = next.strassen_task_depth < MM_STRASSEN_MAX_TASK_DEPTH
+                                         ? next.strassen_task_depth
+                                         : MM_STRASSEN_MAX_TASK_DEPTH;
+    }
+    if (next.isa[0]) {
+        if (simd_use(next.isa) == 0) {
+            snprintf(active.isa, sizeof(active.isa), "%s", next.isa);
+        } else {
+            fprintf(stderr, "[tuning] isa=%s unavailable on this host, keeping %s\n",
+                    next.isa, simd_isa_name());
+        }
+    }
+}
+
+static void tuning_load_profile(void) {
+    loaded = 1;
+    mm_tuning_defaults(&active);
+    apply_cache_blocking(&active);
+
+    char path[512];
+    mm_tuning_profile_path(path, sizeof(path));
+
+    // Start from zeros so only keys present in the file override the
+    // cache-derived values (mm_tuning_set skips values <= 0)
+    mm_tuning_params profile;
+    memset(&profile, 0, sizeof(profile));
+    if (mm_tuning_load(path, &profile) != 0) {
+        return;
+    }
+    nc_from_profile = profile.nc > 0;
+
+    // An explicit MM_SIMD request wins over the profile's micro-kernel
+    const char *forced_isa = getenv("MM_SIMD");
+    if (forced_isa && *forced_isa) {
+        profile.isa[0] = '\0';
+    }
+    mm_tuning_set(&profile);
+    snprintf(source, sizeof(source), "%s", path);
+}
+
+#if defined(__GNUC__)
+__attribute__((constructor))
+static void tuning_load_at_startup(void) {
+    if (!loaded) {
+        tuning_load_profile();
+    }
+}
+#endif
+
+const mm_tuning_params *mm_tuning(void) {
+    if (!loaded) {
+        tuning_load_profile();
+    }
+    return &active;
+}
+
+const char *mm_tuning_source(void) {
+    mm_tuning();
+    return source;
+}
+
+// ========== SEARCH ==========
+
+#define TUNE_REPS 3
+
+typedef void (*tune_kernel_t)(double *A, double *B, double *C, int n);
+
+// Best-of-TUNE_REPS wall time of kernel on the shared n x n operands.
+static double time_kernel(tune_kernel_t kernel, double *A, double *B, double *C, int n) {
+    double best = 0.0;
+    kernel(A, B, C, n);  // warm-up (page faults, packing buffers)
+    for (int r = 0; r < TUNE_REPS; r++) {
+        double start = get_wtime();
+        kernel(A, B, C, n);
+        double elapsed = get_wtime() - start;
+        if (r == 0 || elapsed < best) best = elapsed;
+    }
+    return best;
+}
+
+// Try every candidate for *field (others fixed); keep the fastest.
+static void tune_field(const char *name, int *field, const int *candidates, int count,
+                       tune_kernel_t kernel, double *A, double *B, double *C, int n,
+                       int verbose) {
+    int best_value = *field;
+    double best_time = -1.0;
+    for (int i = 0; i < count; i++) {
+        *field = candidates[i];
+        mm_tuning_set(&active);
+        double t = time_kernel(kernel, A, B, C, n);
+        if (verbose) {
+            printf("  %-26s = %-5d %.4fs (%.2f GFLOPS)\n", name, candidates[i], t,
+                   (2.0 * n * n * n) / (t * 1e9));
+        }
+        if (best_time < 0.0 || t < best_time) {
+            best_time = t;
+            best_value = candidates[i];
+        }
+    }
+    *field = best_value;
+    mm_tuning_set(&active);
+}
+
+void mm_tuning_search(int n, int verbose, mm_tuning_params *best) {
+    mm_tuning();
+
+    double *A = matrix_allocate(n);
+    double *B = matrix_allocate(n);
+    double *C = matrix_allocate(n);
+    if (!A || !B || !C) {
+        fprintf(stderr, "mm_tuning_search: failed to allocate %dx%d operands\n", n, n);
+        matrix_free(A);
+        matrix_free(B);
+        matrix_free(C);
+        *best = active;
+        return;
+    }
+    srand(42);
+    matrix_random_init(A, n);
+    srand(123);
+    matrix_random_init(B, n);
+
+    // 1) Micro-kernel variant (register tile shape) with default blocking
+    static const char *isas[] = {"scalar", "avx2", "avx512", "neon"};
+    const char *best_isa = simd_isa_name();
+    double best_time = -1.0;
+    for (size_t i = 0; i < sizeof(isas) / sizeof(isas[0]); i++) {
+        if (simd_use(isas[i]) != 0) continue;
+        const simd_kernel_table *simd = simd_kernels();
+        double t = time_kernel(proposed_serial, A, B, C, n);
+        if (verbose) {
+            printf("  %-26s = %-5s %.4fs (%.2f GFLOPS, %dx%d tile)\n", "isa", isas[i], t,
+                   (2.0 * n * n * n) / (t * 1e9), simd->mr, simd->nr);
+        }
+        if (best_time < 0.0 || t < best_time) {
+            best_time = t;
+            best_isa = isas[i];
+        }
+    }
+    snprintf(active.isa, sizeof(active.isa), "%s", best_isa);
+    mm_tuning_set(&active);
+
+    // 2) Packed-panel blocking, one dimension at a time (KC first: it sizes
+    //    the L1-resident B sliver that every micro-kernel call streams)
+    static const int kc_candidates[] = {128, 192, 256, 384, 512};
+    static const int mc_candidates[] = {64, 96, 128, 192, 256, 384};
+    static const int nc_candidates[] = {1024, 2048, 4096, 8192};
+    tune_field("kc", &active.kc, kc_candidates,
+               (int)(sizeof(kc_candidates) / sizeof(kc_candidates[0])),
+               proposed_serial, A, B, C, n, verbose);
+    tune_field("mc", &active.mc, mc_candidates,
+               (int)(sizeof(mc_candidates) / sizeof(mc_candidates[0])),
+               proposed_serial, A, B, C, n, verbose);
+    tune_field("nc", &active.nc, nc_candidates,
+               (int)(sizeof(nc_candidates) / sizeof(nc_candidates[0])),
+               proposed_serial, A, B, C, n, verbose);
+
+    // 3) Strassen cutoffs (shared with Winograd)
+    static const int threshold_candidates[] = {64, 128, 256, 512};
+    static const int cutoff_candidates[] = {128, 256, 512};
+    tune_field("strassen_threshold", &active.strassen_threshold, threshold_candidates,
+               (int)(sizeof(threshold_candidates) / sizeof(threshold_candidates[0])),
+               strassen_serial, A, B, C, n, verbose);
+    tune_field("strassen_threshold_omp", &active.strassen_threshold_omp, threshold_candidates,
+               (int)(sizeof(threshold_candidates) / sizeof(threshold_candidates[0])),
+               strassen_omp, A, B, C, n, verbose);
+    tune_field("strassen_parallel_cutoff", &active.strassen_parallel_cutoff, cutoff_candidates,
+               (int)(sizeof(cutoff_candidates) / sizeof(cutoff_candidates[0])),
+               strassen_omp, A, B, C, n, verbose);
+
+    matrix_free(A);
+    matrix_free(B);
+    matrix_free(C);
+    *best = active;
+}
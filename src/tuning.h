@@ -0,0 +1,116 @@
+// tuning.h
+// Per-machine tuning profile: cache blocking of the packed-panel engine,
+// Strassen cutoffs and micro-kernel variant. Blocking starts from the cache
+// sizes the OS reports (falling back to the original hard-coded constants);
+// `matmul tune` searches better values for the current host and stores them
+// in a profile that every binary loads at startup.
+
+#ifndef TUNING_H
+#define TUNING_H
+
+#include <stddef.h>
+
+// Defaults used when neither a profile nor the cache sizes are available.
+#define MM_TUNE_DEFAULT_MC 128
+#define MM_TUNE_DEFAULT_KC 256
+#define MM_TUNE_DEFAULT_NC 4096
+#define MM_TUNE_DEFAULT_STRASSEN_THRESHOLD 128
+#define MM_TUNE_DEFAULT_STRASSEN_THRESHOLD_OMP 128
+#define MM_TUNE_DEFAULT_STRASSEN_PARALLEL_CUTOFF 256
+#define MM_TUNE_DEFAULT_STRASSEN_TASK_DEPTH 0   // 0 = derive from the thread count
+#define MM_STRASSEN_MAX_TASK_DEPTH 4
+// Scratch cap of OpenMP Strassen, in copies of the operands (m*k + k*n):
+// task levels are dropped until the workspace fits.
+#define MM_STRASSEN_OMP_WS_BUDGET 8
+
+typedef struct {
+    int mc;                        // rows of the packed A block (L2)
+    int kc;                        // depth of packed A/B blocks (L1/L2)
+    int nc;                        // columns of the packed B panel (L3)
+    int strassen_threshold;        // serial Strassen/Winograd base-case size
+    int strassen_threshold_omp;    // OpenMP Strassen/Winograd base-case size
+    int strassen_parallel_cutoff;  // smallest level that spawns OpenMP tasks
+    int strassen_task_depth;       // recursion levels that spawn tasks (0 = auto)
+    char isa[16];                  // micro-kernel variant ("" = auto-detect)
+} mm_tuning_params;
+
+// Bounds for blocking derived from cache sizes (elements).
+#define MM_CACHE_KC_MIN 64
+#define MM_CACHE_KC_MAX 1024
+#define MM_CACHE_MC_MAX 1024
+#define MM_CACHE_NC_MIN 256
+#define MM_CACHE_NC_MAX 8192
+
+typedef struct {
+    long l1d;          // L1 data cache per core, bytes (0 = unknown)
+    long l2;           // L2 per core, bytes (0 = unknown)
+    long l3;           // last-level cache, bytes (0 = unknown)
+    char origin[16];   // "env", "sysconf", "sysfs" or "none"
+} mm_cache_sizes;
+
+// mm_caches
+// Output: cache sizes of this host, detected once. Each level is taken from
+//   MM_CACHE_L1 / MM_CACHE_L2 / MM_CACHE_L3 when set (bytes, optional K/M/G
+//   suffix), otherwise from sysconf(_SC_LEVEL*_CACHE_SIZE), otherwise from
+//   /sys/devices/system/cpu/cpu0/cache. origin names the first source used.
+const mm_cache_sizes *mm_caches(void);
+
+// mm_tuning_blocking_for_caches
+// Input: cache sizes, micro-tile mr x nr, element size in bytes, number of
+//   processes sharing the last-level cache.
+// Behavior: sets params->kc/mc/nc so that a kc x nr sliver of packed B fills
+//   half of L1, an mc x kc block of packed A half of L2, and a kc x nc panel
+//   of packed B half of this process's share of L3 (clamped to the
+//   MM_CACHE_* bounds). Levels reported as 0 leave the field unchanged.
+void mm_tuning_blocking_for_caches(const mm_cache_sizes *caches, int mr, int nr,
+                                   size_t elem_size, int l3_sharers,
+                                   mm_tuning_params *params);
+
+// mm_tuning_set_cache_sharers
+// Input: processes on this node that share the last-level cache (MPI ranks).
+// Behavior: re-derives nc for the smaller L3 share unless a profile fixed nc.
+//   Called by mpi_init; shared-memory runs keep the whole L3.
+void mm_tuning_set_cache_sharers(int sharers);
+
+// mm_tuning
+// Output: the active parameters. They are set up once (at load time on
+// GCC/Clang, otherwise on first use): compiled-in defaults, then blocking
+// derived from mm_caches(), then any keys present in the profile at
+// mm_tuning_profile_path().
+const mm_tuning_params *mm_tuning(void);
+
+// mm_tuning_set
+// Behavior: replaces the active parameters (values <= 0 keep the current
+//   ones) and applies params->isa to the SIMD dispatch table when non-empty.
+//   Not thread-safe; call between multiplies, never during one.
+void mm_tuning_set(const mm_tuning_params *params);
+
+// mm_tuning_defaults
+// Behavior: fills params with the compiled-in defaults.
+void mm_tuning_defaults(mm_tuning_params *params);
+
+// mm_tuning_profile_path
+// Behavior: writes the profile location into buf: MM_TUNING_PROFILE when set,
+//   otherwise <MM_TUNING_DIR or "tuning">/<MACHINE_ID>.profile.
+void mm_tuning_profile_path(char *buf, size_t len);
+
+// mm_tuning_source
+// Output: path of the profile that was loaded, or "defaults".
+const char *mm_tuning_source(void);
+
+// mm_tuning_load / mm_tuning_save
+// Behavior: read or write a key=value profile ('#' starts a comment; unknown
+//   keys are ignored so older binaries accept newer profiles).
+// Returns 0 on success, -1 on failure.
+int mm_tuning_load(const char *path, mm_tuning_params *params);
+int mm_tuning_save(const char *path, const mm_tuning_params *params);
+
+// mm_tuning_search
+// Input: n (problem size to tune on), verbose (print each candidate).
+// Behavior: times proposed_serial for every supported micro-kernel variant
+//   and for candidate mc/kc/nc (coordinate descent), then strassen_serial and
+//   strassen_omp for candidate cutoffs. Leaves the best values active and
+//   copies them into best.
+void mm_tuning_search(int n, int verbose, mm_tuning_params *best);
+
+#endif // TUNING_H
@@ -2,25 +2,130 @@
 // Implementation of utility functions
 // Helper functions for matrix operations, timing, and testing
 
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // sched_setaffinity / CPU_SET
+#endif
+
 #include "utility.h"
+#include "simd_kernels.h"
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
+#include <sys/resource.h>
 #include <sys/time.h>
 
+#ifdef __linux__
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+// ========== Page placement and thread affinity ==========
+// Settings are read from MM_NUMA / MM_AFFINITY / OMP_PROC_BIND once, on
+// first use.
+
+#define MM_MAX_AFFINITY_CPUS 1024
+
+static int placement_ready = 0;
+static int first_touch_enabled = 1;
+static const char *affinity_policy = "none";  // none | close | spread | omp
+static char placement_name[32];
+#ifdef __linux__
+static int affinity_cpus[MM_MAX_AFFINITY_CPUS];  // process mask at startup
+static int affinity_cpu_count = 0;
+#endif
+
+// Reads the settings into the statics above. Runs under the lock, so the
+// first call may come from inside a parallel region or task.
+static void placement_read_settings(void) {
+    const char *numa = getenv("MM_NUMA");
+    if (numa && *numa) {
+        if (strcmp(numa, "off") == 0 || strcmp(numa, "malloc") == 0) {
+            first_touch_enabled = 0;
+        } else if (strcmp(numa, "first_touch") != 0) {
+            fprintf(stderr, "Warning: unknown MM_NUMA '%s', using first_touch\n", numa);
+        }
+    }
+
+    const char *bind = getenv("OMP_PROC_BIND");
+    const char *policy = getenv("MM_AFFINITY");
+    if (bind && *bind && strcmp(bind, "false") != 0 && strcmp(bind, "FALSE") != 0) {
+        // The runtime already binds its threads; do not fight it
+        affinity_policy = "omp";
+    } else if (policy && *policy) {
+        if (strcmp(policy, "close") == 0) {
+            affinity_policy = "close";
+        } else if (strcmp(policy, "spread") == 0) {
+            affinity_policy = "spread";
+        } else if (strcmp(policy, "none") != 0) {
+            fprintf(stderr, "Warning: unknown MM_AFFINITY '%s', using none\n", policy);
+        }
+    }
+
+#ifdef __linux__
+    // Snapshot the CPUs this process may use before any thread is pinned
+    // (pinning the master would otherwise shrink the mask seen later)
+    cpu_set_t mask;
+    CPU_ZERO(&mask);
+    if (sched_getaffinity(0, sizeof(mask), &mask) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE && affinity_cpu_count < MM_MAX_AFFINITY_CPUS; cpu++) {
+            if (CPU_ISSET(cpu, &mask)) {
+                affinity_cpus[affinity_cpu_count++] = cpu;
+            }
+        }
+    }
+#else
+    if (strcmp(affinity_policy, "close") == 0 || strcmp(affinity_policy, "spread") == 0) {
+        fprintf(stderr, "Warning: MM_AFFINITY is only supported on Linux, using none\n");
+        affinity_policy = "none";
+    }
+#endif
+
+    snprintf(placement_name, sizeof(placement_name), "%s:%s",
+             first_touch_enabled ? "first_touch" : "malloc", affinity_policy);
+}
+
+static void placement_init(void) {
+    // The flag is only read and written under the lock (whose entry and
+    // exit flush), so callers see the settings complete
+    #pragma omp critical(mm_placement_state)
+    if (!placement_ready) {
+        placement_read_settings();
+        placement_ready = 1;
+    }
+}
+
+// Touch rows x row_bytes in parallel with the static row split the
+// OpenMP kernels use, so each page lands on the node of the thread that
+// will work on it.
+static void first_touch_rows(void *buffer, size_t rows, size_t row_bytes) {
+    placement_init();
+    if (!buffer || !first_touch_enabled) return;
+    char *bytes = (char *)buffer;
+    long long total_rows = (long long)rows;
+    #pragma omp parallel for schedule(static)
+    for (long long i = 0; i < total_rows; i++) {
+        memset(bytes + (size_t)i * row_bytes, 0, row_bytes);
+    }
+}
+
 double* matrix_allocate(int n) {
-    double *matrix = (double *)malloc(n * n * sizeof(double));
+    double *matrix = (double *)mm_aligned_alloc((size_t)n * n * sizeof(double));
     if (matrix == NULL) {
         fprintf(stderr, "Error: Failed to allocate matrix of size %dx%d\n", n, n);
         return NULL;
     }
+    first_touch_rows(matrix, (size_t)n, (size_t)n * sizeof(double));
     return matrix;
 }
 
 void matrix_free(double *matrix) {
-    if (matrix != NULL) {
-        free(matrix);
-    }
+    mm_aligned_free(matrix);
 }
 
 void matrix_random_init(double *matrix, int n) {
@@ -30,6 +135,11 @@ void matrix_random_init(double *matrix, int n) {
 }
 
 void matrix_zero_init(double *matrix, int n) {
+    placement_init();
+    if (first_touch_enabled) {
+        first_touch_rows(matrix, (size_t)n, (size_t)n * sizeof(double));
+        return;
+    }
     for (int i = 0; i < n * n; i++) {
         matrix[i] = 0.0;
     }
@@ -84,22 +194,332 @@ double matrix_checksum(double *matrix, int n) {
     return sum;
 }
 
+// Elementwise and transpose helpers go through the SIMD dispatch table
+// (simd_kernels.c) so they pick up AVX2/AVX-512/NEON where available.
 void matrix_add(double *A, double *B, double *C, int n) {
-    for (int i = 0; i < n * n; i++) {
-        C[i] = A[i] + B[i];
-    }
+    simd_kernels()->vec_add(A, B, C, (size_t)n * n);
 }
 
 void matrix_sub(double *A, double *B, double *C, int n) {
-    for (int i = 0; i < n * n; i++) {
-        C[i] = A[i] - B[i];
+    simd_kernels()->vec_sub(A, B, C, (size_t)n * n);
+}
+
+void matrix_add_strided(int rows, int cols, const double *A, int lda,
+                        const double *B, int ldb, double *C, int ldc) {
+    const simd_kernel_table *simd = simd_kernels();
+    for (int i = 0; i < rows; i++) {
+        simd->vec_add(A + (size_t)i * lda, B + (size_t)i * ldb, C + (size_t)i * ldc, (size_t)cols);
+    }
+}
+
+void matrix_sub_strided(int rows, int cols, const double *A, int lda,
+                        const double *B, int ldb, double *C, int ldc) {
+    const simd_kernel_table *simd = simd_kernels();
+    for (int i = 0; i < rows; i++) {
+        simd->vec_sub(A + (size_t)i * lda, B + (size_t)i * ldb, C + (size_t)i * ldc, (size_t)cols);
     }
 }
 
+void matrix_mul_strided(int m, int n, int k, const double *A, int lda,
+                        const double *B, int ldb, double *C, int ldc, int accumulate) {
+    // i-p-j order: the inner loop streams a row of B into a row of C, which
+    // keeps both accesses contiguous and lets the compiler vectorize it.
+    for (int i = 0; i < m; i++) {
+        double *restrict c_row = C + (size_t)i * ldc;
+        const double *a_row = A + (size_t)i * lda;
+        if (!accumulate) {
+            for (int j = 0; j < n; j++) c_row[j] = 0.0;
+        }
+        for (int p = 0; p < k; p++) {
+            double a = a_row[p];
+            const double *restrict b_row = B + (size_t)p * ldb;
+            for (int j = 0; j < n; j++) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+}
+
+void matrix_peel_fixup(int m, int n, int k, const double *A, int lda,
+                       const double *B, int ldb, double *C, int ldc, int accumulate) {
+    int m2 = m & ~1;
+    int n2 = n & ~1;
+    int k2 = k & ~1;
+
+    // Odd inner dimension: rank-1 update of the even block with the last
+    // column of A and the last row of B.
+    if (k2 != k) {
+        const double *b_row = B + (size_t)k2 * ldb;
+        for (int i = 0; i < m2; i++) {
+            double a = A[(size_t)i * lda + k2];
+            double *c_row = C + (size_t)i * ldc;
+            for (int j = 0; j < n2; j++) {
+                c_row[j] += a * b_row[j];
+            }
+        }
+    }
+
+    // Odd last column of C (all m rows): one GEMV with the last column of B.
+    if (n2 != n) {
+        matrix_mul_strided(m, 1, k, A, lda, B + n2, ldb, C + n2, ldc, accumulate);
+    }
+
+    // Odd last row of C (even columns only; the corner is done above).
+    if (m2 != m) {
+        matrix_mul_strided(1, n2, k, A + (size_t)m2 * lda, lda, B, ldb,
+                           C + (size_t)m2 * ldc, ldc, accumulate);
+    }
+}
+
+float* matrix_allocate_f32(int n) {
+    float *matrix = (float *)mm_aligned_alloc((size_t)n * n * sizeof(float));
+    if (matrix == NULL) {
+        fprintf(stderr, "Error: Failed to allocate fp32 matrix of size %dx%d\n", n, n);
+        return NULL;
+    }
+    first_touch_rows(matrix, (size_t)n, (size_t)n * sizeof(float));
+    return matrix;
+}
+
+void matrix_free_f32(float *matrix) {
+    mm_aligned_free(matrix);
+}
+
+void matrix_to_f32(const double *src, float *dst, int n) {
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        dst[i] = (float)src[i];
+    }
+}
+
+void matrix_from_f32(const float *src, double *dst, int n) {
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        dst[i] = (double)src[i];
+    }
+}
+
+int matrix_compare_f32(const float *C, const double *ref, int n, double rel_tol) {
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        double scale = fabs(ref[i]) > 1.0 ? fabs(ref[i]) : 1.0;
+        if (fabs((double)C[i] - ref[i]) > rel_tol * scale) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
 void matrix_transpose(double *src, double *dst, int n) {
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < n; j++) {
-            dst[j * n + i] = src[i * n + j];
+    simd_kernels()->transpose(src, dst, n);
+}
+
+void matrix_first_touch(double *matrix, size_t rows, size_t cols) {
+    first_touch_rows(matrix, rows, cols * sizeof(double));
+}
+
+const char *matrix_placement_name(void) {
+    placement_init();
+    return placement_name;
+}
+
+void matrix_affinity_partition(int slot, int slots) {
+    placement_init();
+#ifdef __linux__
+    if (slots <= 1 || slot < 0 || slot >= slots) return;
+    // Only split a mask that still spans every online CPU; a launcher that
+    // bound this rank already gave it its own share
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    if (online <= 0 || affinity_cpu_count != online || affinity_cpu_count < slots) return;
+    int begin = (int)((long long)affinity_cpu_count * slot / slots);
+    int end = (int)((long long)affinity_cpu_count * (slot + 1) / slots);
+    memmove(affinity_cpus, affinity_cpus + begin, (size_t)(end - begin) * sizeof(int));
+    affinity_cpu_count = end - begin;
+#endif
+}
+
+int matrix_pin_threads(void) {
+    placement_init();
+    int pinned = 0;
+#if defined(__linux__) && defined(_OPENMP)
+    int spread = strcmp(affinity_policy, "spread") == 0;
+    if (!spread && strcmp(affinity_policy, "close") != 0) return 0;
+    if (affinity_cpu_count == 0) return 0;
+
+    #pragma omp parallel reduction(+:pinned)
+    {
+        int tid = omp_get_thread_num();
+        int nthreads = omp_get_num_threads();
+        // close: consecutive CPUs of the mask; spread: evenly strided over
+        // it, which crosses sockets when CPUs are numbered socket by socket
+        int slot = spread ? (int)((long long)tid * affinity_cpu_count / nthreads) : tid;
+        cpu_set_t mask;
+        CPU_ZERO(&mask);
+        CPU_SET(affinity_cpus[slot % affinity_cpu_count], &mask);
+        if (sched_setaffinity(0, sizeof(mask), &mask) == 0) {
+            pinned++;
         }
     }
+#endif
+    return pinned;
+}
+
+// ========== Aligned and huge-page allocation ==========
+// MM_HUGEPAGES is read once, on first use.
+
+typedef enum {
+    ALLOC_OFF = 0,   // MM_ALIGNMENT-aligned heap memory
+    ALLOC_THP,       // 2MB-aligned heap memory + MADV_HUGEPAGE
+    ALLOC_EXPLICIT   // MAP_HUGETLB mapping
+} alloc_mode;
+
+static const char *const alloc_mode_names[] = {"off", "thp", "explicit"};
+
+// Stored in the MM_ALIGNMENT bytes in front of every block so that
+// mm_aligned_free knows how it was obtained.
+typedef struct {
+    void *base;
+    size_t map_bytes;  // mmap length (ALLOC_EXPLICIT only)
+    int mode;
+} alloc_header;
+
+static int alloc_ready = 0;
+static alloc_mode alloc_requested = ALLOC_OFF;
+static alloc_mode alloc_weakest = ALLOC_OFF;  // weakest mode a large block got
+static int alloc_large_blocks = 0;
+static int alloc_thp_ok = 0;
+static char alloc_name[24];
+
+static size_t round_up_bytes(size_t bytes, size_t multiple) {
+    return (bytes + multiple - 1) / multiple * multiple;
+}
+
+#ifdef __linux__
+// THP is unusable when the kernel lacks it or it is set to "never".
+static int thp_available(void) {
+    FILE *fp = fopen("/sys/kernel/mm/transparent_hugepage/enabled", "r");
+    if (!fp) return 0;
+    char line[128] = "";
+    int ok = fgets(line, sizeof(line), fp) != NULL && strstr(line, "[never]") == NULL;
+    fclose(fp);
+    return ok;
+}
+#endif
+
+static void alloc_init(void) {
+    // No unlocked fast path: reading alloc_ready outside the lock would race
+    // with the first initialization on another thread
+    #pragma omp critical(mm_alloc_state)
+    if (!alloc_ready) {
+        const char *mode = getenv("MM_HUGEPAGES");
+        if (mode && *mode) {
+            if (strcmp(mode, "thp") == 0) {
+                alloc_requested = ALLOC_THP;
+            } else if (strcmp(mode, "explicit") == 0) {
+                alloc_requested = ALLOC_EXPLICIT;
+            } else if (strcmp(mode, "off") != 0) {
+                fprintf(stderr, "Warning: unknown MM_HUGEPAGES '%s', using off\n", mode);
+            }
+        }
+#ifdef __linux__
+        alloc_thp_ok = alloc_requested != ALLOC_OFF && thp_available();
+#else
+        if (alloc_requested != ALLOC_OFF) {
+            fprintf(stderr, "Warning: MM_HUGEPAGES is only supported on Linux, using off\n");
+            alloc_requested = ALLOC_OFF;
+        }
+#endif
+        alloc_weakest = alloc_requested;
+        alloc_ready = 1;
+    }
+}
+
+// Remember the weakest backing a large block ended up with (warning once
+// per fallback level) so the logs show what the run actually used.
+static void alloc_note_large(alloc_mode got) {
+    #pragma omp critical(mm_alloc_state)
+    {
+        alloc_large_blocks = 1;
+        if (got < alloc_weakest) {
+            fprintf(stderr, "Warning: MM_HUGEPAGES=%s unavailable, using %s\n",
+                    alloc_mode_names[alloc_requested], alloc_mode_names[got]);
+            alloc_weakest = got;
+        }
+    }
+}
+
+void *mm_aligned_alloc(size_t bytes) {
+    alloc_init();
+    size_t total = bytes + MM_ALIGNMENT;  // header + payload
+    int large = bytes >= MM_HUGE_PAGE_BYTES;
+    alloc_mode mode = large ? alloc_requested : ALLOC_OFF;
+    void *base = NULL;
+    size_t map_bytes = 0;
+
+#ifdef __linux__
+    if (mode == ALLOC_EXPLICIT) {
+        map_bytes = round_up_bytes(total, MM_HUGE_PAGE_BYTES);
+        base = mmap(NULL, map_bytes, PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (base == MAP_FAILED) {
+            base = NULL;
+            map_bytes = 0;
+            mode = ALLOC_THP;
+        }
+    }
+    if (mode == ALLOC_THP) {
+        size_t span = round_up_bytes(total, MM_HUGE_PAGE_BYTES);
+        if (!alloc_thp_ok || posix_memalign(&base, MM_HUGE_PAGE_BYTES, span) != 0) {
+            base = NULL;
+            mode = ALLOC_OFF;
+        } else if (madvise(base, span, MADV_HUGEPAGE) != 0) {
+            mode = ALLOC_OFF;  // block is usable, just not huge-page backed
+        }
+    }
+#endif
+    if (!base) {
+        mode = ALLOC_OFF;
+        if (posix_memalign(&base, MM_ALIGNMENT, total) != 0) {
+            return NULL;
+        }
+    }
+    if (large) {
+        alloc_note_large(mode);
+    }
+
+    char *payload = (char *)base + MM_ALIGNMENT;
+    alloc_header *header = (alloc_header *)payload - 1;
+    header->base = base;
+    header->map_bytes = map_bytes;
+    header->mode = (int)mode;
+    return payload;
+}
+
+void mm_aligned_free(void *ptr) {
+    if (!ptr) return;
+    alloc_header *header = (alloc_header *)ptr - 1;
+#ifdef __linux__
+    if (header->mode == ALLOC_EXPLICIT) {
+        munmap(header->base, header->map_bytes);
+        return;
+    }
+#endif
+    free(header->base);
+}
+
+const char *mm_alloc_mode_name(void) {
+    alloc_init();
+    #pragma omp critical(mm_alloc_state)
+    {
+        if (alloc_large_blocks && alloc_weakest != alloc_requested) {
+            snprintf(alloc_name, sizeof(alloc_name), "%s->%s",
+                     alloc_mode_names[alloc_requested], alloc_mode_names[alloc_weakest]);
+        } else {
+            snprintf(alloc_name, sizeof(alloc_name), "%s", alloc_mode_names[alloc_requested]);
+        }
+    }
+    return alloc_name;
+}
+
+long mm_page_faults(void) {
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+    return (long)usage.ru_minflt + (long)usage.ru_majflt;
 }
@@ -10,6 +10,8 @@
 // matrix_allocate
 // Input: n (matrix dimension > 0).
 // Output: pointer to a newly allocated n*n double buffer (row-major) or NULL on failure.
+//   Under first-touch placement (the default) the buffer is zeroed by
+//   matrix_first_touch before it is returned.
 double* matrix_allocate(int n);
 
 // matrix_free
@@ -24,7 +26,8 @@ void matrix_random_init(double *matrix, int n);
 
 // matrix_zero_init
 // Input: matrix pointer, dimension n.
-// Behavior: sets all elements to 0.0.
+// Behavior: sets all elements to 0.0 (in parallel row blocks under
+//   first-touch placement, see matrix_first_touch).
 void matrix_zero_init(double *matrix, int n);
 
 // matrix_identity_init
@@ -58,8 +61,129 @@ void matrix_add(double *A, double *B, double *C, int n);
 // Behavior: performs elementwise C = A - B over n x n matrices.
 void matrix_sub(double *A, double *B, double *C, int n);
 
+// matrix_add_strided / matrix_sub_strided
+// Behavior: C = A + B (or A - B) over a rows x cols block where each operand is a
+//   view into a larger row-major matrix with its own leading dimension.
+//   C may alias A or B (elementwise in place).
+void matrix_add_strided(int rows, int cols, const double *A, int lda,
+                        const double *B, int ldb, double *C, int ldc);
+void matrix_sub_strided(int rows, int cols, const double *A, int lda,
+                        const double *B, int ldb, double *C, int ldc);
+
+// matrix_mul_strided
+// Behavior: naive C = A * B (accumulate == 0) or C += A * B (accumulate != 0)
+//   where C is m x n, A is m x k and B is k x n, each a strided view.
+//   Used as the base case of the Strassen-type recursions.
+void matrix_mul_strided(int m, int n, int k, const double *A, int lda,
+                        const double *B, int ldb, double *C, int ldc, int accumulate);
+
+// matrix_peel_fixup
+// Behavior: dynamic-peeling fixup for an m x n x k product whose even part
+//   (the leading (m & ~1) x (n & ~1) block of C over the first (k & ~1) terms)
+//   was already computed by a recursion. Adds the rank-1 update of the odd k
+//   term to that block, then computes the odd last column and odd last row of
+//   C in full (overwriting them, or adding when accumulate != 0).
+void matrix_peel_fixup(int m, int n, int k, const double *A, int lda,
+                       const double *B, int ldb, double *C, int ldc, int accumulate);
+
+// matrix_allocate_f32 / matrix_free_f32
+// Behavior: fp32 counterparts of matrix_allocate / matrix_free.
+float* matrix_allocate_f32(int n);
+void matrix_free_f32(float *matrix);
+
+// matrix_to_f32 / matrix_from_f32
+// Behavior: convert an n x n matrix between fp64 and fp32 (round to nearest
+//   on the way down, exact on the way up).
+void matrix_to_f32(const double *src, float *dst, int n);
+void matrix_from_f32(const float *src, double *dst, int n);
+
+// matrix_compare_f32
+// Input: fp32 result C, fp64 reference, dimension n, relative tolerance.
+// Behavior: returns 1 if every |C - ref| <= rel_tol * max(1, |ref|),
+//   otherwise 0. Relative because fp32 error scales with the magnitude of
+//   the entries (about n/4 for the random [0, 1] test operands).
+int matrix_compare_f32(const float *C, const double *ref, int n, double rel_tol);
+
 // matrix_transpose
 // Behavior: writes dst[j*n + i] = src[i*n + j] for an n x n matrix.
 void matrix_transpose(double *src, double *dst, int n);
 
+// ========== NUMA placement and thread affinity ==========
+// MM_NUMA=first_touch (default) | off
+//   first_touch: matrix_allocate / matrix_allocate_f32 / matrix_zero_init
+//   write each buffer with a parallel static split over rows, the split the
+//   OpenMP kernels give their threads, so on a multi-socket node each row
+//   block's pages are placed on the node of the thread that computes it.
+//   off: plain malloc; pages land wherever the allocating thread runs.
+// MM_AFFINITY=none (default) | close | spread
+//   close pins OpenMP thread t to the t-th CPU of the process mask; spread
+//   strides threads evenly across the mask. Ignored when OMP_PROC_BIND is
+//   set, because the runtime is binding threads already (reported as "omp").
+// matrix_random_init stays sequential so rand() sequences are unchanged.
+
+// matrix_first_touch
+// Behavior: zeroes a rows x cols buffer with the parallel row split above
+//   (no-op when MM_NUMA=off). Call it on fresh buffers before filling them
+//   from a single thread.
+void matrix_first_touch(double *matrix, size_t rows, size_t cols);
+
+// matrix_pin_threads
+// Behavior: pins the threads of the next OpenMP team (omp_get_max_threads)
+//   according to MM_AFFINITY. Threads created later by a larger team are
+//   not pinned, so call it again after changing the thread count.
+// Returns the number of threads pinned (0 for none/omp or without Linux
+//   and OpenMP).
+int matrix_pin_threads(void);
+
+// matrix_affinity_partition
+// Behavior: restricts pinning to the slot-th of slots equal shares of the
+//   CPU mask, so ranks sharing a node do not pin onto the same CPUs. Does
+//   nothing when the launcher already narrowed this process's mask.
+void matrix_affinity_partition(int slot, int slots);
+
+// matrix_placement_name
+// Output: "<numa>:<affinity>" such as "first_touch:close" or "malloc:none",
+//   logged in the placement column.
+const char *matrix_placement_name(void);
+
+// ========== Aligned and huge-page allocation ==========
+// Every matrix (matrix_allocate / matrix_allocate_f32) and every scratch
+// buffer of the kernels and the MPI wrapper comes from mm_aligned_alloc, so
+// rows start on a cache line and SIMD loads never straddle two.
+// MM_HUGEPAGES=off (default) | thp | explicit
+//   Selects the backing of blocks of at least MM_HUGE_PAGE_BYTES:
+//   off: 64-byte aligned heap memory (4K pages).
+//   thp: 2MB-aligned heap memory advised with MADV_HUGEPAGE, so transparent
+//   huge pages back it when the kernel allows (/sys/kernel/mm/
+//   transparent_hugepage/enabled is "always" or "madvise").
+//   explicit: MAP_HUGETLB mappings from the reserved pool (vm.nr_hugepages);
+//   falls back to thp, then off, when the pool is empty.
+// Linux only; elsewhere every mode is off.
+
+#define MM_ALIGNMENT 64
+#define MM_HUGE_PAGE_BYTES ((size_t)2 << 20)
+
+// mm_aligned_alloc
+// Output: MM_ALIGNMENT-aligned block of bytes (contents undefined) backed as
+//   MM_HUGEPAGES selects, or NULL on failure. Release with mm_aligned_free,
+//   never free().
+void *mm_aligned_alloc(size_t bytes);
+
+// mm_aligned_free
+// Behavior: releases a block from mm_aligned_alloc (NULL is ignored).
+void mm_aligned_free(void *ptr);
+
+// mm_alloc_mode_name
+// Output: the MM_HUGEPAGES mode ("off", "thp" or "explicit"), followed by
+//   "->" and the weaker mode when a large block had to fall back (e.g.
+//   "explicit->thp"), logged in the alloc column.
+const char *mm_alloc_mode_name(void);
+
+// mm_page_faults
+// Output: page faults (minor + major) taken by this process so far, or 0
+//   where getrusage is unavailable. Differences around a run measure the
+//   faults it took: about one per 4K page on first touch, one per 2MB page
+//   with huge pages.
+long mm_page_faults(void);
+
 #endif // UTILITY_H
@@ -2,7 +2,11 @@
 // Test correctness of matrix multiplication implementations.
 // Compares results against known-correct serial implementation.
 
+#include "../src/context.h"
+#include "../src/gemm.h"
 #include "../src/kernels.h"
+#include "../src/kernels_f32.h"
+#include "../src/oblivious.h"
 #include "../src/omp_kernels.h"
 #include "../src/utility.h"
 #include <stdio.h>
@@ -10,8 +14,13 @@
 #include <time.h>
 #include <string.h>
 
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define DEFAULT_TEST_SIZE 256
 #define DEFAULT_TOLERANCE 1e-6
+#define DEFAULT_F32_TOLERANCE 1e-4
 
 static int get_env_int(const char *name, int fallback) {
     const char *value = getenv(name);
@@ -65,6 +74,428 @@ typedef struct {
     void (*fn)(double*, double*, double*, int);
 } kernel_entry;
 
+// mm_dgemm adapters: feed op(A)/op(B) through padded leading dimensions and
+// C = 2 * op(A) * op(B) - 0.5 * C on a C of ones, then undo the scaling so
+// the result is comparable with A * B.
+static void dgemm_adapter(mm_gemm_engine engine, int use_omp, char transa, char transb,
+                          double *A, double *B, double *C, int n) {
+    int lda = n + 3;
+    int ldb = n + 1;
+    double *A_op = calloc((size_t)n * lda, sizeof(double));
+    double *B_op = calloc((size_t)n * ldb, sizeof(double));
+    if (!A_op || !B_op) {
+        free(A_op);
+        free(B_op);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            A_op[i * lda + j] = (transa == 'T') ? A[j * n + i] : A[i * n + j];
+            B_op[i * ldb + j] = (transb == 'T') ? B[j * n + i] : B[i * n + j];
+        }
+    }
+    for (int i = 0; i < n * n; i++) {
+        C[i] = 1.0;
+    }
+
+    mm_dgemm(engine, use_omp, transa, transb, n, n, n,
+             2.0, A_op, lda, B_op, ldb, -0.5, C, n);
+
+    for (int i = 0; i < n * n; i++) {
+        C[i] = (C[i] + 0.5) * 0.5;
+    }
+    free(A_op);
+    free(B_op);
+}
+
+static void dgemm_naive_nn(double *A, double *B, double *C, int n) {
+    dgemm_adapter(MM_GEMM_NAIVE, 0, 'N', 'N', A, B, C, n);
+}
+
+static void dgemm_proposed_tt(double *A, double *B, double *C, int n) {
+    dgemm_adapter(MM_GEMM_PROPOSED, 0, 'T', 'T', A, B, C, n);
+}
+
+static void dgemm_proposed_omp_nt(double *A, double *B, double *C, int n) {
+    dgemm_adapter(MM_GEMM_PROPOSED, 1, 'N', 'T', A, B, C, n);
+}
+
+static void dgemm_strassen_tn(double *A, double *B, double *C, int n) {
+    dgemm_adapter(MM_GEMM_STRASSEN, 0, 'T', 'N', A, B, C, n);
+}
+
+static void dgemm_winograd_omp_nt(double *A, double *B, double *C, int n) {
+    dgemm_adapter(MM_GEMM_WINOGRAD, 1, 'N', 'T', A, B, C, n);
+}
+
+// Rectangular mm_dgemm: distinct odd m, n, k cut from the test operands,
+// all four transa/transb pairs, and C as an m x n sub-block inside a padded
+// buffer. Each result is checked against a reference loop, and the padding
+// around the sub-block must come back untouched. C receives A * B when every
+// case agrees (so the harness comparison passes) and zeros otherwise.
+static int dgemm_rect_case(mm_gemm_engine engine, int use_omp, char transa, char transb,
+                           const double *A, const double *B, int size) {
+    int m = (size / 3) | 1;
+    int n = (size / 2) | 1;
+    int k = (size - 2) | 1;
+    if (m > size) m = size;
+    if (n > size) n = size;
+    if (k > size) k = size;
+
+    int lda = ((transa == 'T') ? m : k) + 3;
+    int ldb = ((transb == 'T') ? k : n) + 1;
+    int ldc = n + 5;
+    int c_rows = m + 2;
+    double *A_op = calloc((size_t)((transa == 'T') ? k : m) * lda, sizeof(double));
+    double *B_op = calloc((size_t)((transb == 'T') ? n : k) * ldb, sizeof(double));
+    double *C_buf = malloc((size_t)c_rows * ldc * sizeof(double));
+    double *ref = malloc((size_t)m * n * sizeof(double));
+    if (!A_op || !B_op || !C_buf || !ref) {
+        free(A_op);
+        free(B_op);
+        free(C_buf);
+        free(ref);
+        return 0;
+    }
+
+    // op(A)(i, p) = A[i][p] and op(B)(p, j) = B[p][j], stored transposed
+    // when the flag asks for it
+    for (int i = 0; i < m; i++) {
+        for (int p = 0; p < k; p++) {
+            if (transa == 'T') A_op[p * lda + i] = A[i * size + p];
+            else               A_op[i * lda + p] = A[i * size + p];
+        }
+    }
+    for (int p = 0; p < k; p++) {
+        for (int j = 0; j < n; j++) {
+            if (transb == 'T') B_op[j * ldb + p] = B[p * size + j];
+            else               B_op[p * ldb + j] = B[p * size + j];
+        }
+    }
+    for (int i = 0; i < c_rows * ldc; i++) {
+        C_buf[i] = (double)(i % 5) - 2.0;
+    }
+    double *C = C_buf + ldc + 2;
+
+    const double alpha = 2.0;
+    const double beta = -0.5;
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (int p = 0; p < k; p++) {
+                sum += A[i * size + p] * B[p * size + j];
+            }
+            ref[i * n + j] = alpha * sum + beta * C[i * ldc + j];
+        }
+    }
+
+    int ok = mm_dgemm(engine, use_omp, transa, transb, m, n, k,
+                      alpha, A_op, lda, B_op, ldb, beta, C, ldc) == 0;
+    for (int r = 0; ok && r < c_rows; r++) {
+        for (int c = 0; c < ldc; c++) {
+            int i = r - 1;
+            int j = c - 2;
+            double got = C_buf[r * ldc + c];
+            if (i >= 0 && i < m && j >= 0 && j < n) {
+                double want = ref[i * n + j];
+                double diff = got > want ? got - want : want - got;
+                double scale = want < 0 ? 1.0 - want : 1.0 + want;
+                if (diff > DEFAULT_TOLERANCE * scale) ok = 0;
+            } else if (got != (double)((r * ldc + c) % 5) - 2.0) {
+                ok = 0;
+            }
+        }
+    }
+    if (!ok) {
+        fprintf(stderr, "  dgemm %c%c m=%d n=%d k=%d: mismatch\n", transa, transb, m, n, k);
+    }
+
+    free(A_op);
+    free(B_op);
+    free(C_buf);
+    free(ref);
+    return ok;
+}
+
+static void dgemm_rect_check(mm_gemm_engine engine, int use_omp,
+                             double *A, double *B, double *C, int n) {
+    static const char pairs[4][2] = {{'N', 'N'}, {'N', 'T'}, {'T', 'N'}, {'T', 'T'}};
+    int ok = 1;
+    for (int i = 0; i < 4; i++) {
+        ok &= dgemm_rect_case(engine, use_omp, pairs[i][0], pairs[i][1], A, B, n);
+    }
+    if (ok) {
+        matmul_serial(A, B, C, n);
+    } else {
+        memset(C, 0, (size_t)n * n * sizeof(double));
+    }
+}
+
+static void dgemm_rect_naive(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_NAIVE, 0, A, B, C, n);
+}
+
+static void dgemm_rect_naive_omp(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_NAIVE, 1, A, B, C, n);
+}
+
+static void dgemm_rect_proposed(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_PROPOSED, 0, A, B, C, n);
+}
+
+static void dgemm_rect_proposed_omp(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_PROPOSED, 1, A, B, C, n);
+}
+
+static void dgemm_rect_strassen(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_STRASSEN, 0, A, B, C, n);
+}
+
+static void dgemm_rect_strassen_omp(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_STRASSEN, 1, A, B, C, n);
+}
+
+static void dgemm_rect_winograd(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_WINOGRAD, 0, A, B, C, n);
+}
+
+static void dgemm_rect_winograd_omp(double *A, double *B, double *C, int n) {
+    dgemm_rect_check(MM_GEMM_WINOGRAD, 1, A, B, C, n);
+}
+
+// mm_context adapters share one context, so later entries reuse the scratch
+// grown by earlier ones.
+static mm_context *test_ctx = NULL;
+
+static void ctx_run(mm_gemm_engine engine, double *A, double *B, double *C, int n) {
+    if (!test_ctx) {
+        test_ctx = mm_context_create(0);
+    }
+    mm_context_gemm(test_ctx, engine, A, B, C, n);
+}
+
+static void ctx_naive(double *A, double *B, double *C, int n) {
+    ctx_run(MM_GEMM_NAIVE, A, B, C, n);
+}
+
+static void ctx_proposed(double *A, double *B, double *C, int n) {
+    ctx_run(MM_GEMM_PROPOSED, A, B, C, n);
+}
+
+static void ctx_strassen(double *A, double *B, double *C, int n) {
+    // Second call runs on the scratch left by the first
+    ctx_run(MM_GEMM_STRASSEN, A, B, C, n);
+    ctx_run(MM_GEMM_STRASSEN, A, B, C, n);
+}
+
+// One batch of uneven row slabs of C, cycling through the engines.
+static void ctx_batch_slabs(double *A, double *B, double *C, int n) {
+    enum { MAX_SLABS = 8 };
+    const mm_gemm_engine engines[] = {MM_GEMM_PROPOSED, MM_GEMM_STRASSEN, MM_GEMM_NAIVE};
+    mm_gemm_job jobs[MAX_SLABS];
+    int count = 0;
+    int row = 0;
+    while (row < n && count < MAX_SLABS) {
+        int rows = (count == MAX_SLABS - 1) ? n - row : n / 5 + count;
+        if (rows < 1) rows = 1;
+        if (rows > n - row) rows = n - row;
+        mm_gemm_job job = {engines[count % 3], rows, n, n,
+                           A + (size_t)row * n, n, B, n, C + (size_t)row * n, n};
+        jobs[count++] = job;
+        row += rows;
+    }
+    if (!test_ctx) {
+        test_ctx = mm_context_create(0);
+    }
+    mm_context_run(test_ctx, jobs, count);
+}
+
+// Batched API over column slabs of C: every multiply shares A and reads its
+// own slab of B (pointer arrays), the leftover columns run as a batch of one.
+static void batch_ptr_cols(double *A, double *B, double *C, int n) {
+    enum { MAX_SLABS = 16 };
+    const double *A_array[MAX_SLABS];
+    const double *B_array[MAX_SLABS];
+    double *C_array[MAX_SLABS];
+    int width = n / MAX_SLABS > 0 ? n / MAX_SLABS : 1;
+    int count = n / width < MAX_SLABS ? n / width : MAX_SLABS;
+    for (int j = 0; j < count; j++) {
+        A_array[j] = A;
+        B_array[j] = B + (size_t)j * width;
+        C_array[j] = C + (size_t)j * width;
+    }
+    if (!test_ctx) {
+        test_ctx = mm_context_create(0);
+    }
+    mm_context_gemm_batch(test_ctx, MM_GEMM_PROPOSED, n, width, n,
+                          A_array, n, B_array, n, C_array, n, count);
+    int done = count * width;
+    if (done < n) {
+        const double *A_rest = A;
+        const double *B_rest = B + done;
+        double *C_rest = C + done;
+        mm_context_gemm_batch(test_ctx, MM_GEMM_PROPOSED, n, n - done, n,
+                              &A_rest, n, &B_rest, n, &C_rest, n, 1);
+    }
+}
+
+// Strided batch over row slabs of C with B shared (stride 0): Strassen on
+// the full slabs, the naive engine on the leftover rows.
+static void batch_strided_rows(double *A, double *B, double *C, int n) {
+    int rows = n / 12 > 0 ? n / 12 : 1;
+    int count = n / rows;
+    size_t stride = (size_t)rows * n;
+    if (!test_ctx) {
+        test_ctx = mm_context_create(0);
+    }
+    mm_context_gemm_batch_strided(test_ctx, MM_GEMM_STRASSEN, rows, n, n,
+                                  A, n, stride, B, n, 0, C, n, stride, count);
+    int done = count * rows;
+    if (done < n) {
+        mm_context_gemm_batch_strided(test_ctx, MM_GEMM_NAIVE, n - done, n, n,
+                                      A + (size_t)done * n, n, 0, B, n, 0,
+                                      C + (size_t)done * n, n, 0, 1);
+    }
+}
+
+// Team growth between batches on a fresh context: the top rows run as a
+// proposed batch (private scratch) on one thread, the rest as a naive batch
+// (no scratch) after the team has grown, which must still find a scratch
+// slot for every thread.
+static void batch_team_growth(double *A, double *B, double *C, int n) {
+    int half = n / 2;
+    mm_context *ctx = mm_context_create(0);
+    if (!ctx) return;
+#ifdef _OPENMP
+    int saved = omp_get_max_threads();
+    omp_set_num_threads(1);
+#endif
+    mm_context_gemm_batch_strided(ctx, MM_GEMM_PROPOSED, 1, n, n, A, n, n, B, n, 0,
+                                  C, n, n, half);
+#ifdef _OPENMP
+    omp_set_num_threads(saved > 1 ? 2 * saved : 4);
+#endif
+    mm_context_gemm_batch_strided(ctx, MM_GEMM_NAIVE, 1, n, n, A + (size_t)half * n, n, n,
+                                  B, n, 0, C + (size_t)half * n, n, n, n - half);
+#ifdef _OPENMP
+    omp_set_num_threads(saved);
+#endif
+    mm_context_destroy(ctx);
+}
+
+// Fused epilogues: the proposed kernel runs with ep on a preset C and is
+// checked against the same epilogue applied in a separate pass to the naive
+// product. C receives that product when the two agree (so the harness
+// comparison passes) and the fused result otherwise.
+static void epilogue_check(int use_omp, mm_epilogue_op op, double *A, double *B, double *C, int n) {
+    double *fused = matrix_allocate(n);
+    double *product = matrix_allocate(n);
+    double *expected = matrix_allocate(n);
+    double *row_bias = (double *)malloc((size_t)n * sizeof(double));
+    double *col_bias = (double *)malloc((size_t)n * sizeof(double));
+    if (!fused || !product || !expected || !row_bias || !col_bias) {
+        matrix_free(fused);
+        matrix_free(product);
+        matrix_free(expected);
+        free(row_bias);
+        free(col_bias);
+        return;
+    }
+
+    // Entries of A * B average n / 4 for the test operands; with alpha = 2
+    // the row bias pulls roughly half of the pre-activations below zero
+    for (int i = 0; i < n; i++) {
+        row_bias[i] = -0.5 * n + (double)(i % 3);
+        col_bias[i] = 0.1 * (i % 4) - 0.15;
+    }
+    for (size_t i = 0; i < (size_t)n * n; i++) {
+        fused[i] = (double)((int)(i % 7) - 3);
+        expected[i] = fused[i];
+    }
+    mm_epilogue ep = {2.0, 0.5, row_bias, col_bias, op, -1.0, 1.0};
+
+    if (use_omp) {
+        proposed_omp_epilogue(A, B, fused, n, &ep);
+    } else {
+        proposed_serial_epilogue(A, B, fused, n, &ep);
+    }
+    matmul_serial(A, B, product, n);
+    mm_epilogue_apply(&ep, n, n, 0, 0, product, n, expected, n);
+
+    int ok = matrix_compare(fused, expected, n, DEFAULT_TOLERANCE);
+    memcpy(C, ok ? product : fused, (size_t)n * n * sizeof(double));
+
+    matrix_free(fused);
+    matrix_free(product);
+    matrix_free(expected);
+    free(row_bias);
+    free(col_bias);
+}
+
+static void proposed_serial_relu(double *A, double *B, double *C, int n) {
+    epilogue_check(0, MM_EPILOGUE_RELU, A, B, C, n);
+}
+
+static void proposed_omp_clamp(double *A, double *B, double *C, int n) {
+    epilogue_check(1, MM_EPILOGUE_CLAMP, A, B, C, n);
+}
+
+static void proposed_omp_tanh(double *A, double *B, double *C, int n) {
+    epilogue_check(1, MM_EPILOGUE_TANH, A, B, C, n);
+}
+
+// Cache-oblivious GEMM on two uneven column slabs of C (rectangular tile
+// grids, leading dimension n), the wider one on the OpenMP team.
+static void oblivious_cols(double *A, double *B, double *C, int n) {
+    int w = n / 3 + 1;
+    if (w > n) w = n;
+    oblivious_gemm(n, w, n, A, n, B, n, C, n, 0);
+    oblivious_gemm(n, n - w, n, A, n, B + w, n, C + w, n, 1);
+}
+
+// fp32 / mixed kernels run on rounded copies of A and B and are checked
+// against the fp64 product of those rounded operands with a relative tolerance.
+typedef struct {
+    const char *name;
+    void (*fn)(float*, float*, float*, int);
+} f32_kernel_entry;
+
+static void run_single_test_f32(const f32_kernel_entry *entry,
+                                float *A, float *B, double *baseline, int n,
+                                double rel_tol, const char *enabled_list,
+                                int *total, int *passed)
+{
+    if (!kernel_enabled(enabled_list, entry->name)) {
+        return;
+    }
+
+    printf("Testing %-20s ... ", entry->name);
+    (*total)++;
+
+    float *C = matrix_allocate_f32(n);
+    double *C_wide = matrix_allocate(n);
+    if (!C || !C_wide) {
+        printf("FAILED ❌ (allocation)\n");
+        matrix_free_f32(C);
+        matrix_free(C_wide);
+        return;
+    }
+
+    entry->fn(A, B, C, n);
+    if (matrix_compare_f32(C, baseline, n, rel_tol)) {
+        printf("PASSED\n");
+        (*passed)++;
+    } else {
+        matrix_from_f32(C, C_wide, n);
+        printf("FAILED ❌\n");
+        printf("  Expected checksum: %f\n", matrix_checksum(baseline, n));
+        printf("  Got checksum     : %f\n", matrix_checksum(C_wide, n));
+    }
+
+    matrix_free_f32(C);
+    matrix_free(C_wide);
+}
+
 static void run_single_test(const kernel_entry *entry,
                             double *A, double *B, double *baseline, int n,
                             double tol, const char *enabled_list,
@@ -101,6 +532,7 @@ int main() {
     
     int test_size = get_env_int("TEST_CORRECTNESS_SIZE", DEFAULT_TEST_SIZE);
     double tol = get_env_double("TEST_CORRECTNESS_TOLERANCE", DEFAULT_TOLERANCE);
+    double f32_tol = get_env_double("TEST_F32_TOLERANCE", DEFAULT_F32_TOLERANCE);
     const char *kernel_list = getenv("CORRECTNESS_KERNELS");
 
     printf("Matrix size: %dx%d\n", test_size, test_size);
@@ -136,8 +568,36 @@ int main() {
         {"matmul_omp", matmul_omp},
         {"strassen_serial", strassen_serial},
         {"strassen_omp", strassen_omp},
+        {"winograd_serial", winograd_serial},
+        {"winograd_omp", winograd_omp},
         {"proposed_serial", proposed_serial},
-        {"proposed_omp", proposed_omp}
+        {"proposed_omp", proposed_omp},
+        {"oblivious_serial", oblivious_serial},
+        {"oblivious_omp", oblivious_omp},
+        {"oblivious_cols", oblivious_cols},
+        {"proposed_serial_relu", proposed_serial_relu},
+        {"proposed_omp_clamp", proposed_omp_clamp},
+        {"proposed_omp_tanh", proposed_omp_tanh},
+        {"dgemm_naive_nn", dgemm_naive_nn},
+        {"dgemm_proposed_tt", dgemm_proposed_tt},
+        {"dgemm_proposed_omp_nt", dgemm_proposed_omp_nt},
+        {"dgemm_strassen_tn", dgemm_strassen_tn},
+        {"dgemm_winograd_omp_nt", dgemm_winograd_omp_nt},
+        {"dgemm_rect_naive", dgemm_rect_naive},
+        {"dgemm_rect_naive_omp", dgemm_rect_naive_omp},
+        {"dgemm_rect_proposed", dgemm_rect_proposed},
+        {"dgemm_rect_proposed_omp", dgemm_rect_proposed_omp},
+        {"dgemm_rect_strassen", dgemm_rect_strassen},
+        {"dgemm_rect_strassen_omp", dgemm_rect_strassen_omp},
+        {"dgemm_rect_winograd", dgemm_rect_winograd},
+        {"dgemm_rect_winograd_omp", dgemm_rect_winograd_omp},
+        {"ctx_naive", ctx_naive},
+        {"ctx_proposed", ctx_proposed},
+        {"ctx_strassen", ctx_strassen},
+        {"ctx_batch_slabs", ctx_batch_slabs},
+        {"batch_ptr_cols", batch_ptr_cols},
+        {"batch_strided_rows", batch_strided_rows},
+        {"batch_team_growth", batch_team_growth}
     };
     const size_t kernel_count = sizeof(kernels) / sizeof(kernels[0]);
 
@@ -146,9 +606,48 @@ int main() {
                         kernel_list, &total, &passed);
     }
 
+    const f32_kernel_entry f32_kernels[] = {
+        {"matmul_serial_f32", matmul_serial_f32},
+        {"matmul_omp_f32", matmul_omp_f32},
+        {"strassen_serial_f32", strassen_serial_f32},
+        {"strassen_omp_f32", strassen_omp_f32},
+        {"proposed_serial_f32", proposed_serial_f32},
+        {"proposed_omp_f32", proposed_omp_f32},
+        {"matmul_serial_mixed", matmul_serial_mixed},
+        {"proposed_serial_mixed", proposed_serial_mixed},
+        {"proposed_omp_mixed", proposed_omp_mixed}
+    };
+    const size_t f32_kernel_count = sizeof(f32_kernels) / sizeof(f32_kernels[0]);
+
+    float *A32 = matrix_allocate_f32(test_size);
+    float *B32 = matrix_allocate_f32(test_size);
+    double *A_rounded = matrix_allocate(test_size);
+    double *B_rounded = matrix_allocate(test_size);
+    double *expected_f32 = matrix_allocate(test_size);
+    if (A32 && B32 && A_rounded && B_rounded && expected_f32) {
+        matrix_to_f32(A, A32, test_size);
+        matrix_to_f32(B, B32, test_size);
+        matrix_from_f32(A32, A_rounded, test_size);
+        matrix_from_f32(B32, B_rounded, test_size);
+        matmul_serial(A_rounded, B_rounded, expected_f32, test_size);
+        for (size_t i = 0; i < f32_kernel_count; i++) {
+            run_single_test_f32(&f32_kernels[i], A32, B32, expected_f32, test_size, f32_tol,
+                                kernel_list, &total, &passed);
+        }
+    } else {
+        fprintf(stderr, "Error: Failed to allocate fp32 test matrices\n");
+        total++;
+    }
+    matrix_free_f32(A32);
+    matrix_free_f32(B32);
+    matrix_free(A_rounded);
+    matrix_free(B_rounded);
+    matrix_free(expected_f32);
+
     printf("\n=== Results: %d/%d tests passed ===\n", passed, total);
     
     // Clean up
+    mm_context_destroy(test_ctx);
     matrix_free(A);
     matrix_free(B);
     matrix_free(expected);
@@ -1,8 +1,9 @@
 // mpi_correctness_test.c
 // Correctness test for MPI and Hybrid matrix multiplication
-// Usage: mpirun -np <P> ./mpi_correctness_test <algorithm> [mpi|hybrid]
+// Usage: mpirun -np <P> ./mpi_correctness_test <algorithm> [mpi|hybrid] [strategy]
 
 #include "../src/kernels.h"
+#include "../src/mpi_grid.h"
 #include "../src/mpi_wrapper.h"
 #include "../src/utility.h"
 #include <stdio.h>
@@ -26,18 +27,29 @@ int main(int argc, char **argv) {
     int rank = mpi_get_rank();
     int size = mpi_get_size();
 
-    if (argc < 2 || argc > 3) {
+    if (argc < 2 || argc > 4) {
         if (rank == 0) {
-            printf("Usage: mpirun -np <P> ./mpi_correctness_test <algorithm> [mpi|hybrid]\n");
-            printf("Algorithms: naive | strassen | proposed\n");
+            printf("Usage: mpirun -np <P> ./mpi_correctness_test <algorithm> [mpi|hybrid] [strategy]\n");
+            printf("Algorithms: naive | strassen | winograd | proposed | oblivious\n");
             printf("Mode (optional, default mpi): mpi | hybrid\n");
+            printf("Strategy (optional, default MM_MPI_STRATEGY or rows): rows | summa | cannon | 2.5d | pipeline\n");
         }
         mpi_finalize();
         return 1;
     }
 
     char *algorithm = argv[1];
-    const char *mode = (argc == 3) ? argv[2] : "mpi";
+    const char *mode = (argc >= 3) ? argv[2] : "mpi";
+    mm_mpi_strategy strategy = mpi_strategy_default();
+    if (argc == 4) {
+        int parsed = mpi_strategy_parse(argv[3]);
+        if (parsed < 0) {
+            if (rank == 0) fprintf(stderr, "Unknown strategy: %s\n", argv[3]);
+            mpi_finalize();
+            return 1;
+        }
+        strategy = (mm_mpi_strategy)parsed;
+    }
     int hybrid = 0;
 
     if (strcmp(mode, "mpi") == 0) {
@@ -56,8 +68,12 @@ int main(int argc, char **argv) {
         kernel = hybrid ? matmul_omp : matmul_serial;
     } else if (strcmp(algorithm, "strassen") == 0) {
         kernel = hybrid ? strassen_omp : strassen_serial;
+    } else if (strcmp(algorithm, "winograd") == 0) {
+        kernel = hybrid ? winograd_omp : winograd_serial;
     } else if (strcmp(algorithm, "proposed") == 0) {
         kernel = hybrid ? proposed_omp : proposed_serial;
+    } else if (strcmp(algorithm, "oblivious") == 0) {
+        kernel = hybrid ? oblivious_omp : oblivious_serial;
     }
     else {
         if (rank == 0) fprintf(stderr, "Unknown algorithm: %s\n", algorithm);
@@ -87,23 +103,131 @@ int main(int argc, char **argv) {
         B = matrix_allocate(test_size);
     }
 
+    // MPI_TEST_EPILOGUE=<op> runs the fused-epilogue variant instead: alpha
+    // 2, beta 0.5 on a preset C, row and column bias, then the named op.
+    const char *epilogue_name = getenv("MPI_TEST_EPILOGUE");
+    int epilogue_op = -1;
+    if (epilogue_name && *epilogue_name) {
+        epilogue_op = mm_epilogue_op_parse(epilogue_name);
+        if (epilogue_op < 0 || strategy != MM_MPI_ROWS) {
+            if (rank == 0) {
+                fprintf(stderr, epilogue_op < 0 ? "Unknown epilogue: %s\n"
+                                                : "Epilogue %s needs the rows strategy\n",
+                        epilogue_name);
+            }
+            mpi_finalize();
+            return 1;
+        }
+    }
+    mm_epilogue ep = MM_EPILOGUE_INIT;
+    double *row_bias = NULL;
+    double *col_bias = NULL;
+    double *C0 = NULL;
+    if (epilogue_op >= 0 && rank == 0) {
+        row_bias = (double *)malloc((size_t)test_size * sizeof(double));
+        col_bias = (double *)malloc((size_t)test_size * sizeof(double));
+        C0 = matrix_allocate(test_size);
+        for (int i = 0; i < test_size; i++) {
+            row_bias[i] = -0.5 * test_size + (double)(i % 3);
+            col_bias[i] = 0.1 * (i % 4) - 0.15;
+        }
+        for (size_t i = 0; i < (size_t)test_size * test_size; i++) {
+            C[i] = (double)((int)(i % 7) - 3);
+            C0[i] = C[i];
+        }
+        ep.alpha = 2.0;
+        ep.beta = 0.5;
+        ep.row_bias = row_bias;
+        ep.col_bias = col_bias;
+        ep.op = (mm_epilogue_op)epilogue_op;
+        ep.lo = -1.0;
+        ep.hi = 1.0;
+    }
+
+    // MPI_TEST_CHAIN=1 runs a chain on distributed handles instead: C = A * B
+    // on a 2D grid, a round trip through block rows, then C = (A * B) * A,
+    // with only A and B scattered and the final C gathered
+    int chain = get_env_int("MPI_TEST_CHAIN", 0);
+    int chain_failed = 0;
+    if (chain && epilogue_op >= 0) {
+        if (rank == 0) fprintf(stderr, "MPI_TEST_CHAIN and MPI_TEST_EPILOGUE are exclusive\n");
+        mpi_finalize();
+        return 1;
+    }
+
     MPI_Barrier(MPI_COMM_WORLD);
 
     // Perform distributed multiplication
-    mpi_matmul_master_worker(A, B, C, test_size, kernel);
+    if (epilogue_op >= 0) {
+        mpi_matmul_master_worker_epilogue(A, B, C, test_size, kernel, &ep);
+    } else if (chain) {
+        int pr, pc;
+        mm_proc_grid_dims(size, &pr, &pc);
+        mm_proc_grid grid, row_grid;
+        mm_proc_grid_create(MPI_COMM_WORLD, pr, pc, &grid);
+        mm_proc_grid_create(MPI_COMM_WORLD, size, 1, &row_grid);
+
+        mm_dist_matrix dA, dB, dAB, dRows;
+        mm_dist_create(&grid, test_size, &dA);
+        mm_dist_create(&grid, test_size, &dB);
+        mm_dist_create(&grid, test_size, &dAB);
+        mm_dist_create(&row_grid, test_size, &dRows);
+        mm_dist_scatter(&dA, A);
+        mm_dist_scatter(&dB, B);
+
+        int status = mm_dist_multiply(kernel, &dA, &dB, &dAB);
+        if (status == 0) status = mm_dist_redistribute(&dAB, &dRows);
+        if (status == 0) status = mm_dist_redistribute(&dRows, &dB);
+        if (status == 0) status = mm_dist_multiply(kernel, &dB, &dA, &dAB);
+        if (status == 0) {
+            mm_dist_gather(&dAB, C);
+        } else if (rank == 0) {
+            fprintf(stderr, "Distributed chain: a handle operation returned %d\n", status);
+            chain_failed = 1;
+        }
+
+        mm_dist_free(&dA);
+        mm_dist_free(&dB);
+        mm_dist_free(&dAB);
+        mm_dist_free(&dRows);
+        mm_proc_grid_free(&row_grid);
+        mm_proc_grid_free(&grid);
+    } else {
+        mpi_matmul(strategy, A, B, C, test_size, kernel);
+    }
 
     // Only rank 0 evaluates correctness
+    int ok = 1;
     if (rank == 0) {
         double *reference = matrix_allocate(test_size);
         matrix_zero_init(reference, test_size);
 
         matmul_serial(A, B, reference, test_size);
+        double tol = TOL;
+        if (chain) {
+            double *AB = matrix_allocate(test_size);
+            memcpy(AB, reference, (size_t)test_size * test_size * sizeof(double));
+            matmul_serial(AB, A, reference, test_size);
+            matrix_free(AB);
+            // Entries of the second product are about n times larger
+            tol = TOL * test_size;
+        }
+        if (epilogue_op >= 0) {
+            mm_epilogue_apply(&ep, test_size, test_size, 0, 0, reference, test_size, C0, test_size);
+            memcpy(reference, C0, (size_t)test_size * test_size * sizeof(double));
+        }
 
-        int ok = matrix_compare(C, reference, test_size, TOL);
+        ok = !chain_failed && matrix_compare(C, reference, test_size, tol);
 
-        printf("\n=== MPI Correctness Test (%s, %s mode) ===\n", algorithm,
-               hybrid ? "hybrid" : "mpi");
+        printf("\n=== MPI Correctness Test (%s, %s mode, %s) ===\n", algorithm,
+               hybrid ? "hybrid" : "mpi", mpi_strategy_name(strategy));
         printf("Processes: %d\n", size);
+        if (epilogue_op >= 0) {
+            printf("Epilogue: %s (alpha 2, beta 0.5, row/col bias)\n", epilogue_name);
+        }
+        if (chain) {
+            printf("Chain: (A * B) * A on distributed handles (2D grid, block-row round trip)\n");
+        }
 
         if (ok) {
             printf("Result: PASSED ✓\n");
@@ -114,6 +238,9 @@ int main(int argc, char **argv) {
         }
 
         matrix_free(reference);
+        matrix_free(C0);
+        free(row_bias);
+        free(col_bias);
     }
 
     if (rank == 0) {
@@ -122,6 +249,8 @@ int main(int argc, char **argv) {
     }
     matrix_free(B);
 
+    // Every rank exits with the verdict so mpirun (and the suites) see it
+    MPI_Bcast(&ok, 1, MPI_INT, 0, MPI_COMM_WORLD);
     mpi_finalize();
-    return 0;
+    return ok ? 0 : 1;
 }
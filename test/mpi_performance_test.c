@@ -3,8 +3,11 @@
 
 #include "../src/kernels.h"
 #include "../src/logging.h"
+#include "../src/mpi_grid.h"
 #include "../src/mpi_wrapper.h"
 #include "../src/omp_kernels.h"
+#include "../src/simd_kernels.h"
+#include "../src/tile_sched.h"
 #include "../src/utility.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -115,12 +118,21 @@ static int *parse_sizes(const char *primary_env, const char *fallback_env, int *
     return sizes;
 }
 
-static void print_result_line(const experiment_record *rec) {
-    printf("algo=%-8s approach=%-6s n=%5d nprocs=%2d nthreads=%2d "
+// Tile scheduler balance inside the ranks (hybrid runs of the packed
+// engine): the worst busy_max / busy_mean over ranks and the total steals.
+typedef struct {
+    double imbalance;
+    long tiles;
+    long steals;
+} sched_summary;
+
+static void print_result_line(const experiment_record *rec, const sched_summary *sched) {
+    printf("algo=%-8s approach=%-6s strategy=%-8s n=%5d nprocs=%2d nthreads=%2d "
            "time_med=%8.4fs (min=%8.4fs mean=%8.4fs max=%8.4fs) "
            "gemm_eq_GF/s=%8.2f",
            rec->algo,
            rec->approach,
+           rec->strategy,
            rec->n,
            rec->nprocs,
            rec->nthreads,
@@ -132,7 +144,10 @@ static void print_result_line(const experiment_record *rec) {
     if (rec->speedup_vs_naive > 0.0) {
         printf(" speedup=%.2fx", rec->speedup_vs_naive);
     }
-    printf(" passed=%s\n", rec->passed ? "true" : "false");
+    if (sched->tiles > 0) {
+        printf(" busy_imbalance=%.2f steals=%ld", sched->imbalance, sched->steals);
+    }
+    printf(" faults=%ld passed=%s\n", rec->page_faults, rec->passed ? "true" : "false");
 }
 
 int main(int argc, char **argv) {
@@ -140,11 +155,12 @@ int main(int argc, char **argv) {
     int rank = mpi_get_rank();
     int world_size = mpi_get_size();
 
-    if (argc != 3) {
+    if (argc != 3 && argc != 4) {
         if (rank == 0) {
-            printf("Usage: mpirun -np <P> ./mpi_performance_test <algorithm> <mode>\n");
-            printf("Algorithms: naive | strassen | proposed\n");
+            printf("Usage: mpirun -np <P> ./mpi_performance_test <algorithm> <mode> [strategy]\n");
+            printf("Algorithms: naive | strassen | winograd | proposed | oblivious\n");
             printf("Mode: mpi | hybrid\n");
+            printf("Strategy (optional, default MM_MPI_STRATEGY or rows): rows | summa | cannon | 2.5d | pipeline\n");
         }
         mpi_finalize();
         return 1;
@@ -153,15 +169,29 @@ int main(int argc, char **argv) {
     const char *algorithm = argv[1];
     const char *mode = argv[2];
     kernel_func_t kernel = NULL;
+    mm_mpi_strategy strategy = mpi_strategy_default();
+    if (argc == 4) {
+        int parsed = mpi_strategy_parse(argv[3]);
+        if (parsed < 0) {
+            if (rank == 0) fprintf(stderr, "Unknown strategy: %s\n", argv[3]);
+            mpi_finalize();
+            return 1;
+        }
+        strategy = (mm_mpi_strategy)parsed;
+    }
 
     if (strcmp(mode, "mpi") == 0) {
         if      (strcmp(algorithm, "naive") == 0)    kernel = matmul_serial;
         else if (strcmp(algorithm, "strassen") == 0) kernel = strassen_serial;
+        else if (strcmp(algorithm, "winograd") == 0) kernel = winograd_serial;
         else if (strcmp(algorithm, "proposed") == 0) kernel = proposed_serial;
+        else if (strcmp(algorithm, "oblivious") == 0) kernel = oblivious_serial;
     } else if (strcmp(mode, "hybrid") == 0) {
         if      (strcmp(algorithm, "naive") == 0)    kernel = matmul_omp;
         else if (strcmp(algorithm, "strassen") == 0) kernel = strassen_omp;
+        else if (strcmp(algorithm, "winograd") == 0) kernel = winograd_omp;
         else if (strcmp(algorithm, "proposed") == 0) kernel = proposed_omp;
+        else if (strcmp(algorithm, "oblivious") == 0) kernel = oblivious_omp;
     }
 
     if (!kernel) {
@@ -188,7 +218,8 @@ int main(int argc, char **argv) {
     }
 
     if (rank == 0) {
-        printf("=== MPI Performance Benchmark (%s, %s) ===\n", algorithm, mode);
+        printf("=== MPI Performance Benchmark (%s, %s, %s) ===\n", algorithm, mode,
+               mpi_strategy_name(strategy));
         printf("Processes: %d\n\n", world_size);
     }
 
@@ -245,7 +276,7 @@ int main(int argc, char **argv) {
         for (int w = 0; w < warmup_runs; ++w) {
             if (rank == 0) matrix_zero_init(C, n);
             MPI_Barrier(MPI_COMM_WORLD);
-            mpi_matmul_master_worker(A, B, C, n, kernel);
+            mpi_matmul(strategy, A, B, C, n, kernel);
         }
 
         double *times = NULL;
@@ -256,19 +287,47 @@ int main(int argc, char **argv) {
             }
         }
 
+        mm_sched_stats_reset();
+        mm_grid_phase_stats_reset();
+        long faults_before = mm_page_faults();
         for (int run = 0; run < repetitions; ++run) {
             if (rank == 0) {
                 matrix_zero_init(C, n);
             }
             MPI_Barrier(MPI_COMM_WORLD);
             double start = MPI_Wtime();
-            mpi_matmul_master_worker(A, B, C, n, kernel);
+            mpi_matmul(strategy, A, B, C, n, kernel);
             double end = MPI_Wtime();
             if (rank == 0 && times) {
                 times[run] = end - start;
             }
         }
 
+        mm_sched_stats local_sched;
+        mm_sched_stats_get(&local_sched);
+        double local_imbalance = local_sched.busy_mean > 0.0
+                                     ? local_sched.busy_max / local_sched.busy_mean : 0.0;
+        // Page faults per timed run, summed over ranks
+        long local_counts[3] = {local_sched.tiles, local_sched.steals,
+                                repetitions > 0 ? (mm_page_faults() - faults_before) / repetitions : 0};
+        long counts[3] = {0, 0, 0};
+        sched_summary sched = {0.0, 0, 0};
+        MPI_Reduce(&local_imbalance, &sched.imbalance, 1, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        MPI_Reduce(local_counts, counts, 3, MPI_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        sched.tiles = counts[0];
+        sched.steals = counts[1];
+
+        // Grid strategies: slowest rank's time per phase, per timed run
+        mm_grid_phase_stats phases;
+        mm_grid_phase_stats_get(&phases);
+        double local_phase[7] = {phases.scatter, phases.replicate, phases.skew, phases.shift,
+                                 phases.reduce, phases.gather, phases.compute};
+        double phase_ms[7] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        MPI_Reduce(local_phase, phase_ms, 7, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+        for (int p = 0; p < 7; ++p) {
+            phase_ms[p] = repetitions > 0 ? 1e3 * phase_ms[p] / repetitions : 0.0;
+        }
+
         if (rank == 0) {
             run_stats stats = compute_stats(times, repetitions);
             free(times);
@@ -287,6 +346,12 @@ int main(int argc, char **argv) {
             mm_make_timestamp(rec.timestamp, sizeof(rec.timestamp));
             snprintf(rec.machine_id, sizeof(rec.machine_id), "%s", mm_get_machine_id());
             snprintf(rec.note, sizeof(rec.note), "%s", mm_get_results_note());
+            snprintf(rec.isa, sizeof(rec.isa), "%s", simd_isa_name());
+            snprintf(rec.dtype, sizeof(rec.dtype), "fp64");
+            snprintf(rec.placement, sizeof(rec.placement), "%s", matrix_placement_name());
+            snprintf(rec.alloc, sizeof(rec.alloc), "%s", mm_alloc_mode_name());
+            rec.page_faults = counts[2];
+            snprintf(rec.strategy, sizeof(rec.strategy), "%s", mpi_strategy_name(strategy));
             snprintf(rec.algo, sizeof(rec.algo), "%s", algorithm);
             snprintf(rec.approach, sizeof(rec.approach), "%s", mode);
             rec.n = n;
@@ -300,8 +365,30 @@ int main(int argc, char **argv) {
             rec.gflops_gemm_eq = gflops;
             rec.passed = passed;
             rec.speedup_vs_naive = speedup;
+            if (sched.tiles > 0) {
+                char extra[64];
+                snprintf(extra, sizeof(extra), "%simbalance=%.2f;steals=%ld",
+                         rec.note[0] ? ";" : "", sched.imbalance, sched.steals);
+                strncat(rec.note, extra, sizeof(rec.note) - strlen(rec.note) - 1);
+            }
 
-            print_result_line(&rec);
+            if (phases.calls > 0) {
+                char extra[160];
+                snprintf(extra, sizeof(extra),
+                         "%sc=%d;scatter_ms=%.2f;replicate_ms=%.2f;skew_ms=%.2f;shift_ms=%.2f;"
+                         "reduce_ms=%.2f;gather_ms=%.2f;compute_ms=%.2f",
+                         rec.note[0] ? ";" : "", phases.replication, phase_ms[0], phase_ms[1],
+                         phase_ms[2], phase_ms[3], phase_ms[4], phase_ms[5], phase_ms[6]);
+                strncat(rec.note, extra, sizeof(rec.note) - strlen(rec.note) - 1);
+            }
+
+            print_result_line(&rec, &sched);
+            if (phases.calls > 0) {
+                printf("    c=%d phase_ms: scatter=%.2f replicate=%.2f skew=%.2f shift=%.2f "
+                       "reduce=%.2f gather=%.2f compute=%.2f\n",
+                       phases.replication, phase_ms[0], phase_ms[1], phase_ms[2], phase_ms[3],
+                       phase_ms[4], phase_ms[5], phase_ms[6]);
+            }
             experiment_logger_write(logger_ptr, &rec);
 
             matrix_free(A);
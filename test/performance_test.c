@@ -1,9 +1,13 @@
 // performance_test.c
 // Benchmark serial/OpenMP kernels with unified logging, warmups, and repetitions.
 
+#include "../src/context.h"
 #include "../src/kernels.h"
+#include "../src/kernels_f32.h"
 #include "../src/logging.h"
 #include "../src/omp_kernels.h"
+#include "../src/simd_kernels.h"
+#include "../src/tile_sched.h"
 #include "../src/utility.h"
 #include <stdio.h>
 #include <stdlib.h>
@@ -16,14 +20,29 @@
 #define DEFAULT_PERF_RUNS 5
 #define DEFAULT_WARMUP_RUNS 1
 #define DEFAULT_TOLERANCE 1e-6
+#define DEFAULT_F32_TOLERANCE 1e-4
+#define DEFAULT_BATCH_COUNT 1000
 
+// Entries run either fn (fp64 operands) or fn_f32 (fp32 storage: "fp32" and
+// "mixed"); dtype is logged so precisions can be compared side by side.
 typedef struct {
     const char *name;
     const char *algo;
     const char *approach;
+    const char *dtype;
     void (*fn)(double*, double*, double*, int);
+    void (*fn_f32)(float*, float*, float*, int);
 } kernel_entry;
 
+// fp32 copies of the benchmark operands; the reference is the fp64 product
+// of the rounded operands, so only the kernel's own error is measured.
+typedef struct {
+    float *A;
+    float *B;
+    float *C;
+    double *baseline;
+} f32_operands;
+
 typedef struct {
     double median;
     double min;
@@ -163,6 +182,13 @@ static void maybe_force_blas_threads(void) {
     applied = 1;
 }
 
+static void append_note(experiment_record *rec, const char *extra) {
+    if (rec->note[0] != '\0') {
+        strncat(rec->note, ";", sizeof(rec->note) - strlen(rec->note) - 1);
+    }
+    strncat(rec->note, extra, sizeof(rec->note) - strlen(rec->note) - 1);
+}
+
 static void append_blas_note(experiment_record *rec) {
     const char *backend = matmul_blas_backend();
     if (!backend || !*backend) {
@@ -170,16 +196,96 @@ static void append_blas_note(experiment_record *rec) {
     }
     char extra[64];
     snprintf(extra, sizeof(extra), "blas=%s", backend);
-    if (rec->note[0] != '\0') {
-        strncat(rec->note, ";", sizeof(rec->note) - strlen(rec->note) - 1);
+    append_note(rec, extra);
+}
+
+// *_ctx entries run through one long-lived mm_context, so repetitions after
+// the warmup reuse its scratch (logged with note "ctx").
+static mm_context *bench_ctx = NULL;
+
+static void bench_ctx_gemm(mm_gemm_engine engine, double *A, double *B, double *C, int n) {
+    if (!bench_ctx) {
+        bench_ctx = mm_context_create(0);
+    }
+    mm_context_gemm(bench_ctx, engine, A, B, C, n);
+}
+
+static void proposed_ctx(double *A, double *B, double *C, int n) {
+    bench_ctx_gemm(MM_GEMM_PROPOSED, A, B, C, n);
+}
+
+static void strassen_ctx(double *A, double *B, double *C, int n) {
+    bench_ctx_gemm(MM_GEMM_STRASSEN, A, B, C, n);
+}
+
+// *_relu entries time a ReLU + column-bias epilogue fused into the packed
+// engine; *_relu_pass runs the plain multiply and the same epilogue as a
+// second sweep over C. The bias is zero and the test products are positive,
+// so both still match the plain baseline (logged with note "epilogue=...").
+static void bench_relu(int fused, double *A, double *B, double *C, int n) {
+    double *col_bias = (double *)calloc((size_t)n, sizeof(double));
+    if (!col_bias) {
+        proposed_omp(A, B, C, n);
+        return;
+    }
+    mm_epilogue ep = MM_EPILOGUE_INIT;
+    ep.col_bias = col_bias;
+    ep.op = MM_EPILOGUE_RELU;
+    if (fused) {
+        proposed_omp_epilogue(A, B, C, n, &ep);
+    } else {
+        proposed_omp(A, B, C, n);
+        #pragma omp parallel for schedule(static)
+        for (int i = 0; i < n; i++) {
+            mm_epilogue_apply(&ep, 1, n, i, 0, &C[(size_t)i * n], n, &C[(size_t)i * n], n);
+        }
+    }
+    free(col_bias);
+}
+
+static void proposed_omp_relu(double *A, double *B, double *C, int n) {
+    bench_relu(1, A, B, C, n);
+}
+
+static void proposed_omp_relu_pass(double *A, double *B, double *C, int n) {
+    bench_relu(0, A, B, C, n);
+}
+
+// Round A/B to fp32 and compute the fp64 reference of the rounded operands.
+static int prepare_f32_operands(f32_operands *f32, double *A, double *B, int n) {
+    double *A_rounded = matrix_allocate(n);
+    double *B_rounded = matrix_allocate(n);
+    if (!A_rounded || !B_rounded) {
+        matrix_free(A_rounded);
+        matrix_free(B_rounded);
+        return -1;
+    }
+    matrix_to_f32(A, f32->A, n);
+    matrix_to_f32(B, f32->B, n);
+    matrix_from_f32(f32->A, A_rounded, n);
+    matrix_from_f32(f32->B, B_rounded, n);
+    matmul_serial(A_rounded, B_rounded, f32->baseline, n);
+    matrix_free(A_rounded);
+    matrix_free(B_rounded);
+    return 0;
+}
+
+static void run_kernel(const kernel_entry *entry, double *A, double *B, double *C,
+                       const f32_operands *f32, int n) {
+    if (entry->fn_f32) {
+        entry->fn_f32(f32->A, f32->B, f32->C, n);
+    } else {
+        entry->fn(A, B, C, n);
     }
-    strncat(rec->note, extra, sizeof(rec->note) - strlen(rec->note) - 1);
 }
 
 static run_stats measure_kernel(const kernel_entry *entry,
-                                double *A, double *B, double *C, int n,
-                                int repetitions, int warmup_runs) {
+                                double *A, double *B, double *C,
+                                const f32_operands *f32, int n,
+                                int repetitions, int warmup_runs,
+                                long *page_faults) {
     run_stats stats = {0.0, 0.0, 0.0, 0.0};
+    *page_faults = 0;
     if (repetitions <= 0) repetitions = 1;
     if (warmup_runs < 0) warmup_runs = 0;
 
@@ -195,28 +301,47 @@ static run_stats measure_kernel(const kernel_entry *entry,
 
     for (int w = 0; w < warmup_runs; ++w) {
         matrix_zero_init(C, n);
-        entry->fn(A, B, C, n);
+        run_kernel(entry, A, B, C, f32, n);
     }
 
+    // Scheduler and page-fault counters cover the timed runs only
+    mm_sched_stats_reset();
+    long faults_before = mm_page_faults();
     for (int run = 0; run < repetitions; ++run) {
         matrix_zero_init(C, n);
         double start = get_wtime();
-        entry->fn(A, B, C, n);
+        run_kernel(entry, A, B, C, f32, n);
         double end = get_wtime();
         times[run] = end - start;
     }
+    *page_faults = (mm_page_faults() - faults_before) / repetitions;
 
     stats = compute_stats(times, repetitions);
     free(times);
     return stats;
 }
 
-static void print_result_line(const experiment_record *rec) {
-    printf("algo=%-8s approach=%-6s n=%5d nthreads=%2d "
+// Load balance of the tile scheduler over the timed runs: busiest thread's
+// busy time over the mean (1.00 = even). Only engines that go through
+// tile_sched.h report it (sched->tiles == 0 otherwise).
+static double sched_imbalance(const mm_sched_stats *sched) {
+    return sched->busy_mean > 0.0 ? sched->busy_max / sched->busy_mean : 1.0;
+}
+
+static void append_sched_note(experiment_record *rec, const mm_sched_stats *sched) {
+    char extra[64];
+    snprintf(extra, sizeof(extra), "imbalance=%.2f;steals=%ld",
+             sched_imbalance(sched), sched->steals);
+    append_note(rec, extra);
+}
+
+static void print_result_line(const experiment_record *rec, const mm_sched_stats *sched) {
+    printf("algo=%-8s approach=%-6s dtype=%-5s n=%5d nthreads=%2d "
            "time_med=%8.4fs (min=%8.4fs mean=%8.4fs max=%8.4fs) "
            "gemm_eq_GF/s=%8.2f",
            rec->algo,
            rec->approach,
+           rec->dtype,
            rec->n,
            rec->nthreads,
            rec->time_sec,
@@ -229,16 +354,248 @@ static void print_result_line(const experiment_record *rec) {
     } else {
         printf(" speedup=--");
     }
-    printf(" passed=%s\n", rec->passed ? "true" : "false");
+    if (sched->tiles > 0) {
+        printf(" busy_imbalance=%.2f steals=%ld", sched_imbalance(sched), sched->steals);
+    }
+    printf(" faults=%ld passed=%s\n", rec->page_faults, rec->passed ? "true" : "false");
+}
+
+// ========== Batch mode (PERFORMANCE_MODE=batch) ==========
+// count independent s x s multiplies per run, for each s in
+// TEST_BATCH_SIZES; throughput is reported in matrices per second.
+
+typedef enum {
+    BATCH_LOOP = 0,   // one proposed_omp call (parallel region) per matrix
+    BATCH_POINTERS,   // mm_context_gemm_batch
+    BATCH_STRIDED     // mm_context_gemm_batch_strided
+} batch_api;
+
+typedef struct {
+    const char *name;
+    const char *algo;
+    mm_gemm_engine engine;
+    batch_api api;
+} batch_entry;
+
+static const char *batch_api_name(batch_api api) {
+    switch (api) {
+        case BATCH_POINTERS: return "pointers";
+        case BATCH_STRIDED:  return "strided";
+        default:             return "loop";
+    }
+}
+
+// Operands of one batch: matrix j of each array starts at j * s * s.
+typedef struct {
+    int s;
+    int count;
+    double *A;
+    double *B;
+    double *C;
+    double *baseline;
+    const double **A_array;
+    const double **B_array;
+    double **C_array;
+} batch_operands;
+
+static void free_batch_operands(batch_operands *ops) {
+    free(ops->A);
+    free(ops->B);
+    free(ops->C);
+    free(ops->baseline);
+    free(ops->A_array);
+    free(ops->B_array);
+    free(ops->C_array);
+}
+
+static int prepare_batch_operands(batch_operands *ops, int s, int count) {
+    size_t elems = (size_t)count * s * s;
+    memset(ops, 0, sizeof(*ops));
+    ops->s = s;
+    ops->count = count;
+    ops->A = (double *)malloc(elems * sizeof(double));
+    ops->B = (double *)malloc(elems * sizeof(double));
+    ops->C = (double *)malloc(elems * sizeof(double));
+    ops->baseline = (double *)malloc(elems * sizeof(double));
+    ops->A_array = (const double **)malloc((size_t)count * sizeof(double *));
+    ops->B_array = (const double **)malloc((size_t)count * sizeof(double *));
+    ops->C_array = (double **)malloc((size_t)count * sizeof(double *));
+    if (!ops->A || !ops->B || !ops->C || !ops->baseline ||
+        !ops->A_array || !ops->B_array || !ops->C_array) {
+        free_batch_operands(ops);
+        return -1;
+    }
+
+    srand(42);
+    for (size_t i = 0; i < elems; i++) ops->A[i] = (double)rand() / RAND_MAX;
+    srand(123);
+    for (size_t i = 0; i < elems; i++) ops->B[i] = (double)rand() / RAND_MAX;
+    size_t stride = (size_t)s * s;
+    for (int j = 0; j < count; j++) {
+        ops->A_array[j] = ops->A + j * stride;
+        ops->B_array[j] = ops->B + j * stride;
+        ops->C_array[j] = ops->C + j * stride;
+        matrix_mul_strided(s, s, s, ops->A_array[j], s, ops->B_array[j], s,
+                           ops->baseline + j * stride, s, 0);
+    }
+    return 0;
+}
+
+static void run_batch_entry(const batch_entry *entry, batch_operands *ops) {
+    int s = ops->s;
+    size_t stride = (size_t)s * s;
+    switch (entry->api) {
+        case BATCH_POINTERS:
+            mm_context_gemm_batch(bench_ctx, entry->engine, s, s, s,
+                                  ops->A_array, s, ops->B_array, s, ops->C_array, s,
+                                  ops->count);
+            break;
+        case BATCH_STRIDED:
+            mm_context_gemm_batch_strided(bench_ctx, entry->engine, s, s, s,
+                                          ops->A, s, stride, ops->B, s, stride,
+                                          ops->C, s, stride, ops->count);
+            break;
+        default:
+            for (int j = 0; j < ops->count; j++) {
+                proposed_omp(ops->A + j * stride, ops->B + j * stride, ops->C + j * stride, s);
+            }
+            break;
+    }
+}
+
+static run_stats measure_batch_entry(const batch_entry *entry, batch_operands *ops,
+                                     int repetitions, int warmup_runs,
+                                     long *page_faults) {
+    run_stats stats = {0.0, 0.0, 0.0, 0.0};
+    *page_faults = 0;
+    if (repetitions <= 0) repetitions = 1;
+    if (warmup_runs < 0) warmup_runs = 0;
+    double *times = (double *)malloc((size_t)repetitions * sizeof(double));
+    if (!times) {
+        return stats;
+    }
+    size_t bytes = (size_t)ops->count * ops->s * ops->s * sizeof(double);
+    for (int w = 0; w < warmup_runs; ++w) {
+        run_batch_entry(entry, ops);
+    }
+    long faults_before = mm_page_faults();
+    for (int run = 0; run < repetitions; ++run) {
+        memset(ops->C, 0, bytes);
+        double start = get_wtime();
+        run_batch_entry(entry, ops);
+        times[run] = get_wtime() - start;
+    }
+    *page_faults = (mm_page_faults() - faults_before) / repetitions;
+    stats = compute_stats(times, repetitions);
+    free(times);
+    return stats;
+}
+
+static void run_batch_benchmark(const int *sizes, int num_sizes,
+                                const int *thread_values, int thread_count,
+                                experiment_logger *logger, int repetitions,
+                                int warmup_runs, double tolerance) {
+    const batch_entry entries[] = {
+        {"proposed_loop",          "proposed", MM_GEMM_PROPOSED, BATCH_LOOP},
+        {"proposed_batch",         "proposed", MM_GEMM_PROPOSED, BATCH_POINTERS},
+        {"proposed_batch_strided", "proposed", MM_GEMM_PROPOSED, BATCH_STRIDED},
+        {"matmul_batch_strided",   "naive",    MM_GEMM_NAIVE,    BATCH_STRIDED}
+    };
+    const size_t entry_count = sizeof(entries) / sizeof(entries[0]);
+    const char *entry_list = getenv("BATCH_KERNELS");
+    int count = get_env_int("TEST_BATCH_COUNT", DEFAULT_BATCH_COUNT);
+
+    if (!bench_ctx) {
+        bench_ctx = mm_context_create(0);
+    }
+
+    for (int i = 0; i < num_sizes; i++) {
+        int s = sizes[i];
+        printf("Batch: %d matrices of %dx%d\n", count, s, s);
+        batch_operands ops;
+        if (prepare_batch_operands(&ops, s, count) != 0) {
+            fprintf(stderr, "Error: Failed to allocate batch operands for s=%d\n", s);
+            continue;
+        }
+
+        for (size_t e = 0; e < entry_count; e++) {
+            if (!kernel_enabled(entry_list, entries[e].name)) {
+                continue;
+            }
+            for (int t_idx = 0; t_idx < thread_count; ++t_idx) {
+                int current_threads = thread_values[t_idx];
+                if (current_threads <= 0) continue;
+#ifdef _OPENMP
+                omp_set_num_threads(current_threads);
+                matrix_pin_threads();
+#endif
+                long page_faults = 0;
+                run_stats stats = measure_batch_entry(&entries[e], &ops, repetitions, warmup_runs,
+                                                      &page_faults);
+
+                int passed = 1;
+                for (int j = 0; j < count && passed; j++) {
+                    passed = matrix_compare(ops.C_array[j], ops.baseline + (size_t)j * s * s,
+                                            s, tolerance);
+                }
+
+                double denom = (stats.median > 0.0) ? stats.median : stats.mean;
+                if (denom <= 0.0) denom = 1.0;
+                double per_sec = count / denom;
+
+                experiment_record rec;
+                memset(&rec, 0, sizeof(rec));
+                mm_make_timestamp(rec.timestamp, sizeof(rec.timestamp));
+                snprintf(rec.machine_id, sizeof(rec.machine_id), "%s", mm_get_machine_id());
+                snprintf(rec.note, sizeof(rec.note), "%s", mm_get_results_note());
+                snprintf(rec.isa, sizeof(rec.isa), "%s", simd_isa_name());
+                snprintf(rec.algo, sizeof(rec.algo), "%s", entries[e].algo);
+                snprintf(rec.approach, sizeof(rec.approach), "openmp");
+                snprintf(rec.dtype, sizeof(rec.dtype), "fp64");
+                snprintf(rec.placement, sizeof(rec.placement), "%s", matrix_placement_name());
+                snprintf(rec.alloc, sizeof(rec.alloc), "%s", mm_alloc_mode_name());
+                rec.page_faults = page_faults;
+                rec.n = s;
+                rec.nprocs = 1;
+                rec.nthreads = current_threads;
+                rec.repetitions = repetitions;
+                rec.time_sec = stats.median;
+                rec.time_min = stats.min;
+                rec.time_max = stats.max;
+                rec.time_mean = stats.mean;
+                rec.gflops_gemm_eq = 2.0 * s * (double)s * (double)s * count / (denom * 1e9);
+                rec.passed = passed;
+
+                char extra[96];
+                snprintf(extra, sizeof(extra), "batch=%d;api=%s;matrices_per_sec=%.0f",
+                         count, batch_api_name(entries[e].api), per_sec);
+                append_note(&rec, extra);
+
+                printf("batch=%-22s n=%4d count=%d nthreads=%2d time_med=%8.4fs "
+                       "matrices/s=%12.0f gemm_eq_GF/s=%8.2f passed=%s\n",
+                       entries[e].name, s, count, current_threads, stats.median,
+                       per_sec, rec.gflops_gemm_eq, passed ? "true" : "false");
+                experiment_logger_write(logger, &rec);
+            }
+        }
+        printf("\n");
+        free_batch_operands(&ops);
+    }
 }
 
 int main() {
     printf("=== Matrix Multiplication Performance Benchmark (Serial/OpenMP) ===\n\n");
+    printf("[placement] %s\n", matrix_placement_name());
+    printf("[alloc] hugepages=%s\n", mm_alloc_mode_name());
+
+    const char *mode = getenv("PERFORMANCE_MODE");
+    int batch_mode = mode && strcmp(mode, "batch") == 0;
+    const char *sizes_var = batch_mode ? "TEST_BATCH_SIZES" : "TEST_PERFORMANCE_SIZES";
 
     int num_sizes = 0;
-    int *sizes = parse_sizes("TEST_PERFORMANCE_SIZES", &num_sizes);
+    int *sizes = parse_sizes(sizes_var, &num_sizes);
     if (num_sizes == 0 || !sizes) {
-        fprintf(stderr, "Error: TEST_PERFORMANCE_SIZES is not set or invalid.\n");
+        fprintf(stderr, "Error: %s is not set or invalid.\n", sizes_var);
         free(sizes);
         return 1;
     }
@@ -246,16 +603,35 @@ int main() {
     int repetitions = get_env_int("TEST_PERFORMANCE_RUNS", DEFAULT_PERF_RUNS);
     int warmup_runs = get_env_int("WARMUP_RUNS", DEFAULT_WARMUP_RUNS);
     double tolerance = get_env_double("TEST_CORRECTNESS_TOLERANCE", DEFAULT_TOLERANCE);
+    double f32_tolerance = get_env_double("TEST_F32_TOLERANCE", DEFAULT_F32_TOLERANCE);
     const char *kernel_list = getenv("PERFORMANCE_KERNELS");
 
     const kernel_entry kernels[] = {
-        {"matmul_serial",   "naive",    "serial", matmul_serial},
-        {"matmul_omp",      "naive",    "openmp", matmul_omp},
-        {"strassen_serial", "strassen", "serial", strassen_serial},
-        {"strassen_omp",    "strassen", "openmp", strassen_omp},
-        {"proposed_serial", "proposed", "serial", proposed_serial},
-        {"proposed_omp",    "proposed", "openmp", proposed_omp},
-        {"matmul_blas",     "blas",     "serial", matmul_blas}
+        {"matmul_serial",         "naive",    "serial", "fp64",  matmul_serial,   NULL},
+        {"matmul_omp",            "naive",    "openmp", "fp64",  matmul_omp,      NULL},
+        {"strassen_serial",       "strassen", "serial", "fp64",  strassen_serial, NULL},
+        {"strassen_omp",          "strassen", "openmp", "fp64",  strassen_omp,    NULL},
+        {"winograd_serial",       "winograd", "serial", "fp64",  winograd_serial, NULL},
+        {"winograd_omp",          "winograd", "openmp", "fp64",  winograd_omp,    NULL},
+        {"proposed_serial",       "proposed", "serial", "fp64",  proposed_serial, NULL},
+        {"proposed_omp",          "proposed", "openmp", "fp64",  proposed_omp,    NULL},
+        {"oblivious_serial",      "oblivious", "serial", "fp64", oblivious_serial, NULL},
+        {"oblivious_omp",         "oblivious", "openmp", "fp64", oblivious_omp,   NULL},
+        {"strassen_ctx",          "strassen", "openmp", "fp64",  strassen_ctx,    NULL},
+        {"proposed_ctx",          "proposed", "openmp", "fp64",  proposed_ctx,    NULL},
+        {"proposed_omp_relu",     "proposed", "openmp", "fp64",  proposed_omp_relu, NULL},
+        {"proposed_omp_relu_pass", "proposed", "openmp", "fp64", proposed_omp_relu_pass, NULL},
+        {"matmul_blas",           "blas",     "serial", "fp64",  matmul_blas,     NULL},
+        {"matmul_serial_f32",     "naive",    "serial", "fp32",  NULL, matmul_serial_f32},
+        {"matmul_omp_f32",        "naive",    "openmp", "fp32",  NULL, matmul_omp_f32},
+        {"strassen_serial_f32",   "strassen", "serial", "fp32",  NULL, strassen_serial_f32},
+        {"strassen_omp_f32",      "strassen", "openmp", "fp32",  NULL, strassen_omp_f32},
+        {"proposed_serial_f32",   "proposed", "serial", "fp32",  NULL, proposed_serial_f32},
+        {"proposed_omp_f32",      "proposed", "openmp", "fp32",  NULL, proposed_omp_f32},
+        {"matmul_serial_mixed",   "naive",    "serial", "mixed", NULL, matmul_serial_mixed},
+        {"matmul_omp_mixed",      "naive",    "openmp", "mixed", NULL, matmul_omp_mixed},
+        {"proposed_serial_mixed", "proposed", "serial", "mixed", NULL, proposed_serial_mixed},
+        {"proposed_omp_mixed",    "proposed", "openmp", "mixed", NULL, proposed_omp_mixed}
     };
     const size_t kernel_count = sizeof(kernels) / sizeof(kernels[0]);
 
@@ -277,7 +653,12 @@ int main() {
 
     int blas_unavailable_warned = 0;
 
-    for (int i = 0; i < num_sizes; i++) {
+    if (batch_mode) {
+        run_batch_benchmark(sizes, num_sizes, thread_list_values, thread_list_count,
+                            &logger, repetitions, warmup_runs, tolerance);
+    }
+
+    for (int i = 0; !batch_mode && i < num_sizes; i++) {
         int n = sizes[i];
         printf("Matrix size: %dx%d\n", n, n);
 
@@ -285,9 +666,15 @@ int main() {
         double *B = matrix_allocate(n);
         double *baseline = matrix_allocate(n);
         double *C = matrix_allocate(n);
-        if (!A || !B || !baseline || !C) {
+        f32_operands f32 = {
+            matrix_allocate_f32(n), matrix_allocate_f32(n), matrix_allocate_f32(n),
+            matrix_allocate(n)
+        };
+        if (!A || !B || !baseline || !C || !f32.A || !f32.B || !f32.C || !f32.baseline) {
             fprintf(stderr, "Error: Failed to allocate matrices for n=%d\n", n);
             matrix_free(A); matrix_free(B); matrix_free(baseline); matrix_free(C);
+            matrix_free_f32(f32.A); matrix_free_f32(f32.B); matrix_free_f32(f32.C);
+            matrix_free(f32.baseline);
             free(sizes);
             experiment_logger_close(&logger);
             return 1;
@@ -301,6 +688,7 @@ int main() {
         matmul_serial(A, B, baseline, n);
 
         double naive_serial_baseline = -1.0;
+        int f32_ready = 0;
 
         for (size_t k = 0; k < kernel_count; k++) {
             if (!kernel_enabled(kernel_list, kernels[k].name)) {
@@ -314,6 +702,13 @@ int main() {
                 }
                 continue;
             }
+            if (kernels[k].fn_f32 && !f32_ready) {
+                if (prepare_f32_operands(&f32, A, B, n) != 0) {
+                    fprintf(stderr, "Error: Failed to prepare fp32 operands for n=%d\n", n);
+                    continue;
+                }
+                f32_ready = 1;
+            }
 
             int pass_thread_counts = 1;
             const int *thread_values = &serial_thread_value;
@@ -332,18 +727,28 @@ int main() {
 #ifdef _OPENMP
                 if (strcmp(kernels[k].approach, "openmp") == 0) {
                     omp_set_num_threads(current_threads);
+                    matrix_pin_threads();
                 }
 #endif
 
-                run_stats stats = measure_kernel(&kernels[k], A, B, C, n, repetitions, warmup_runs);
+                long page_faults = 0;
+                run_stats stats = measure_kernel(&kernels[k], A, B, C, &f32, n,
+                                                 repetitions, warmup_runs, &page_faults);
+                mm_sched_stats sched;
+                mm_sched_stats_get(&sched);
 
                 experiment_record rec;
                 memset(&rec, 0, sizeof(rec));
                 mm_make_timestamp(rec.timestamp, sizeof(rec.timestamp));
                 snprintf(rec.machine_id, sizeof(rec.machine_id), "%s", mm_get_machine_id());
                 snprintf(rec.note, sizeof(rec.note), "%s", mm_get_results_note());
+                snprintf(rec.isa, sizeof(rec.isa), "%s", simd_isa_name());
                 snprintf(rec.algo, sizeof(rec.algo), "%s", kernels[k].algo);
                 snprintf(rec.approach, sizeof(rec.approach), "%s", kernels[k].approach);
+                snprintf(rec.dtype, sizeof(rec.dtype), "%s", kernels[k].dtype);
+                snprintf(rec.placement, sizeof(rec.placement), "%s", matrix_placement_name());
+                snprintf(rec.alloc, sizeof(rec.alloc), "%s", mm_alloc_mode_name());
+                rec.page_faults = page_faults;
                 rec.n = n;
                 rec.nprocs = 1;
                 rec.nthreads = strcmp(kernels[k].approach, "openmp") == 0 ? current_threads : 1;
@@ -358,14 +763,29 @@ int main() {
                 double ops = 2.0 * n * (double)n * (double)n;
                 rec.gflops_gemm_eq = ops / (denom * 1e9);
 
-                rec.passed = matrix_compare(C, baseline, n, tolerance);
+                if (kernels[k].fn_f32) {
+                    rec.passed = matrix_compare_f32(f32.C, f32.baseline, n, f32_tolerance);
+                } else {
+                    rec.passed = matrix_compare(C, baseline, n, tolerance);
+                }
 
                 if (strcmp(kernels[k].algo, "blas") == 0) {
                     append_blas_note(&rec);
                 }
+                if (strstr(kernels[k].name, "_ctx")) {
+                    append_note(&rec, "ctx");
+                }
+                if (strstr(kernels[k].name, "_relu")) {
+                    append_note(&rec, strstr(kernels[k].name, "_pass") ? "epilogue=relu_pass"
+                                                                      : "epilogue=relu_fused");
+                }
+                if (sched.tiles > 0) {
+                    append_sched_note(&rec, &sched);
+                }
 
                 if (strcmp(kernels[k].algo, "naive") == 0 &&
-                    strcmp(kernels[k].approach, "serial") == 0) {
+                    strcmp(kernels[k].approach, "serial") == 0 &&
+                    strcmp(kernels[k].dtype, "fp64") == 0) {
                     naive_serial_baseline = rec.time_sec;
                     rec.speedup_vs_naive = 1.0;
                 } else if (naive_serial_baseline > 0.0 && rec.time_sec > 0.0) {
@@ -374,7 +794,7 @@ int main() {
                     rec.speedup_vs_naive = 0.0;
                 }
 
-                print_result_line(&rec);
+                print_result_line(&rec, &sched);
                 experiment_logger_write(&logger, &rec);
             }
         }
@@ -384,12 +804,17 @@ int main() {
         matrix_free(B);
         matrix_free(baseline);
         matrix_free(C);
+        matrix_free_f32(f32.A);
+        matrix_free_f32(f32.B);
+        matrix_free_f32(f32.C);
+        matrix_free(f32.baseline);
     }
 
     free(sizes);
     if (thread_list_owned) {
         free(thread_list_values);
     }
+    mm_context_destroy(bench_ctx);
     experiment_logger_close(&logger);
     printf("Benchmark complete.\n");
     return 0;